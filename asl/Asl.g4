@@ -28,6 +28,24 @@
 
 grammar Asl;
 
+// The contexts of the parser tree derive from DecoratedContext, that
+// gives each node the id used to store its attributes (TreeDecoration)
+options {
+  contextSuperClass = DecoratedContext;
+}
+
+@parser::postinclude {
+#include "DecoratedContext.h"
+}
+
+// The tokens can be created by another factory than the default one
+// (an AslAtomTokenFactory, that interns their texts as they are lexed)
+@lexer::members {
+void setTokenFactory(Ref<antlr4::TokenFactory<antlr4::CommonToken>> factory) {
+  _factory = factory;
+}
+}
+
 //////////////////////////////////////////////////
 /// Parser Rules
 //////////////////////////////////////////////////
@@ -38,7 +56,7 @@ program : function+ EOF
 
 // A function has a name, a list of parameters and a list of statements
 function
-        : FUNC ID LPAREN ((param_decl',')* param_decl)? RPAREN (':' type)? declarations statements ENDFUNC
+        : FUNC ID LPAREN ((param_decl COMMA)* param_decl)? RPAREN (COLON type)? declarations statements ENDFUNC
         ;
 
 declarations
@@ -46,16 +64,16 @@ declarations
         ;
 
 param_decl
-        : ID ':' ARRAY LCLAU expr RCLAU OF type # arrayParamDecl
-        | ID ':' type                           # basicParamDecl
+        : ID COLON ARRAY LCLAU expr RCLAU OF type # arrayParamDecl
+        | ID COLON type                           # basicParamDecl
         ;
 
 variable_decl
         : VAR decl 
         ;
 
-decl    : ident (','ident)* ':' ARRAY LCLAU expr RCLAU OF type      # arrayDecl
-     	| ID (','ID)* ':' type                                      # basicDecl 
+decl    : ident (COMMA ident)* COLON ARRAY LCLAU expr RCLAU OF type   # arrayDecl
+     	| ID (COMMA ID)* COLON type                                   # basicDecl 
         ;
 
 //Tipos básicos
@@ -70,27 +88,27 @@ statements
         ;
 
 functioncall
-        : ident LPAREN((expr',')*expr)?RPAREN # procCall
+        : ident LPAREN((expr COMMA)*expr)?RPAREN # procCall
         ;
 
 // The different types of instructions
 statement
           // Assignment
-        : left_expr ASSIGN expr ';'                             # assignStmt
+        : left_expr ASSIGN expr SEMI                            # assignStmt
           // if-then-else statement (else is optional)
         | IF expr THEN statements (ELSE statements)? ENDIF      # ifStmt
 
         | WHILE expr DO statements ENDWHILE   # whileStmt
           // Read a variable
-        | functioncall ';'                    # funcStmt
+        | functioncall SEMI                   # funcStmt
 
-        | READ left_expr ';'                  # readStmt
+        | READ left_expr SEMI                 # readStmt
           // Write an expression
-        | WRITE expr ';'                      # writeExpr
+        | WRITE expr SEMI                     # writeExpr
           // Write a string
-        | WRITE STRING ';'                    # writeString
+        | WRITE STRING SEMI                   # writeString
           // Return statement
-        | RETURN expr? ';'                    # returnStmt
+        | RETURN expr? SEMI                   # returnStmt
         ;
 
 array_access
@@ -137,6 +155,11 @@ ident   : ID
 /// Lexer Rules
 //////////////////////////////////////////////////
 
+// The separators go first, so that they keep the token types 1..3
+// they had as implicit literals of the parser rules
+COMMA     : ',' ;
+COLON     : ':' ;
+SEMI      : ';' ;
 TRUE      : 'true';
 FALSE     : 'false';
 LPAREN    : '(';
@@ -0,0 +1,123 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslAst - Abstract syntax tree of an Asl program, built by the
+//             AslRecursiveParser
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslAst.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+#include <new>        // placement new
+#include <cassert>
+
+// using namespace std;
+
+
+// Constructor
+AslAst::AslAst(const char *source, atomTable & Atoms) :
+  root{nullptr},
+  source{source},
+  Atoms(Atoms) {
+}
+
+void AslAst::addToken(const AslFastLexer::rawToken & token) {
+  tokens.push_back(token);
+  switch (token.type) {
+  case AslLexer::ID:
+  case AslLexer::INTVAL:
+  case AslLexer::FLOATVAL:
+  case AslLexer::CHARS:
+  case AslLexer::STRING:
+    atoms.push_back(Atoms.intern(source + token.start, token.stop + 1 - token.start));
+    break;
+  default:
+    atoms.push_back(atomTable::EMPTY);
+    break;
+  }
+}
+
+AstNode * AslAst::newNode(AstKind kind, std::uint32_t token, std::uint32_t first,
+			  AstNode * const * children, std::size_t count) {
+  AstNode *node = new (nodes.allocate(sizeof(AstNode), alignof(AstNode))) AstNode;
+  node->kind = kind;
+  node->isLValue = false;
+  node->token = token;
+  node->first = first;
+  node->aux = AstNode::NONE;
+  node->count = count;
+  node->child = nullptr;
+  if (count > 0) {
+    node->child = static_cast<AstNode **>(nodes.allocate(count*sizeof(AstNode *), alignof(AstNode *)));
+    for (std::size_t i = 0; i < count; ++i) node->child[i] = children[i];
+  }
+  node->type = TypesMgr::TypeId();
+  node->scope = SymTable::ScopeId();
+  node->symbol = SymTable::SymbolHandle();
+  return node;
+}
+
+std::size_t AslAst::type(std::uint32_t token) const {
+  return tokens[token].type;
+}
+
+std::string AslAst::text(std::uint32_t token) const {
+  const AslFastLexer::rawToken & t = tokens[token];
+  return std::string(source + t.start, t.stop + 1 - t.start);
+}
+
+atomTable::atom AslAst::atom(std::uint32_t token) const {
+  assert(atoms[token] != atomTable::EMPTY);
+  return atoms[token];
+}
+
+const std::string & AslAst::atomText(std::uint32_t token) const {
+  return Atoms.text(atom(token));
+}
+
+std::size_t AslAst::line(std::uint32_t token) const {
+  return tokens[token].line;
+}
+
+std::size_t AslAst::column(std::uint32_t token) const {
+  return tokens[token].column;
+}
+
+std::string AslAst::text(std::uint32_t first, std::uint32_t last) const {
+  std::string s;
+  for (std::uint32_t i = first; i <= last; ++i) {
+    const AslFastLexer::rawToken & t = tokens[i];
+    s.append(source + t.start, t.stop + 1 - t.start);
+  }
+  return s;
+}
+
+std::string AslAst::sizeText(const AstNode * decl) const {
+  assert(decl->kind == AstKind::ArrayDecl or decl->kind == AstKind::ArrayParamDecl);
+  // the size is the last child, followed by the tokens ']' OF type
+  return text(decl->child[decl->count - 1]->first, decl->aux - 3);
+}
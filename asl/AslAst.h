@@ -0,0 +1,178 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslAst - Abstract syntax tree of an Asl program, built by the
+//             AslRecursiveParser
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AslFastLexer.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/arena.h"
+#include "../common/atoms.h"
+
+#include <string>
+#include <vector>
+
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uint32_t
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Kinds of the nodes of the AST: the rules and the labeled
+// alternatives of Asl.g4 (variable_decl, type and functioncall are
+// folded into their parents). The token of a node (see AstNode) and
+// its children are:
+//   Program            EOF                   functions
+//   Function           ID (aux: return type) params, Declarations, Statements
+//   ArrayParamDecl     ID (aux: type)        size expr
+//   BasicParamDecl     ID (aux: type)        -
+//   Declarations       -                     ArrayDecl/BasicDecl
+//   ArrayDecl          first ID (aux: type)  Idents, size expr
+//   BasicDecl          first ID (aux: type)  - (the IDs are every other
+//                                              token up to the ':')
+//   Statements         -                     statements
+//   AssignStmt         ASSIGN                left expr, expr
+//   IfStmt / WhileStmt IF / WHILE            expr, Statements (, Statements)
+//   FuncStmt           -                     ProcCall
+//   ReadStmt           READ                  left expr
+//   WriteExpr          WRITE                 expr
+//   WriteString        STRING                -
+//   ReturnStmt         RETURN                (expr)
+//   ProcCall           ID                    Ident, args
+//   ArrayAccess        ID                    Ident, index expr
+//   IndexArrayLeftExpr -                     ArrayAccess
+//   Identifier         -                     Ident
+//   Parenthesis        LPAREN                expr
+//   FunctionAsExpr     -                     ProcCall
+//   IndexArrayExpr     -                     ArrayAccess
+//   Unary              op                    expr
+//   Arithmetic, Relational, Boolean  op      expr, expr
+//   Integervalue, Floatvalue, Char, Booleanvalue  the literal  -
+//   ExprIdent          -                     Ident
+//   Ident              ID                    -
+
+enum class AstKind : unsigned char {
+  Program, Function, ArrayParamDecl, BasicParamDecl, Declarations,
+  ArrayDecl, BasicDecl, Statements, AssignStmt, IfStmt, WhileStmt,
+  FuncStmt, ReadStmt, WriteExpr, WriteString, ReturnStmt, ProcCall,
+  ArrayAccess, IndexArrayLeftExpr, Identifier, Parenthesis,
+  FunctionAsExpr, IndexArrayExpr, Unary, Arithmetic, Relational,
+  Boolean, Integervalue, Floatvalue, Char, Booleanvalue, ExprIdent,
+  Ident
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// Struct AstNode: a node of the AST. The tokens are referred to by
+// their index in AslAst::tokens. Besides the structure of the tree,
+// a node has the attributes that the TreeDecoration keeps for the
+// nodes of the parse tree: those not set are the error type, false,
+// scope 0 and a symbol not found, like in a TreeDecoration. (The
+// addr, offset and code are not stored: CodeGenPass returns them from
+// each node.)
+
+struct AstNode {
+  // index of no token (e.g. the aux of a function without return type)
+  static const std::uint32_t NONE = UINT32_MAX;
+
+  AstKind           kind;
+  bool              isLValue;
+  // main token of the node, first token of the node (where the
+  // errors about it are localized) and a second token (see AstKind)
+  std::uint32_t     token, first, aux;
+  // children, allocated in the same arena as the node
+  std::uint32_t     count;
+  AstNode        ** child;
+  TypesMgr::TypeId  type;
+  SymTable::ScopeId scope;
+  // the symbol an Ident refers to (set by the TypeCheckPass)
+  SymTable::SymbolHandle symbol;
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// Class AslAst: the AST of a program together with its tokens (whose
+// text is read from the source, that must outlive the AST). The nodes
+// are allocated in an arena of the AST, and freed all together with it.
+// The identifiers and literals are interned in the atom table of the
+// compilation as they are lexed, and the passes refer to them by
+// their atoms.
+
+class AslAst {
+
+public:
+
+  // Constructor (Atoms is the atom table, that must outlive it)
+  AslAst(const char *source, atomTable & Atoms);
+
+  // Root of the tree (a Program node), and all the tokens of the
+  // source (the last one is the EOF)
+  AstNode * root;
+  std::vector<AslFastLexer::rawToken> tokens;
+  // atom of each token (atomTable::EMPTY if it is not an
+  // identifier or a literal)
+  std::vector<atomTable::atom>        atoms;
+
+  // Appends a token, interning its text if it is an identifier or a literal
+  void addToken (const AslFastLexer::rawToken & token);
+
+  // Creates a node (with the given children, that are copied)
+  AstNode * newNode(AstKind kind, std::uint32_t token, std::uint32_t first,
+		    AstNode * const * children = nullptr, std::size_t count = 0);
+
+  // Accessors to the type, text and position of a token
+  std::size_t type   (std::uint32_t token) const;
+  std::string text   (std::uint32_t token) const;
+  std::size_t line   (std::uint32_t token) const;
+  std::size_t column (std::uint32_t token) const;
+
+  // Atom of an identifier or literal, and its text in the atom table
+  atomTable::atom      atom     (std::uint32_t token) const;
+  const std::string &  atomText (std::uint32_t token) const;
+
+  // Text of the tokens from first to last, with nothing in between
+  // (what getText gives for a node of the parse tree)
+  std::string text (std::uint32_t first, std::uint32_t last) const;
+
+  // Text of the size expression of an ArrayDecl or ArrayParamDecl
+  std::string sizeText (const AstNode * decl) const;
+
+private:
+
+  const char   * source;
+  atomTable    & Atoms;
+  arena          nodes;
+
+  // No copies (the nodes are owned)
+  AslAst(const AslAst &) = delete;
+  AslAst & operator=(const AslAst &) = delete;
+
+};  // class AslAst
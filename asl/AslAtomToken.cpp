@@ -0,0 +1,127 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslAtomToken - Tokens that keep the atom of their text
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslAtomToken.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+// uncomment to disable assert()
+// #define NDEBUG
+#include <cassert>
+
+// using namespace std;
+
+
+// ======================================================================
+// class AslAtomToken
+
+AslAtomToken::AslAtomToken(std::pair<antlr4::TokenSource *, antlr4::CharStream *> source,
+			   std::size_t type, std::size_t channel, std::size_t start, std::size_t stop) :
+  antlr4::CommonToken(source, type, channel, start, stop),
+  atom{atomTable::EMPTY},
+  atomText{nullptr} {
+}
+
+AslAtomToken::AslAtomToken(std::size_t type, const std::string & text) :
+  antlr4::CommonToken(type, text),
+  atom{atomTable::EMPTY},
+  atomText{nullptr} {
+}
+
+atomTable::atom AslAtomToken::getAtom() const {
+  return atom;
+}
+
+const std::string & AslAtomToken::getAtomText() const {
+  assert(atomText != nullptr);
+  return *atomText;
+}
+
+void AslAtomToken::setAtom(const atomTable & atoms, atomTable::atom a) {
+  atom = a;
+  atomText = &atoms.text(a);
+}
+
+
+// ======================================================================
+// class AslAtomTokenFactory
+
+AslAtomTokenFactory::AslAtomTokenFactory(atomTable & atoms, byteCharStream *bytes) :
+  atoms(atoms),
+  bytes{bytes ? bytes->data() : nullptr} {
+}
+
+std::unique_ptr<antlr4::CommonToken>
+AslAtomTokenFactory::create(std::pair<antlr4::TokenSource *, antlr4::CharStream *> source,
+			    std::size_t type, const std::string & text,
+			    std::size_t channel, std::size_t start, std::size_t stop,
+			    std::size_t line, std::size_t charPositionInLine) {
+  AslAtomToken *token = new AslAtomToken(source, type, channel, start, stop);
+  std::unique_ptr<antlr4::CommonToken> owner(token);
+  token->setLine(line);
+  token->setCharPositionInLine(charPositionInLine);
+  if (not text.empty()) token->setText(text);
+  if (isAtomType(type)) {
+    // the text given (e.g. of a missing token made up by the parser),
+    // or else the one in the source
+    if (not text.empty())
+      token->setAtom(atoms, atoms.intern(text));
+    else if (bytes)
+      token->setAtom(atoms, atoms.intern(bytes + start, stop + 1 - start));
+    else
+      token->setAtom(atoms, atoms.intern(source.second->getText(antlr4::misc::Interval(start, stop))));
+  }
+  return owner;
+}
+
+std::unique_ptr<antlr4::CommonToken> AslAtomTokenFactory::create(std::size_t type, const std::string & text) {
+  AslAtomToken *token = new AslAtomToken(type, text);
+  std::unique_ptr<antlr4::CommonToken> owner(token);
+  if (isAtomType(type)) token->setAtom(atoms, atoms.intern(text));
+  return owner;
+}
+
+bool AslAtomTokenFactory::isAtomType(std::size_t type) {
+  return (type == AslLexer::ID or type == AslLexer::INTVAL or type == AslLexer::FLOATVAL or
+	  type == AslLexer::CHARS or type == AslLexer::STRING);
+}
+
+
+// ======================================================================
+// atoms of the terminal nodes
+
+atomTable::atom atomOf(antlr4::tree::TerminalNode *node) {
+  assert(dynamic_cast<AslAtomToken *>(node->getSymbol()) != nullptr);
+  return static_cast<AslAtomToken *>(node->getSymbol())->getAtom();
+}
+
+const std::string & atomTextOf(antlr4::tree::TerminalNode *node) {
+  assert(dynamic_cast<AslAtomToken *>(node->getSymbol()) != nullptr);
+  return static_cast<AslAtomToken *>(node->getSymbol())->getAtomText();
+}
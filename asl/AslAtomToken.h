@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslAtomToken - Tokens that keep the atom of their text
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "antlr4-runtime.h"
+
+#include "../common/atoms.h"
+#include "../common/bytestream.h"
+
+#include <string>
+#include <memory>
+#include <utility>    // std::pair
+
+#include <cstddef>    // std::size_t
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Class AslAtomToken: a CommonToken that also keeps the atom of its
+// text, if it is an identifier or a literal, so the listeners get it
+// (and its text, kept in the atom table) without building a string
+// with getText nor searching the atom table again.
+
+class AslAtomToken final : public antlr4::CommonToken {
+
+public:
+
+  // Constructors (like the ones of CommonToken). The atom is EMPTY
+  // until it is set
+  AslAtomToken(std::pair<antlr4::TokenSource *, antlr4::CharStream *> source,
+	       std::size_t type, std::size_t channel, std::size_t start, std::size_t stop);
+  AslAtomToken(std::size_t type, const std::string & text);
+
+  // Atom of the text of the token (atomTable::EMPTY if it is not an
+  // identifier or a literal), and the text of the atom
+  atomTable::atom     getAtom     () const;
+  const std::string & getAtomText () const;
+  void                setAtom     (const atomTable & atoms, atomTable::atom a);
+
+private:
+
+  atomTable::atom     atom;
+  const std::string * atomText;
+
+};  // class AslAtomToken
+
+
+//////////////////////////////////////////////////////////////////////
+// Class AslAtomTokenFactory: creates the tokens of a source as
+// AslAtomToken's, interning the texts of the identifiers and literals
+// in an atom table as they are lexed. If the source is read in place
+// (a byteCharStream) the texts are taken from it, and no string is
+// built unless the text is new. It is set as the token factory of an
+// AslLexer or an AslFastLexer (with their setTokenFactory).
+
+class AslAtomTokenFactory final : public antlr4::TokenFactory<antlr4::CommonToken> {
+
+public:
+
+  // Constructor (the atom table must outlive the tokens; bytes is the
+  // source if it is read in place, or null)
+  AslAtomTokenFactory(atomTable & atoms, byteCharStream *bytes = nullptr);
+
+  std::unique_ptr<antlr4::CommonToken> create(std::pair<antlr4::TokenSource *, antlr4::CharStream *> source,
+					      std::size_t type, const std::string & text,
+					      std::size_t channel, std::size_t start, std::size_t stop,
+					      std::size_t line, std::size_t charPositionInLine) override;
+  std::unique_ptr<antlr4::CommonToken> create(std::size_t type, const std::string & text) override;
+
+  // Whether the tokens of a type are interned (identifiers and literals)
+  static bool isAtomType(std::size_t type);
+
+private:
+
+  atomTable  & atoms;
+  const char * bytes;
+
+};  // class AslAtomTokenFactory
+
+
+// Atom of the token of a terminal node, and its text (the tokens must
+// have been created by an AslAtomTokenFactory)
+atomTable::atom     atomOf     (antlr4::tree::TerminalNode *node);
+const std::string & atomTextOf (antlr4::tree::TerminalNode *node);
@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslBatch - Compiles many Asl programs in a single run, each one
+//               to its own output file (--batch)
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslBatch.h"
+
+#include "../common/sourcetext.h"
+
+#include <iostream>
+#include <fstream>    // ifstream, ofstream
+#include <sstream>    // ostringstream
+#include <map>
+#include <chrono>     // steady_clock
+
+#include <cstdlib>    // EXIT_FAILURE, EXIT_SUCCESS
+#include <cerrno>
+#include <cstdio>     // remove
+#include <sys/stat.h> // mkdir
+
+// using namespace std;
+
+
+// Puts in 'files' each of the 'arguments', or the files listed (one
+// per line) in it if it is a @<manifest>. Returns whether all the
+// manifests could be read.
+static bool readFileList(const std::vector<std::string> & arguments,
+			 std::vector<std::string> & files) {
+  for (auto & argument : arguments) {
+    if (argument.empty() or argument[0] != '@') {
+      files.push_back(argument);
+      continue;
+    }
+    std::ifstream manifest(argument.substr(1));
+    if (not manifest) {
+      std::cout << "No such file: " << argument.substr(1) << std::endl;
+      return false;
+    }
+    std::string line;
+    while (std::getline(manifest, line)) {
+      if (not line.empty()) files.push_back(line);
+    }
+  }
+  return true;
+}
+
+// Name of the file with the output of <file> in batch mode: its name,
+// without the directory and with the extension .asl replaced by 'ext',
+// in the directory 'dir'
+static std::string batchOutputName(const std::string & file, const std::string & dir,
+				   const std::string & ext) {
+  std::string name = file.substr(file.rfind('/') + 1);
+  const std::string asl = ".asl";
+  if (name.size() > asl.size() and
+      name.compare(name.size() - asl.size(), asl.size(), asl) == 0)
+    name.resize(name.size() - asl.size());
+  return dir + "/" + name + ext;
+}
+
+int compileBatch(const std::vector<std::string> & arguments,
+		 const std::string & outputDir,
+		 const driverOptions & options) {
+  std::vector<std::string> files;
+  if (not readFileList(arguments, files))
+    return EXIT_FAILURE;
+  if (::mkdir(outputDir.c_str(), 0777) != 0 and errno != EEXIST) {
+    std::cerr << "Could not create directory: " << outputDir << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::map<std::string, std::string> outputs;
+  for (auto & file : files) {
+    auto done = outputs.insert(std::make_pair(batchOutputName(file, outputDir, ""), file));
+    if (not done.second) {
+      std::cerr << file << ": same output as " << done.first->second << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::size_t failed = 0;
+  compilationTables tables;
+  auto start = std::chrono::steady_clock::now();
+  for (auto & file : files) {
+    sourceText source;
+    if (not source.load(file)) {
+      std::cerr << file << ": No such file" << std::endl;
+      ++failed;
+      continue;
+    }
+
+    std::ostringstream out;
+    bool ok;
+    std::string what;
+    try {
+      ok = compileSource(source.data(), source.size(), "", options, tables, out, out);
+    }
+    catch (std::exception & e) {
+      ok = false;
+      what = e.what();
+    }
+
+    std::string outfile = batchOutputName(file, outputDir, ok ? ".t" : ".err");
+    std::string stale = batchOutputName(file, outputDir, ok ? ".err" : ".t");
+    std::remove(stale.c_str());
+    std::ofstream output(outfile);
+    if (not (output << out.str() << std::flush)) {
+      std::cerr << file << ": Could not write file: " << outfile << std::endl;
+      ++failed;
+      continue;
+    }
+
+    if (not ok) {
+      ++failed;
+      std::cerr << file << ": errors found, see " << outfile;
+      if (not what.empty()) std::cerr << " (" << what << ")";
+      std::cerr << std::endl;
+    }
+  }
+  std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+  std::cerr << files.size() << " files compiled, " << failed << " with errors, in "
+	    << secs.count() << " s (" << files.size() / secs.count() << " files/s)"
+	    << std::endl;
+  if (options.cache)
+    std::cerr << "cache: " << options.cache->hits() << " hits, "
+	      << options.cache->misses() << " misses" << std::endl;
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
@@ -0,0 +1,52 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslBatch - Compiles many Asl programs in a single run, each one
+//               to its own output file (--batch)
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AslCompiler.h"
+
+#include <string>
+#include <vector>
+
+// using namespace std;
+
+
+// Compiles each of the given files, or of the files listed (one per
+// line) in a @<manifest>, in the same process (so the ANTLR caches of
+// the lexer and parser DFAs are kept warm from one file to the next,
+// and the same compilationTables are reused). All the output of a file
+// goes to its own file in the directory 'outputDir' (created if it
+// does not exist): its code to a .t file, or its errors to a .err file
+// (and the other one, left by a previous run, is removed). One line
+// per failed file is reported in std::cerr, followed by a summary with
+// the throughput. Two files with the same name (in different
+// directories) can not be compiled at once.
+int compileBatch(const std::vector<std::string> & arguments,
+		 const std::string & outputDir,
+		 const driverOptions & options);
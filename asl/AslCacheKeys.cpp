@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslCacheKeys - Key material of the outputs kept in the
+//                   compilation cache (see compilationCache)
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslCacheKeys.h"
+#include "AslAtomToken.h"
+
+#include <vector>
+#include <algorithm>  // min
+#include <cstring>    // memcmp
+
+// using namespace std;
+
+
+// Version of the compiler, part of the key of the cached compilations:
+// the Makefile defines ASL_SOURCES_HASH as the hash of the sources of
+// the compiler, so a changed compiler ignores the old entries (and the
+// same sources always give the same version). Without it, ASL_VERSION
+// must be increased whenever the output of the compiler changes.
+#define ASL_VERSION "1.0"
+#ifndef ASL_SOURCES_HASH
+#define ASL_SOURCES_HASH ""
+#endif
+static const char *compilerVersion = "asl " ASL_VERSION " " ASL_SOURCES_HASH;
+
+
+// Adds a field to some key material of the cache, preceded by its
+// length, so that different fields never give the same material
+static void addKeyField(std::string & material, const std::string & field) {
+  material += std::to_string(field.size());
+  material += ':';
+  material += field;
+}
+
+// Normalized form of a source, used for the key of the cache: each run
+// of white space and comments (that do not change the output of a
+// successful compilation) becomes a single blank, and the string and
+// character literals are kept as they are
+static std::string normalizeSource(const char *source, std::size_t n) {
+  std::string norm;
+  norm.reserve(n);
+  // end of the blank or comment at i (or i if there is none there)
+  auto skipBlank = [&](std::size_t i) -> std::size_t {
+    char c = source[i];
+    if (c == ' ' or c == '\t' or c == '\r' or c == '\n') return i + 1;
+    if (c != '/' or i + 1 >= n or source[i+1] != '/') return i;
+    std::size_t j = i + 2;
+    while (j < n and source[j] != '\r' and source[j] != '\n') ++j;
+    if (j == n) return i;
+    if (source[j] == '\n') return j + 1;
+    if (j + 1 < n and source[j+1] == '\n') return j + 2;
+    return i;
+  };
+  std::size_t i = 0;
+  while (i < n) {
+    std::size_t j = skipBlank(i);
+    if (j > i) {
+      while (j < n and skipBlank(j) > j) j = skipBlank(j);
+      norm += ' ';
+    }
+    else if (source[i] == '"') {
+      for (j = i + 1; j < n and source[j] != '"'; ++j)
+	if (source[j] == '\\') ++j;
+      j = std::min(j + 1, n);
+      norm.append(source + i, j - i);
+    }
+    else if (source[i] == '\'') {
+      if (i + 4 <= n and std::memcmp(source + i, "'\\n'", 4) == 0) j = i + 4;
+      else if (i + 2 < n and source[i+2] == '\'') j = i + 3;
+      else if (i + 1 < n and source[i+1] == '\'') j = i + 2;
+      else j = i + 1;
+      norm.append(source + i, j - i);
+    }
+    else {
+      j = i + 1;
+      norm += source[i];
+    }
+    i = j;
+  }
+  return norm;
+}
+
+std::string functionKeyMaterial(AslParser::FunctionContext *ctx,
+				antlr4::CommonTokenStream & tokens,
+				TypesMgr & types,
+				SymTable & symbols,
+				TreeDecoration & decorations) {
+  std::string material;
+  addKeyField(material, compilerVersion);
+  addKeyField(material, "function");
+  for (std::size_t i = ctx->getStart()->getTokenIndex();
+       i <= ctx->getStop()->getTokenIndex(); ++i)
+    addKeyField(material, tokens.get(i)->getText());
+  symbols.pushThisScope(decorations.getScope(ctx));
+  std::vector<antlr4::tree::ParseTree *> nodes(1, ctx);
+  while (not nodes.empty()) {
+    antlr4::tree::ParseTree *node = nodes.back();
+    nodes.pop_back();
+    nodes.insert(nodes.end(), node->children.rbegin(), node->children.rend());
+    auto identCtx = dynamic_cast<AslParser::IdentContext *>(node);
+    if (identCtx == nullptr) continue;
+    atomTable::atom ident = atomOf(identCtx->ID());
+    if (symbols.findInCurrentScope(ident)) continue;
+    addKeyField(material, atomTextOf(identCtx->ID()));
+    SymTable::SymbolHandle symbol = symbols.lookup(ident);
+    addKeyField(material, symbol.isFound() ? types.to_string(symbol.getType()) : "");
+  }
+  symbols.popScope();
+  return material;
+}
+
+
+std::string sourceKeyMaterial(const char *source, std::size_t size, bool objcode) {
+  std::string material;
+  addKeyField(material, compilerVersion);
+  addKeyField(material, objcode ? "objcode" : "t-code");
+  addKeyField(material, normalizeSource(source, size));
+  return material;
+}
@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslCacheKeys - Key material of the outputs kept in the
+//                   compilation cache (see compilationCache)
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "antlr4-runtime.h"
+#include "AslParser.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/TreeDecoration.h"
+
+#include <string>
+#include <cstddef>    // std::size_t
+
+// using namespace std;
+
+
+// Key material in the cache of the code of a function. Besides on its
+// tokens, the code depends on the global symbols it refers to (the signatures
+// of the functions it calls), so the type of each identifier that is
+// not declared in the function is part of the key. The symbol table
+// must have the global scope on its stack.
+std::string functionKeyMaterial(AslParser::FunctionContext *ctx,
+				antlr4::CommonTokenStream & tokens,
+				TypesMgr & types,
+				SymTable & symbols,
+				TreeDecoration & decorations);
+
+// Key material in the cache of the output of a whole source: the
+// compiler, the kind of output (t-code, or the code in binary format
+// if 'objcode') and the source but for blanks and comments (see
+// normalizeSource). --rd-parser, --fused and -j give the same output
+std::string sourceKeyMaterial(const char *source, std::size_t size, bool objcode);
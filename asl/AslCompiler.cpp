@@ -0,0 +1,423 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslCompiler - Compiles an Asl program to t-code, with the
+//                  options of the driver (see AslOptions)
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslCompiler.h"
+#include "AslCacheKeys.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+#include "AslParser.h"
+#include "tree/ParseTreeWalker.h"
+
+#include "../common/TreeDecoration.h"
+#include "../common/SemErrors.h"
+#include "../common/objcode.h"
+#include "../common/bytestream.h"
+#include "SymbolsListener.h"
+#include "TypeCheckListener.h"
+#include "CodeGenListener.h"
+#include "FusedListener.h"
+#include "AslFastLexer.h"
+#include "AslAtomToken.h"
+#include "AslAst.h"
+#include "AslRecursiveParser.h"
+#include "SymbolsPass.h"
+#include "TypeCheckPass.h"
+#include "CodeGenPass.h"
+
+#include <fstream>    // ifstream, ofstream
+#include <sstream>    // ostringstream
+#include <vector>
+#include <memory>     // unique_ptr
+
+// using namespace std;
+
+
+// Reports the lexical and syntactical errors like the
+// antlr4::ConsoleErrorListener, but to any stream
+class streamErrorListener : public antlr4::BaseErrorListener {
+public:
+  streamErrorListener(std::ostream & out) : out(out) { }
+  void syntaxError(antlr4::Recognizer *recognizer, antlr4::Token *offendingSymbol,
+		   size_t line, size_t charPositionInLine,
+		   const std::string &msg, std::exception_ptr e) override {
+    out << "line " << line << ":" << charPositionInLine << " " << msg << std::endl;
+  }
+private:
+  std::ostream & out;
+};
+
+// What is obtained from a function checked (and generated) by itself:
+// its errors, and its code with the table of its atoms (an extension
+// of the one of the compilation) and the arena of its subroutine. If
+// its code is reused from the cache, it is neither checked nor
+// generated.
+struct functionJob {
+  AslParser::FunctionContext  * ctx = nullptr;
+  // key material of the code of the function in the cache (if there is one)
+  std::string                   key;
+  bool                          reused = false;
+  SemErrors                     errors;
+  std::unique_ptr<atomTable>    atoms;
+  std::unique_ptr<arena>        memory;
+  std::unique_ptr<code>         funcCode;
+};
+
+// Checks the types of every function of the jobs not reused, and
+// generates its code if 'generate' and it has no errors, as a task of
+// 'pool' (or one after the other if there is no pool). Each task has
+// its own view of the symbol table (that must be complete), its own
+// errors, code, arena and extension of the table 'atoms' (that does
+// not change meanwhile), and it only writes the decorations of its own
+// nodes.
+static void walkFunctions(threadPool *pool,
+			  std::vector<functionJob> & jobs,
+			  AslParser::ProgramContext *program,
+			  TypesMgr & types,
+			  SymTable & symbols,
+			  TreeDecoration & decorations,
+			  const atomTable & atoms,
+			  bool generate) {
+  std::vector<functionJob *> pending;
+  for (auto & job : jobs) {
+    if (not job.reused) pending.push_back(&job);
+  }
+  auto task = [&](size_t i) {
+    functionJob & job = *pending[i];
+    job.atoms.reset(new atomTable(&atoms));
+    job.memory.reset(new arena);
+    SymTable view(types, symbols);
+    view.pushThisScope(decorations.getScope(program));
+    antlr4::tree::ParseTreeWalker walker;
+    TypeCheckListener typecheck(types, view, decorations, job.errors);
+    walker.walk(&typecheck, job.ctx);
+    if (generate and job.errors.getNumberOfSemanticErrors() == 0) {
+      job.funcCode.reset(new code(*job.atoms, job.memory.get()));
+      CodeGenListener codegenerator(types, view, decorations, *job.funcCode);
+      walker.walk(&codegenerator, job.ctx);
+    }
+  };
+  if (pool)
+    pool->run(pending.size(), task);
+  else
+    for (std::size_t i = 0; i < pending.size(); ++i) task(i);
+}
+
+bool emitCode(code & mycode, const std::string & objfile, std::ostream & out) {
+  if (not objfile.empty()) {
+    if (not write_objcode(mycode, objfile)) {
+      out << "Could not write file: " << objfile << std::endl;
+      return false;
+    }
+    return true;
+  }
+  mycode.dump(out);
+  out << std::endl;
+  return true;
+}
+
+
+// Compiles the program parsed into 'ast' by the AslRecursiveParser,
+// like compile does with a parse tree: the declarations are collected
+// by the SymbolsPass, the types checked by the TypeCheckPass and the
+// code generated by the CodeGenPass, each one a walk of the AST. The
+// atoms of the AST (and the operands of the code) are in the atom
+// table of 'tables', and the code is allocated in 'memory'.
+static bool compileAst(AslAst & ast, compilationTables & tables, arena & memory,
+		       const std::string & objfile, std::ostream & out) {
+  atomTable & atoms   = tables.atoms;
+  TypesMgr  & types   = tables.types;
+  SymTable  & symbols = tables.symbols;
+  SemErrors   errors(out);
+
+  code mycode(atoms, &memory, objfile.empty() ? &out : nullptr);
+
+  SymbolsPass symboldecl(types, symbols, errors);
+  symboldecl.walk(ast);
+  TypeCheckPass typecheck(types, symbols, errors);
+  typecheck.walk(ast);
+  if (errors.getNumberOfSemanticErrors() > 0) {
+    out << "There are semantic errors: no code generated." << std::endl;
+    return false;
+  }
+
+  CodeGenPass codegenerator(types, symbols, mycode);
+  codegenerator.walk(ast);
+  return emitCode(mycode, objfile, out);
+}
+
+// Compiles the program in the 'size' bytes of 'source' like
+// compileSource, but without looking at the cache of whole sources
+static bool compile(const char *source, std::size_t size,
+		    const std::string & objfile, const driverOptions & options,
+		    compilationTables & tables,
+		    std::ostream & out, std::ostream & log) {
+  bool fused = options.fused;
+  threadPool *pool = options.pool;
+
+  // arena for the objects of the compilation (code, subroutines...),
+  // that are freed all together when it is destroyed at the end
+  arena compilationArena;
+  tables.clear();
+
+  // the characters are read in place from the source, unless it is not
+  // ASCII (then it is decoded from UTF-8 into an ANTLRInputStream)
+  std::unique_ptr<antlr4::CharStream> input;
+  byteCharStream *bytes = nullptr;
+  if (byteCharStream::fits(source, size))
+    input.reset(bytes = new byteCharStream(source, size));
+  else
+    input.reset(new antlr4::ANTLRInputStream(source, size));
+
+  // the hand-written parser only reports whether the program is
+  // correct: if it is not, it is parsed again by the AslParser below,
+  // that gives the usual messages
+  // the identifiers and literals are interned in the atom table as
+  // they are lexed
+  atomTable & atoms = tables.atoms;
+  if (options.recursiveParser and bytes) {
+    AslAst ast(bytes->data(), atoms);
+    if (AslRecursiveParser(bytes).parse(ast))
+      return compileAst(ast, tables, compilationArena, objfile, out);
+  }
+
+  // create a lexer that consumes the character stream and produce a token stream
+  // (or the hand-written one, if it is selected and the source is read in place).
+  // Their tokens keep the atoms of their texts (see AslAtomToken)
+  auto tokenFactory = std::make_shared<AslAtomTokenFactory>(atoms, bytes);
+  AslLexer lexer(input.get());
+  lexer.setTokenFactory(tokenFactory);
+  std::unique_ptr<AslFastLexer> fastLexer;
+  if (options.fastLexer and bytes) {
+    fastLexer.reset(new AslFastLexer(bytes));
+    fastLexer->setTokenFactory(tokenFactory);
+  }
+  antlr4::CommonTokenStream tokens(fastLexer ? static_cast<antlr4::TokenSource *>(fastLexer.get()) : &lexer);
+
+  // create a parser that consumes the token stream, and parses it.
+  AslParser parser(&tokens);
+
+  // call the parser and get the parse tree. It is first tried with
+  // the faster SLL prediction, silently and giving up at the first
+  // error. Only if that fails (or there are lexical errors) the whole
+  // input is lexed (always by the AslLexer) and parsed again as usual
+  // (full LL prediction and error reporting), so the messages are the
+  // same as always.
+  AslParser::ProgramContext *tree = nullptr;
+  streamErrorListener logErrors(log);
+  lexer.removeErrorListeners();
+  parser.removeErrorListeners();
+  parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
+  parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+  try {
+    tree = parser.program();
+  }
+  catch (antlr4::ParseCancellationException &) {
+    tree = nullptr;
+  }
+  if (tree == nullptr or lexer.getNumberOfSyntaxErrors() > 0 or
+      (fastLexer and fastLexer->getNumberOfSyntaxErrors() > 0)) {
+    lexer.reset();
+    lexer.addErrorListener(&logErrors);
+    tokens.setTokenSource(&lexer);
+    parser.reset();
+    parser.addErrorListener(&logErrors);
+    parser.setErrorHandler(std::make_shared<antlr4::DefaultErrorStrategy>());
+    parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(antlr4::atn::PredictionMode::LL);
+    tree = parser.program();
+  }
+
+  // check for lexical or syntactical errors
+  if (lexer.getNumberOfSyntaxErrors() > 0 or
+      parser.getNumberOfSyntaxErrors() > 0) {
+    out << "Lexical and/or syntactical errors have been found." << std::endl;
+    return false;
+  }
+
+  // print the parse tree (for debugging purposes)
+  // std::cout << tree->toStringTree(&parser) << std::endl;
+
+  // create a walker that will traverse the tree and do several things,
+  // like checking variable types or generating code.
+  antlr4::tree::ParseTreeWalker walker;
+
+  // the functions checked and generated one by one (if there is a pool
+  // or a cache). Their arenas must outlive the decorations, that keep
+  // lists of instructions with nodes in them
+  std::vector<functionJob> functions;
+
+  // Auxililary classes we are going to need to store information while
+  // traversing the tree. They are described below in this document
+  TypesMgr     & types   = tables.types;
+  SymTable     & symbols = tables.symbols;
+  TreeDecoration decorations;
+  SemErrors      errors(out);
+
+  // Number the nodes of the tree, that are used to index their attributes
+  decorations.numberNodes(tree);
+
+  // Auxiliary class to store the code we will be creating. Each
+  // subroutine is printed to the output as soon as its code is complete
+  // (unless the code is to be written in binary format, or it is
+  // generated in the same walk as the typecheck, that can still find
+  // errors)
+  // (the operands of its instructions are atoms of the table of the tokens)
+  code mycode(atoms, &compilationArena, objfile.empty() and not fused ? &out : nullptr);
+  if (fused) {
+    // A single Listener that collects the declarations, checks the types
+    // and generates the code of each function at once
+    FusedListener fusedwalk(types, symbols, decorations, errors, mycode);
+    // Traverse the tree using this listener, so code is stored in 'mycode'
+    // (if there are no errors)
+    walker.walk(&fusedwalk, tree);
+  }
+  else if (pool or options.functionCache) {
+    // Create a Listener that looks for variables and function declarations in the tree
+    // and stores required information
+    SymbolsListener symboldecl(types, symbols, decorations, errors);
+    // Traverse the tree using this listener, to collect information about declared identifiers
+    walker.walk(&symboldecl, tree);
+
+    // The type checkings (and code generation, if there are no errors) of each
+    // function are done by themselves, in parallel if there is a pool. The errors
+    // are added in source order, and the checks of the whole program are done (and
+    // all the errors printed) by the TypeCheckListener on the program node
+    TypeCheckListener typecheck(types, symbols, decorations, errors);
+    typecheck.enterProgram(tree);
+    functions.resize(tree->function().size());
+    for (std::size_t i = 0; i < functions.size(); ++i) {
+      functionJob & job = functions[i];
+      job.ctx = tree->function(i);
+      if (not options.functionCache) continue;
+      // a function compiled before (and then without errors), with the same
+      // tokens and global symbols, is neither checked nor generated again
+      job.key = functionKeyMaterial(job.ctx, tokens, types, symbols, decorations);
+      // (its code is kept in binary format, see objcode)
+      std::string previous;
+      if (not options.cache->lookup(job.key, previous)) continue;
+      objcode previousObj;
+      if (previousObj.load(previous.data(), previous.size()) and
+          previousObj.get_num_subroutines() == 1 and
+          previousObj.find_subroutine(atomTextOf(job.ctx->ID())) == 0) {
+        job.funcCode.reset(new code(atoms, &compilationArena));
+        previousObj.get_code(*job.funcCode);
+        job.reused = true;
+      }
+    }
+    bool generate = errors.getNumberOfSemanticErrors() == 0;
+    walkFunctions(pool, functions, tree, types, symbols, decorations, atoms, generate);
+    for (auto & job : functions) errors.append(job.errors);
+    typecheck.exitProgram(tree);
+  }
+  else {
+    // Create a Listener that looks for variables and function declarations in the tree
+    // and stores required information
+    SymbolsListener symboldecl(types, symbols, decorations, errors);
+    // Traverse the tree using this listener, to collect information about declared identifiers
+    walker.walk(&symboldecl, tree);
+
+    // Create another Listener that will perform type checkings wherever it is needed
+    // (on expressions, assignments, parameter passing, etc)
+    TypeCheckListener typecheck(types, symbols, decorations, errors);
+    // Traverse the tree using this listener, so all types are checked
+    walker.walk(&typecheck, tree);
+  }
+
+  if (errors.getNumberOfSemanticErrors() > 0) {
+    out << "There are semantic errors: no code generated." << std::endl;
+    return false;
+  }
+
+  if (pool or options.functionCache) {
+    // Put the code of the functions together, in source order (keeping
+    // the new ones in the cache, in binary format)
+    for (auto & job : functions) {
+      if (options.functionCache and not job.reused) {
+	std::ostringstream obj;
+	if (write_objcode(*job.funcCode, obj))
+	  options.cache->store(job.key, obj.str());
+      }
+      subroutine & subr = job.funcCode->get_last_subroutine();
+      mycode.add_subroutine(subr);
+      mycode.flush_last_subroutine();
+    }
+  }
+  else if (not fused) {
+    // Create a third listener that will generate code for each part of the tree
+    CodeGenListener codegenerator(types, symbols, decorations, mycode);
+    // Traverse the tree using this listener, so code is generated and stored in 'mycode'
+    walker.walk(&codegenerator, tree);
+  }
+
+  // write the generated code in binary format, or print the rest of
+  // it (if any) as output
+  return emitCode(mycode, objfile, out);
+}
+
+bool compileSource(const char *source, std::size_t size,
+		   const std::string & objfile, const driverOptions & options,
+		   compilationTables & tables,
+		   std::ostream & out, std::ostream & log) {
+  if (not options.cache)
+    return compile(source, size, objfile, options, tables, out, log);
+
+  // the key covers all that the output depends on (see sourceKeyMaterial)
+  std::string material = sourceKeyMaterial(source, size, not objfile.empty());
+  std::string output;
+  if (options.cache->lookup(material, output)) {
+    if (objfile.empty()) {
+      out << output;
+      return true;
+    }
+    std::ofstream obj(objfile, std::ios::binary);
+    if (not obj.write(output.data(), output.size())) {
+      out << "Could not write file: " << objfile << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // compile, keeping what is printed to store it
+  std::ostringstream printed;
+  bool ok = compile(source, size, objfile, options, tables, printed, log);
+  out << printed.str();
+  if (ok) {
+    if (objfile.empty()) {
+      options.cache->store(material, printed.str());
+    }
+    else {
+      std::ifstream obj(objfile, std::ios::binary);
+      std::ostringstream contents;
+      if (obj and contents << obj.rdbuf())
+	options.cache->store(material, contents.str());
+    }
+  }
+  return ok;
+}
+
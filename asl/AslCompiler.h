@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslCompiler - Compiles an Asl program to t-code, with the
+//                  options of the driver (see AslOptions)
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "../common/atoms.h"
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/code.h"
+#include "../common/arena.h"
+#include "../common/threadpool.h"
+#include "../common/compcache.h"
+
+#include <string>
+#include <iostream>
+#include <cstddef>    // std::size_t
+
+// using namespace std;
+
+
+// Options of the driver that apply to every compilation
+struct driverOptions {
+  // get the tokens from the hand-written lexer (see AslFastLexer)
+  bool               fastLexer = false;
+  // parse with the hand-written parser, and compile its AST (see
+  // AslRecursiveParser)
+  bool               recursiveParser = false;
+  // walk the tree only once (see FusedListener)
+  bool               fused = false;
+  // check and generate the functions in parallel (if not null)
+  threadPool       * pool  = nullptr;
+  // reuse the output of previous compilations (if not null)
+  compilationCache * cache = nullptr;
+  // reuse also the code of the functions of previous compilations (in
+  // the cache), checking and generating the others one by one
+  bool               functionCache = false;
+};
+
+// The tables of the atoms, types and symbols of a compilation. They
+// can be kept from one compilation to the next (by each worker of the
+// server, or in batch mode), and then each one clears them, keeping
+// the memory they already have instead of building them again (so
+// they are not to be kept in an arena, that would only grow).
+struct compilationTables {
+  atomTable atoms;
+  TypesMgr  types;
+  SymTable  symbols;
+
+  explicit compilationTables(arena * memory = nullptr) :
+    types(memory), symbols(types, atoms, memory) { }
+  void clear() {
+    symbols.clear();
+    types.clear();
+    atoms.clear();
+  }
+};
+
+// Writes the generated code in binary format to <objfile> if it is
+// given, or else prints the rest of it (if any) to 'out'. Returns
+// whether it could be written.
+bool emitCode(code & mycode, const std::string & objfile, std::ostream & out);
+
+// Compiles the program in the 'size' bytes of 'source', with the
+// atoms, types and symbols in 'tables' (that are cleared first). The
+// code (or the errors found) is written to 'out', or in binary format
+// to <objfile> if it is given, and the lexical and syntactical errors
+// to 'log'. Returns whether the compilation succeeded. If there is a
+// cache, the output is taken from it when the same source (but for
+// blanks and comments) was successfully compiled before, without
+// parsing it; and otherwise it is stored in the cache after a
+// successful compilation.
+bool compileSource(const char *source, std::size_t size,
+		   const std::string & objfile, const driverOptions & options,
+		   compilationTables & tables,
+		   std::ostream & out, std::ostream & log);
@@ -0,0 +1,322 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslFastLexer - Hand-written, table-driven lexer of Asl
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslFastLexer.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+#include <cstring>
+#include <cassert>
+
+// using namespace std;
+
+
+namespace {
+
+// Classes of characters (that are told apart by the DFA)
+enum charClass : unsigned char {
+  C_OTHER, C_LETTER, C_N, C_ESC, C_DIGIT, C_DOT, C_DQUOTE, C_SQUOTE,
+  C_BACKSLASH, C_SLASH, C_CR, C_LF, C_BLANK, C_EQ, C_BANG, C_LT, C_GT,
+  C_PLUS, C_MINUS, C_STAR, C_PERCENT, C_LPAREN, C_RPAREN, C_LBRACK,
+  C_RBRACK, C_COMMA, C_COLON, C_SEMI, NUM_CLASSES
+};
+
+// States of the DFA (DEAD when no token can go on)
+enum dfaState : unsigned char {
+  DEAD, START, S_ID, S_INT, S_INTDOT, S_FLOAT, S_STR, S_STRESC, S_STREND,
+  S_CH1, S_CH2, S_CHX, S_CHBS, S_CHBSN, S_CHEND, S_DIV, S_COM, S_COMCR,
+  S_COMEND, S_WS, S_ASSIGN, S_EQUAL, S_BANG, S_DIFF, S_LT, S_LTE, S_GT,
+  S_GTE, S_PLUS, S_SUB, S_MUL, S_MOD, S_LPAREN, S_RPAREN, S_LCLAU,
+  S_RCLAU, S_COMMA, S_COLON, S_SEMI, NUM_STATES
+};
+
+// Slots of the keyword table, and its hash (perfect for the keywords,
+// that have at least two characters)
+const size_t NUM_SLOTS = 64;
+inline size_t keywordHash(const unsigned char *w, size_t n) {
+  return (w[0] + 4*w[1] + 23*w[n-1] + n) & (NUM_SLOTS - 1);
+}
+
+// Tables of the lexer, computed once from the rules of Asl.g4
+struct lexerTables {
+  unsigned char classOf[256];
+  unsigned char next[NUM_STATES][NUM_CLASSES];
+  // type of the token recognized in each state (0 if none)
+  size_t        accept[NUM_STATES];
+  struct keywordSlot {
+    const char *word;
+    size_t      length, type;
+  } keywords[NUM_SLOTS];
+
+  lexerTables();
+};
+
+lexerTables::lexerTables() {
+  std::memset(classOf, C_OTHER, sizeof(classOf));
+  for (int c = 'a'; c <= 'z'; ++c) classOf[c] = C_LETTER;
+  for (int c = 'A'; c <= 'Z'; ++c) classOf[c] = C_LETTER;
+  for (int c = '0'; c <= '9'; ++c) classOf[c] = C_DIGIT;
+  // letters that can follow a backslash in a STRING (or a CHARS, 'n')
+  classOf[unsigned('n')] = C_N;
+  for (const char *c = "btfr"; *c; ++c) classOf[unsigned(*c)] = C_ESC;
+  const char *singles = "_.\"'\\/\r\n \t=!<>+-*%()[],:;";
+  const unsigned char singleClass[] = {
+    C_LETTER, C_DOT, C_DQUOTE, C_SQUOTE, C_BACKSLASH, C_SLASH, C_CR, C_LF,
+    C_BLANK, C_BLANK, C_EQ, C_BANG, C_LT, C_GT, C_PLUS, C_MINUS, C_STAR,
+    C_PERCENT, C_LPAREN, C_RPAREN, C_LBRACK, C_RBRACK, C_COMMA, C_COLON,
+    C_SEMI
+  };
+  for (size_t i = 0; singles[i]; ++i) classOf[unsigned(singles[i])] = singleClass[i];
+
+  std::memset(next, DEAD, sizeof(next));
+  auto on = [this](dfaState from, std::initializer_list<charClass> classes, dfaState to) {
+    for (auto c : classes) next[from][c] = to;
+  };
+  auto onAny = [this](dfaState from, dfaState to) {
+    for (size_t c = 0; c < NUM_CLASSES; ++c) next[from][c] = to;
+  };
+  // ID, INTVAL, FLOATVAL
+  on(START, {C_LETTER, C_N, C_ESC}, S_ID);
+  on(S_ID, {C_LETTER, C_N, C_ESC, C_DIGIT}, S_ID);
+  on(START, {C_DIGIT}, S_INT);
+  on(S_INT, {C_DIGIT}, S_INT);
+  on(S_INT, {C_DOT}, S_INTDOT);
+  on(S_INTDOT, {C_DIGIT}, S_FLOAT);
+  on(S_FLOAT, {C_DIGIT}, S_FLOAT);
+  // STRING : '"' ( ESC_SEQ | ~('\\'|'"') )* '"'
+  on(START, {C_DQUOTE}, S_STR);
+  onAny(S_STR, S_STR);
+  on(S_STR, {C_BACKSLASH}, S_STRESC);
+  on(S_STR, {C_DQUOTE}, S_STREND);
+  on(S_STRESC, {C_N, C_ESC, C_DQUOTE, C_SQUOTE, C_BACKSLASH}, S_STR);
+  // CHARS : '\''( . | '\\n' )?'\''
+  on(START, {C_SQUOTE}, S_CH1);
+  onAny(S_CH1, S_CHX);
+  on(S_CH1, {C_SQUOTE}, S_CH2);
+  on(S_CH1, {C_BACKSLASH}, S_CHBS);
+  on(S_CH2, {C_SQUOTE}, S_CHEND);
+  on(S_CHX, {C_SQUOTE}, S_CHEND);
+  on(S_CHBS, {C_SQUOTE}, S_CHEND);
+  on(S_CHBS, {C_N}, S_CHBSN);
+  on(S_CHBSN, {C_SQUOTE}, S_CHEND);
+  // DIV, and COMMENT : '//' ~('\n'|'\r')* '\r'? '\n'
+  on(START, {C_SLASH}, S_DIV);
+  on(S_DIV, {C_SLASH}, S_COM);
+  onAny(S_COM, S_COM);
+  on(S_COM, {C_CR}, S_COMCR);
+  on(S_COM, {C_LF}, S_COMEND);
+  on(S_COMCR, {C_LF}, S_COMEND);
+  // WS
+  on(START, {C_CR, C_LF, C_BLANK}, S_WS);
+  on(S_WS, {C_CR, C_LF, C_BLANK}, S_WS);
+  // operators and punctuation
+  on(START, {C_EQ}, S_ASSIGN);
+  on(S_ASSIGN, {C_EQ}, S_EQUAL);
+  on(START, {C_BANG}, S_BANG);
+  on(S_BANG, {C_EQ}, S_DIFF);
+  on(START, {C_LT}, S_LT);
+  on(S_LT, {C_EQ}, S_LTE);
+  on(START, {C_GT}, S_GT);
+  on(S_GT, {C_EQ}, S_GTE);
+  on(START, {C_PLUS}, S_PLUS);
+  on(START, {C_MINUS}, S_SUB);
+  on(START, {C_STAR}, S_MUL);
+  on(START, {C_PERCENT}, S_MOD);
+  on(START, {C_LPAREN}, S_LPAREN);
+  on(START, {C_RPAREN}, S_RPAREN);
+  on(START, {C_LBRACK}, S_LCLAU);
+  on(START, {C_RBRACK}, S_RCLAU);
+  on(START, {C_COMMA}, S_COMMA);
+  on(START, {C_COLON}, S_COLON);
+  on(START, {C_SEMI}, S_SEMI);
+
+  std::memset(accept, 0, sizeof(accept));
+  accept[S_ID]     = AslLexer::ID;
+  accept[S_INT]    = AslLexer::INTVAL;
+  accept[S_FLOAT]  = AslLexer::FLOATVAL;
+  accept[S_STREND] = AslLexer::STRING;
+  accept[S_CH2]    = AslLexer::CHARS;
+  accept[S_CHEND]  = AslLexer::CHARS;
+  accept[S_DIV]    = AslLexer::DIV;
+  accept[S_COMEND] = AslLexer::COMMENT;
+  accept[S_WS]     = AslLexer::WS;
+  accept[S_ASSIGN] = AslLexer::ASSIGN;
+  accept[S_EQUAL]  = AslLexer::EQUAL;
+  accept[S_DIFF]   = AslLexer::DIFF;
+  accept[S_LT]     = AslLexer::LT;
+  accept[S_LTE]    = AslLexer::LTE;
+  accept[S_GT]     = AslLexer::GT;
+  accept[S_GTE]    = AslLexer::GTE;
+  accept[S_PLUS]   = AslLexer::PLUS;
+  accept[S_SUB]    = AslLexer::SUB;
+  accept[S_MUL]    = AslLexer::MUL;
+  accept[S_MOD]    = AslLexer::MOD;
+  accept[S_LPAREN] = AslLexer::LPAREN;
+  accept[S_RPAREN] = AslLexer::RPAREN;
+  accept[S_LCLAU]  = AslLexer::LCLAU;
+  accept[S_RCLAU]  = AslLexer::RCLAU;
+  accept[S_COMMA]  = AslLexer::COMMA;
+  accept[S_COLON]  = AslLexer::COLON;
+  accept[S_SEMI]   = AslLexer::SEMI;
+
+  const keywordSlot words[] = {
+    {"true", 4, AslLexer::TRUE},     {"false", 5, AslLexer::FALSE},
+    {"of", 2, AslLexer::OF},         {"array", 5, AslLexer::ARRAY},
+    {"not", 3, AslLexer::NOT},       {"and", 3, AslLexer::AND},
+    {"or", 2, AslLexer::OR},         {"var", 3, AslLexer::VAR},
+    {"int", 3, AslLexer::INT},       {"float", 5, AslLexer::FLOAT},
+    {"bool", 4, AslLexer::BOOL},     {"char", 4, AslLexer::CHAR},
+    {"if", 2, AslLexer::IF},         {"then", 4, AslLexer::THEN},
+    {"else", 4, AslLexer::ELSE},     {"endif", 5, AslLexer::ENDIF},
+    {"while", 5, AslLexer::WHILE},   {"do", 2, AslLexer::DO},
+    {"endwhile", 8, AslLexer::ENDWHILE},
+    {"func", 4, AslLexer::FUNC},     {"endfunc", 7, AslLexer::ENDFUNC},
+    {"read", 4, AslLexer::READ},     {"write", 5, AslLexer::WRITE},
+    {"return", 6, AslLexer::RETURN}
+  };
+  for (auto & slot : keywords) slot = keywordSlot{"", 0, AslLexer::ID};
+  for (auto & word : words) {
+    size_t h = keywordHash(reinterpret_cast<const unsigned char *>(word.word), word.length);
+    assert(keywords[h].length == 0);  // the hash must be perfect
+    keywords[h] = word;
+  }
+}
+
+const lexerTables TABLES;
+
+}  // namespace
+
+
+// Constructor
+AslFastLexer::AslFastLexer(byteCharStream *input) :
+  input{input},
+  text{input->data()},
+  length{input->size()},
+  position{0},
+  line{1},
+  column{0},
+  errors{0},
+  factory{antlr4::CommonTokenFactory::DEFAULT} {
+}
+
+std::unique_ptr<antlr4::Token> AslFastLexer::nextToken() {
+  std::pair<antlr4::TokenSource *, antlr4::CharStream *> source(this, input);
+  rawToken token = scan();
+  return factory->create(source, token.type, "", antlr4::Token::DEFAULT_CHANNEL,
+			 token.start, token.stop, token.line, token.column);
+}
+
+AslFastLexer::rawToken AslFastLexer::scan() {
+  while (position < length) {
+    size_t end;
+    size_t type = match(end);
+    if (type == 0) {
+      // no token starts here: like AslLexer, skip the characters read
+      // until the DFA stopped, and then the one it stopped at
+      ++errors;
+      advance(end < length ? end + 1 : length);
+      continue;
+    }
+    if (type == AslLexer::COMMENT or type == AslLexer::WS) {
+      advance(end);
+      continue;
+    }
+    if (type == AslLexer::ID) type = keyword(position, end);
+    rawToken token{type, position, end - 1, line, column};
+    advance(end);
+    return token;
+  }
+  return rawToken{antlr4::Token::EOF, position, position - 1, line, column};
+}
+
+size_t AslFastLexer::match(size_t & end) const {
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(text);
+  size_t type = 0;
+  unsigned char state = START;
+  size_t i = position;
+  for (; i < length; ++i) {
+    state = TABLES.next[state][TABLES.classOf[bytes[i]]];
+    if (state == DEAD) break;
+    if (TABLES.accept[state] != 0) {
+      type = TABLES.accept[state];
+      end = i + 1;
+    }
+  }
+  if (type == 0) end = i;
+  return type;
+}
+
+void AslFastLexer::advance(size_t end) {
+  for (; position < end; ++position) {
+    if (text[position] == '\n') {
+      ++line;
+      column = 0;
+    }
+    else {
+      ++column;
+    }
+  }
+}
+
+size_t AslFastLexer::keyword(size_t start, size_t end) const {
+  size_t n = end - start;
+  if (n < 2) return AslLexer::ID;
+  const unsigned char *word = reinterpret_cast<const unsigned char *>(text + start);
+  const lexerTables::keywordSlot & slot = TABLES.keywords[keywordHash(word, n)];
+  if (slot.length == n and std::memcmp(slot.word, word, n) == 0) return slot.type;
+  return AslLexer::ID;
+}
+
+size_t AslFastLexer::getLine() const {
+  return line;
+}
+
+size_t AslFastLexer::getCharPositionInLine() {
+  return column;
+}
+
+antlr4::CharStream * AslFastLexer::getInputStream() {
+  return input;
+}
+
+std::string AslFastLexer::getSourceName() {
+  return input->getSourceName();
+}
+
+Ref<antlr4::TokenFactory<antlr4::CommonToken>> AslFastLexer::getTokenFactory() {
+  return factory;
+}
+
+void AslFastLexer::setTokenFactory(Ref<antlr4::TokenFactory<antlr4::CommonToken>> factory) {
+  this->factory = factory;
+}
+
+size_t AslFastLexer::getNumberOfSyntaxErrors() const {
+  return errors;
+}
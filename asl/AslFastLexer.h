@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslFastLexer - Hand-written, table-driven lexer of Asl
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+#include "../common/bytestream.h"
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Class AslFastLexer:  a token source that gives the same tokens as
+// the AslLexer generated by ANTLR, so it can be used instead of it
+// by a CommonTokenStream. Instead of simulating the ATN of the
+// grammar, each token is recognized by a DFA (a transition table on
+// classes of characters) that keeps the longest match, like ANTLR
+// does, and the keywords are told from the identifiers with a
+// perfect hash. It reads the source in place from a byteCharStream.
+// The characters that do not start any token are counted and
+// skipped as AslLexer skips them, but not reported: then the source must be lexed again
+// with an AslLexer to get its error messages.
+
+class AslFastLexer final : public antlr4::TokenSource {
+
+public:
+
+  // Constructor
+  AslFastLexer(byteCharStream *input);
+
+  std::unique_ptr<antlr4::Token> nextToken() override;
+  size_t getLine() const override;
+  size_t getCharPositionInLine() override;
+  antlr4::CharStream * getInputStream() override;
+  std::string getSourceName() override;
+  Ref<antlr4::TokenFactory<antlr4::CommonToken>> getTokenFactory() override;
+  // The tokens are created by 'factory' (the CommonTokenFactory, unless
+  // another one is set)
+  void setTokenFactory(Ref<antlr4::TokenFactory<antlr4::CommonToken>> factory);
+
+  // Number of characters that did not start any token
+  size_t getNumberOfSyntaxErrors() const;
+
+  // A token as it is found in the source, without the antlr4::Token
+  // object (that AslRecursiveParser does not need)
+  struct rawToken {
+    size_t type;          // Token::EOF at the end of the source
+    size_t start, stop;   // positions of its first and last characters
+    size_t line, column;
+  };
+  // Recognizes the next token (the same one nextToken would give)
+  rawToken scan();
+
+private:
+
+  // Attributes:
+  byteCharStream * input;
+  const char     * text;
+  size_t           length;
+  // next character, and its line (from 1) and column (from 0)
+  size_t           position, line, column;
+  size_t           errors;
+  Ref<antlr4::TokenFactory<antlr4::CommonToken>> factory;
+
+  // Type of the longest token at the current position, and the
+  // position after its last character in 'end'. If there is none, it
+  // returns 0 and 'end' is the position of the character that the DFA
+  // could not take
+  size_t match(size_t & end) const;
+  // Moves the current position to 'end', counting the lines
+  void advance(size_t end);
+  // Type of the keyword in text[start, end) (ID if it is not a keyword)
+  size_t keyword(size_t start, size_t end) const;
+
+};  // class AslFastLexer
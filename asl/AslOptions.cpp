@@ -0,0 +1,140 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslOptions - Command line of the driver of the Asl compiler,
+//                 and the checks of the correct use of its options
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslOptions.h"
+
+#include <cstdlib>    // strtoull
+#include <cstdint>    // SIZE_MAX
+#include <cerrno>
+
+// using namespace std;
+
+
+// Reads in 'n' the number written in 'text' (only decimal digits), if
+// it is not greater than 'max'. Returns whether it could.
+static bool readNumber(const char *text, std::size_t max, std::size_t & n) {
+  if (*text < '0' or *text > '9') return false;
+  char *end;
+  errno = 0;
+  unsigned long long value = std::strtoull(text, &end, 10);
+  if (*end != '\0' or errno == ERANGE or value > max) return false;
+  n = value;
+  return true;
+}
+
+// Largest number of threads of -j
+static const std::size_t MAX_THREADS = 1024;
+// Largest size of the cache (in megabytes, that must fit in a size_t
+// as bytes)
+static const std::size_t MAX_CACHE_SIZE = SIZE_MAX / (1024*1024);
+
+bool parseCommandLine(int argc, const char *argv[], commandLine & cmd, std::string & error) {
+  driverOptions & options = cmd.options;
+  int arg = 1;
+  for (; arg < argc; ++arg) {
+    std::string option = argv[arg];
+    if (option == "--fast-lexer")
+      options.fastLexer = true;
+    else if (option == "--rd-parser")
+      options.recursiveParser = true;
+    else if (option == "--fused")
+      options.fused = true;
+    else if (option == "--batch")
+      cmd.batch = true;
+    else if (option == "--output-dir" and arg + 1 < argc)
+      cmd.outputDir = argv[++arg];
+    else if (option == "--server" and arg + 1 < argc)
+      cmd.socketPath = argv[++arg];
+    else if (option == "-j" and arg + 1 < argc) {
+      if (not readNumber(argv[++arg], MAX_THREADS, cmd.threads)) {
+	error = "Invalid number of threads (0 to " + std::to_string(MAX_THREADS) + "): " + argv[arg];
+	return false;
+      }
+      cmd.parallel = true;
+    }
+    else if (option == "--cache-dir" and arg + 1 < argc)
+      cmd.cacheDir = argv[++arg];
+    else if (option == "--cache-functions")
+      options.functionCache = true;
+    else if (option == "--cache-size" and arg + 1 < argc) {
+      if (not readNumber(argv[++arg], MAX_CACHE_SIZE, cmd.cacheSize) or cmd.cacheSize == 0) {
+	error = "Invalid cache size (1 to " + std::to_string(MAX_CACHE_SIZE) + " megabytes): " + argv[arg];
+	return false;
+      }
+    }
+    else if (option == "-o" and arg + 1 < argc)
+      cmd.objfile = argv[++arg];
+    else if (option == "--disassemble" and arg + 1 < argc)
+      cmd.disassembled = argv[++arg];
+    else if (option == "--tokens")
+      cmd.tokens = true;
+    else
+      break;
+  }
+  cmd.files.assign(argv + arg, argv + argc);
+
+  // check the correct use of each option
+  bool server = not cmd.socketPath.empty();
+  if (not cmd.disassembled.empty() and argc != 3)
+    error = "--disassemble takes no other option";
+  else if (cmd.batch and cmd.outputDir.empty())
+    error = "--batch needs --output-dir";
+  else if (cmd.batch and not cmd.objfile.empty())
+    error = "--batch can not write an <objfile> (-o)";
+  else if (not cmd.batch and not cmd.outputDir.empty())
+    error = "--output-dir only with --batch";
+  else if (not cmd.batch and cmd.files.size() > 1)
+    error = "only one <file> without --batch";
+  else if (server and (cmd.batch or not cmd.objfile.empty() or not cmd.files.empty()))
+    error = "--server takes no --batch, -o nor <file>";
+  else if (options.recursiveParser and options.fused)
+    error = "--rd-parser and --fused can not be used together";
+  else if ((options.recursiveParser or options.fused) and cmd.parallel and not server)
+    error = "-j with --rd-parser or --fused only with --server";
+  else if (options.functionCache and cmd.cacheDir.empty())
+    error = "--cache-functions needs --cache-dir";
+  else if (options.functionCache and (options.recursiveParser or options.fused))
+    error = "--cache-functions can not be used with --rd-parser nor --fused";
+  else if (cmd.tokens and (options.recursiveParser or options.fused or cmd.parallel or
+			   cmd.batch or server or not cmd.objfile.empty() or
+			   not cmd.cacheDir.empty()))
+    error = "--tokens only with --fast-lexer";
+  return error.empty();
+}
+
+void printUsage(std::ostream & out) {
+  out << "Usage: ./main [--fast-lexer] [--rd-parser|--fused|-j <n>] [--cache-dir <dir> [--cache-size <mb>] [--cache-functions]]" << std::endl;
+  out << "              [-o <objfile>] [<file>]" << std::endl;
+  out << "       ./main [--fast-lexer] [--rd-parser|--fused|-j <n>] [--cache-dir <dir> [--cache-size <mb>] [--cache-functions]]" << std::endl;
+  out << "              --batch --output-dir <dir> <file>|@<manifest>..." << std::endl;
+  out << "       ./main [--fast-lexer] [--rd-parser|--fused] [-j <n>] [--cache-dir <dir> [--cache-size <mb>] [--cache-functions]]" << std::endl;
+  out << "              --server <socket>" << std::endl;
+  out << "       ./main --disassemble <objfile>" << std::endl;
+  out << "       ./main [--fast-lexer] --tokens [<file>]" << std::endl;
+}
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslOptions - Command line of the driver of the Asl compiler,
+//                 and the checks of the correct use of its options
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AslCompiler.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstddef>    // std::size_t
+
+// using namespace std;
+
+
+// The command line of the driver: --fast-lexer gets the tokens from a
+// hand-written lexer (see AslFastLexer), --rd-parser parses it with a
+// hand-written parser and compiles its AST (see AslRecursiveParser),
+// --fused walks the tree only once (see FusedListener), -j checks and
+// generates the functions in parallel in <n> threads (one per core if
+// 0), -o writes the code in binary format to <objfile>, --batch
+// compiles each of the given files, or of the files listed (one per
+// line) in a @<manifest>, to its own output in the directory of
+// --output-dir <dir> (<name>.t, or <name>.err if it has errors),
+// --cache-dir reuses the outputs kept in <dir> (that are evicted,
+// least recently used first, when they take more than --cache-size
+// <megabytes>), and also the code of each function with
+// --cache-functions, --server serves the compilations requested
+// through the Unix socket <socket> in <n> threads (see compileServer),
+// --disassemble prints the code of an <objfile> written with -o, and
+// --tokens prints the tokens of <file> (see listTokens)
+struct commandLine {
+  // the pool and the cache are set by the driver, not read here
+  driverOptions            options;
+  bool                     batch = false;
+  std::string              outputDir;
+  std::string              socketPath;
+  // -j is given, with 'threads' (0 for one per core)
+  bool                     parallel = false;
+  std::size_t              threads = 0;
+  std::string              cacheDir;
+  // in megabytes
+  std::size_t              cacheSize = 512;
+  std::string              objfile;
+  std::string              disassembled;
+  bool                     tokens = false;
+  // the arguments after the options (the sources, or the manifests)
+  std::vector<std::string> files;
+};
+
+// Reads the command line in 'argv' into 'cmd', and checks that each
+// option is used with the right ones. Returns whether it is correct,
+// or else leaves in 'error' why it is not.
+bool parseCommandLine(int argc, const char *argv[], commandLine & cmd, std::string & error);
+
+// Prints how the driver is to be used
+void printUsage(std::ostream & out);
@@ -0,0 +1,454 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslRecursiveParser - Hand-written recursive descent parser
+//                         that builds the AST of an Asl program
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslRecursiveParser.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+// using namespace std;
+
+
+namespace {
+
+// Levels of precedence of the operators, from the loosest: the order
+// of the alternatives of expr in Asl.g4 (0 is not a binary operator)
+const int BOOLEAN_LEVEL    = 1;
+const int RELATIONAL_LEVEL = 2;
+const int ADDITIVE_LEVEL   = 3;
+const int MULTIPLY_LEVEL   = 4;
+const int UNARY_LEVEL      = 5;
+
+int binaryLevel(std::size_t type) {
+  switch (type) {
+  case AslLexer::AND: case AslLexer::OR:
+    return BOOLEAN_LEVEL;
+  case AslLexer::EQUAL: case AslLexer::DIFF: case AslLexer::GTE:
+  case AslLexer::GT: case AslLexer::LT: case AslLexer::LTE:
+    return RELATIONAL_LEVEL;
+  case AslLexer::PLUS: case AslLexer::SUB:
+    return ADDITIVE_LEVEL;
+  case AslLexer::MUL: case AslLexer::DIV: case AslLexer::MOD:
+    return MULTIPLY_LEVEL;
+  default:
+    return 0;
+  }
+}
+
+AstKind binaryKind(int level) {
+  if (level == BOOLEAN_LEVEL) return AstKind::Boolean;
+  if (level == RELATIONAL_LEVEL) return AstKind::Relational;
+  return AstKind::Arithmetic;
+}
+
+}  // namespace
+
+
+// Constructor
+AslRecursiveParser::AslRecursiveParser(byteCharStream *input) :
+  lexer{input},
+  ast{nullptr},
+  pos{0} {
+}
+
+bool AslRecursiveParser::parse(AslAst & ast) {
+  this->ast = &ast;
+  pos = 0;
+  pending.clear();
+  ast.tokens.clear();
+  ast.atoms.clear();
+  do {
+    ast.addToken(lexer.scan());
+    // the tokens are numbered with 32 bits
+    if (ast.tokens.size() == AstNode::NONE) return false;
+  } while (ast.tokens.back().type != antlr4::Token::EOF);
+  if (lexer.getNumberOfSyntaxErrors() > 0) return false;
+  ast.root = program();
+  return ast.root != nullptr;
+}
+
+std::size_t AslRecursiveParser::la(std::size_t k) const {
+  // past the end there is always the EOF
+  if (pos + k >= ast->tokens.size()) return antlr4::Token::EOF;
+  return ast->tokens[pos + k].type;
+}
+
+bool AslRecursiveParser::accept(std::size_t type) {
+  if (la() != type) return false;
+  ++pos;
+  return true;
+}
+
+AstNode * AslRecursiveParser::node(AstKind kind, std::uint32_t token, std::uint32_t first,
+				   std::size_t mark) {
+  AstNode *n = ast->newNode(kind, token, first, pending.data() + mark, pending.size() - mark);
+  pending.resize(mark);
+  return n;
+}
+
+// program : function+ EOF
+AstNode * AslRecursiveParser::program() {
+  std::size_t mark = pending.size();
+  do {
+    AstNode *f = function();
+    if (not f) return nullptr;
+    pending.push_back(f);
+  } while (la() == AslLexer::FUNC);
+  if (la() != antlr4::Token::EOF) return nullptr;
+  return node(AstKind::Program, pos, 0, mark);
+}
+
+// function : FUNC ID '(' ((param_decl ',')* param_decl)? ')' (':' type)?
+//            declarations statements ENDFUNC
+AstNode * AslRecursiveParser::function() {
+  std::uint32_t first = pos;
+  if (not accept(AslLexer::FUNC)) return nullptr;
+  std::uint32_t id = pos;
+  if (not accept(AslLexer::ID) or not accept(AslLexer::LPAREN)) return nullptr;
+  std::size_t mark = pending.size();
+  if (la() != AslLexer::RPAREN) {
+    do {
+      AstNode *param = paramDecl();
+      if (not param) return nullptr;
+      pending.push_back(param);
+    } while (accept(AslLexer::COMMA));
+  }
+  if (not accept(AslLexer::RPAREN)) return nullptr;
+  std::uint32_t returnType = AstNode::NONE;
+  if (accept(AslLexer::COLON)) {
+    returnType = pos;
+    if (not type()) return nullptr;
+  }
+  AstNode *decls = declarations();
+  if (not decls) return nullptr;
+  pending.push_back(decls);
+  AstNode *stmts = statements();
+  if (not stmts or not accept(AslLexer::ENDFUNC)) return nullptr;
+  pending.push_back(stmts);
+  AstNode *f = node(AstKind::Function, id, first, mark);
+  f->aux = returnType;
+  return f;
+}
+
+// param_decl : ID ':' ARRAY '[' expr ']' OF type   # arrayParamDecl
+//            | ID ':' type                         # basicParamDecl
+AstNode * AslRecursiveParser::paramDecl() {
+  std::uint32_t id = pos;
+  if (not accept(AslLexer::ID) or not accept(AslLexer::COLON)) return nullptr;
+  std::size_t mark = pending.size();
+  AstKind kind = AstKind::BasicParamDecl;
+  if (accept(AslLexer::ARRAY)) {
+    kind = AstKind::ArrayParamDecl;
+    if (not accept(AslLexer::LCLAU)) return nullptr;
+    AstNode *size = expr(BOOLEAN_LEVEL);
+    if (not size or not accept(AslLexer::RCLAU) or not accept(AslLexer::OF)) return nullptr;
+    pending.push_back(size);
+  }
+  std::uint32_t t = pos;
+  if (not type()) return nullptr;
+  AstNode *param = node(kind, id, id, mark);
+  param->aux = t;
+  return param;
+}
+
+// declarations : (VAR decl)*
+AstNode * AslRecursiveParser::declarations() {
+  std::uint32_t first = pos;
+  std::size_t mark = pending.size();
+  while (accept(AslLexer::VAR)) {
+    AstNode *d = decl();
+    if (not d) return nullptr;
+    pending.push_back(d);
+  }
+  return node(AstKind::Declarations, first, first, mark);
+}
+
+// decl : ident (',' ident)* ':' ARRAY '[' expr ']' OF type   # arrayDecl
+//      | ID (',' ID)* ':' type                              # basicDecl
+AstNode * AslRecursiveParser::decl() {
+  std::uint32_t first = pos;
+  do {
+    if (not accept(AslLexer::ID)) return nullptr;
+  } while (accept(AslLexer::COMMA));
+  std::uint32_t colon = pos;
+  if (not accept(AslLexer::COLON)) return nullptr;
+  std::size_t mark = pending.size();
+  AstKind kind = AstKind::BasicDecl;
+  if (accept(AslLexer::ARRAY)) {
+    kind = AstKind::ArrayDecl;
+    for (std::uint32_t id = first; id < colon; id += 2)
+      pending.push_back(ast->newNode(AstKind::Ident, id, id));
+    if (not accept(AslLexer::LCLAU)) return nullptr;
+    AstNode *size = expr(BOOLEAN_LEVEL);
+    if (not size or not accept(AslLexer::RCLAU) or not accept(AslLexer::OF)) return nullptr;
+    pending.push_back(size);
+  }
+  std::uint32_t t = pos;
+  if (not type()) return nullptr;
+  AstNode *d = node(kind, first, first, mark);
+  d->aux = t;
+  return d;
+}
+
+// type : INT | FLOAT | BOOL | CHAR
+bool AslRecursiveParser::type() {
+  return accept(AslLexer::INT) or accept(AslLexer::FLOAT) or
+         accept(AslLexer::BOOL) or accept(AslLexer::CHAR);
+}
+
+// statements : (statement)*
+AstNode * AslRecursiveParser::statements() {
+  std::uint32_t first = pos;
+  std::size_t mark = pending.size();
+  for (;;) {
+    std::size_t t = la();
+    if (t != AslLexer::ID and t != AslLexer::IF and t != AslLexer::WHILE and
+        t != AslLexer::READ and t != AslLexer::WRITE and t != AslLexer::RETURN)
+      break;
+    AstNode *s = statement();
+    if (not s) return nullptr;
+    pending.push_back(s);
+  }
+  return node(AstKind::Statements, first, first, mark);
+}
+
+// statement : left_expr ASSIGN expr ';'                         # assignStmt
+//           | IF expr THEN statements (ELSE statements)? ENDIF  # ifStmt
+//           | WHILE expr DO statements ENDWHILE                 # whileStmt
+//           | functioncall ';'                                  # funcStmt
+//           | READ left_expr ';'                                # readStmt
+//           | WRITE expr ';'                                    # writeExpr
+//           | WRITE STRING ';'                                  # writeString
+//           | RETURN expr? ';'                                  # returnStmt
+AstNode * AslRecursiveParser::statement() {
+  std::uint32_t first = pos;
+  std::size_t mark = pending.size();
+  switch (la()) {
+  case AslLexer::ID: {
+    if (la(1) == AslLexer::LPAREN) {
+      AstNode *call = procCall();
+      if (not call or not accept(AslLexer::SEMI)) return nullptr;
+      pending.push_back(call);
+      return node(AstKind::FuncStmt, first, first, mark);
+    }
+    AstNode *left = leftExpr();
+    if (not left) return nullptr;
+    pending.push_back(left);
+    std::uint32_t assign = pos;
+    if (not accept(AslLexer::ASSIGN)) return nullptr;
+    AstNode *e = expr(BOOLEAN_LEVEL);
+    if (not e or not accept(AslLexer::SEMI)) return nullptr;
+    pending.push_back(e);
+    return node(AstKind::AssignStmt, assign, first, mark);
+  }
+  case AslLexer::IF: {
+    ++pos;
+    AstNode *e = expr(BOOLEAN_LEVEL);
+    if (not e or not accept(AslLexer::THEN)) return nullptr;
+    pending.push_back(e);
+    AstNode *thenStmts = statements();
+    if (not thenStmts) return nullptr;
+    pending.push_back(thenStmts);
+    if (accept(AslLexer::ELSE)) {
+      AstNode *elseStmts = statements();
+      if (not elseStmts) return nullptr;
+      pending.push_back(elseStmts);
+    }
+    if (not accept(AslLexer::ENDIF)) return nullptr;
+    return node(AstKind::IfStmt, first, first, mark);
+  }
+  case AslLexer::WHILE: {
+    ++pos;
+    AstNode *e = expr(BOOLEAN_LEVEL);
+    if (not e or not accept(AslLexer::DO)) return nullptr;
+    pending.push_back(e);
+    AstNode *body = statements();
+    if (not body or not accept(AslLexer::ENDWHILE)) return nullptr;
+    pending.push_back(body);
+    return node(AstKind::WhileStmt, first, first, mark);
+  }
+  case AslLexer::READ: {
+    ++pos;
+    AstNode *left = leftExpr();
+    if (not left or not accept(AslLexer::SEMI)) return nullptr;
+    pending.push_back(left);
+    return node(AstKind::ReadStmt, first, first, mark);
+  }
+  case AslLexer::WRITE: {
+    ++pos;
+    std::uint32_t str = pos;
+    if (accept(AslLexer::STRING)) {
+      if (not accept(AslLexer::SEMI)) return nullptr;
+      return node(AstKind::WriteString, str, first, mark);
+    }
+    AstNode *e = expr(BOOLEAN_LEVEL);
+    if (not e or not accept(AslLexer::SEMI)) return nullptr;
+    pending.push_back(e);
+    return node(AstKind::WriteExpr, first, first, mark);
+  }
+  case AslLexer::RETURN: {
+    ++pos;
+    if (not accept(AslLexer::SEMI)) {
+      AstNode *e = expr(BOOLEAN_LEVEL);
+      if (not e or not accept(AslLexer::SEMI)) return nullptr;
+      pending.push_back(e);
+    }
+    return node(AstKind::ReturnStmt, first, first, mark);
+  }
+  default:
+    return nullptr;
+  }
+}
+
+// functioncall : ident '(' ((expr ',')* expr)? ')'   # procCall
+AstNode * AslRecursiveParser::procCall() {
+  std::uint32_t first = pos;
+  std::size_t mark = pending.size();
+  AstNode *id = ident();
+  if (not id or not accept(AslLexer::LPAREN)) return nullptr;
+  pending.push_back(id);
+  if (la() != AslLexer::RPAREN) {
+    do {
+      AstNode *arg = expr(BOOLEAN_LEVEL);
+      if (not arg) return nullptr;
+      pending.push_back(arg);
+    } while (accept(AslLexer::COMMA));
+  }
+  if (not accept(AslLexer::RPAREN)) return nullptr;
+  return node(AstKind::ProcCall, first, first, mark);
+}
+
+// array_access : ident '[' expr ']'
+AstNode * AslRecursiveParser::arrayAccess() {
+  std::uint32_t first = pos;
+  std::size_t mark = pending.size();
+  AstNode *id = ident();
+  if (not id or not accept(AslLexer::LCLAU)) return nullptr;
+  pending.push_back(id);
+  AstNode *index = expr(BOOLEAN_LEVEL);
+  if (not index or not accept(AslLexer::RCLAU)) return nullptr;
+  pending.push_back(index);
+  return node(AstKind::ArrayAccess, first, first, mark);
+}
+
+// left_expr : array_access   # indexArrayLeftExpr
+//           | ident          # identifier
+AstNode * AslRecursiveParser::leftExpr() {
+  std::uint32_t first = pos;
+  std::size_t mark = pending.size();
+  bool indexed = la(1) == AslLexer::LCLAU;
+  AstNode *inner = indexed ? arrayAccess() : ident();
+  if (not inner) return nullptr;
+  pending.push_back(inner);
+  return node(indexed ? AstKind::IndexArrayLeftExpr : AstKind::Identifier, first, first, mark);
+}
+
+// ident : ID
+AstNode * AslRecursiveParser::ident() {
+  std::uint32_t id = pos;
+  if (not accept(AslLexer::ID)) return nullptr;
+  return ast->newNode(AstKind::Ident, id, id);
+}
+
+// expr : ... | expr op expr  (the binary alternatives, left associative)
+AstNode * AslRecursiveParser::expr(int level) {
+  AstNode *left = primary();
+  if (not left) return nullptr;
+  for (;;) {
+    int opLevel = binaryLevel(la());
+    if (opLevel == 0 or opLevel < level) break;
+    std::uint32_t op = pos++;
+    AstNode *right = expr(opLevel + 1);
+    if (not right) return nullptr;
+    std::size_t mark = pending.size();
+    pending.push_back(left);
+    pending.push_back(right);
+    left = node(binaryKind(opLevel), op, left->first, mark);
+  }
+  return left;
+}
+
+// expr : '(' expr ')'                # parenthesis
+//      | functioncall                # functionAsExpr
+//      | array_access                # indexArrayExpr
+//      | (NOT|PLUS|SUB) expr         # unary
+//      | INTVAL | FLOATVAL | CHARS | (TRUE|FALSE)
+//      | ident                       # exprIdent
+AstNode * AslRecursiveParser::primary() {
+  std::uint32_t first = pos;
+  std::size_t mark = pending.size();
+  AstNode *inner = nullptr;
+  AstKind kind;
+  switch (la()) {
+  case AslLexer::LPAREN:
+    ++pos;
+    inner = expr(BOOLEAN_LEVEL);
+    if (not inner or not accept(AslLexer::RPAREN)) return nullptr;
+    kind = AstKind::Parenthesis;
+    break;
+  case AslLexer::NOT: case AslLexer::PLUS: case AslLexer::SUB:
+    // the operand of a prefix operator binds tighter than any binary one
+    ++pos;
+    inner = expr(UNARY_LEVEL);
+    if (not inner) return nullptr;
+    kind = AstKind::Unary;
+    break;
+  case AslLexer::INTVAL:
+    ++pos;
+    return node(AstKind::Integervalue, first, first, mark);
+  case AslLexer::FLOATVAL:
+    ++pos;
+    return node(AstKind::Floatvalue, first, first, mark);
+  case AslLexer::CHARS:
+    ++pos;
+    return node(AstKind::Char, first, first, mark);
+  case AslLexer::TRUE: case AslLexer::FALSE:
+    ++pos;
+    return node(AstKind::Booleanvalue, first, first, mark);
+  case AslLexer::ID:
+    if (la(1) == AslLexer::LPAREN) {
+      inner = procCall();
+      kind = AstKind::FunctionAsExpr;
+    }
+    else if (la(1) == AslLexer::LCLAU) {
+      inner = arrayAccess();
+      kind = AstKind::IndexArrayExpr;
+    }
+    else {
+      inner = ident();
+      kind = AstKind::ExprIdent;
+    }
+    if (not inner) return nullptr;
+    break;
+  default:
+    return nullptr;
+  }
+  pending.push_back(inner);
+  return node(kind, first, first, mark);
+}
@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslRecursiveParser - Hand-written recursive descent parser
+//                         that builds the AST of an Asl program
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AslAst.h"
+#include "AslFastLexer.h"
+
+#include "../common/bytestream.h"
+
+#include <vector>
+
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uint32_t
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Class AslRecursiveParser: parses the language of Asl.g4 without
+// the ANTLR runtime. The tokens are got from an AslFastLexer, and
+// each rule of the grammar is a method that looks at most two
+// tokens ahead; the expressions are parsed by precedence climbing,
+// with the same precedences and associativity that ANTLR gives to
+// the alternatives of the left-recursive rule expr. The result is
+// an AslAst instead of a parse tree.
+// It does not report errors nor recover from them: if the source
+// has any lexical or syntactical error, parse fails, and the source
+// must be parsed by the AslParser to get its error messages.
+
+class AslRecursiveParser {
+
+public:
+
+  // Constructor
+  AslRecursiveParser(byteCharStream *input);
+
+  // Lexes and parses the whole input into 'ast'. Returns whether it
+  // is correct (if not, the AST must not be used)
+  bool parse(AslAst & ast);
+
+private:
+
+  // Attributes:
+  AslFastLexer           lexer;
+  AslAst               * ast;
+  // index of the next token
+  std::uint32_t          pos;
+  // children of the nodes being parsed (each rule pushes the
+  // children of its node and takes them off when it is created)
+  std::vector<AstNode *> pending;
+
+  // Type of the token k positions ahead
+  std::size_t la(std::size_t k = 0) const;
+  // Consumes the next token if it is of the given type
+  bool accept(std::size_t type);
+  // Creates the node with the children pushed since 'mark'
+  AstNode * node(AstKind kind, std::uint32_t token, std::uint32_t first,
+		 std::size_t mark);
+
+  // Rules of the grammar (they return nullptr on a syntax error)
+  AstNode * program();
+  AstNode * function();
+  AstNode * paramDecl();
+  AstNode * declarations();
+  AstNode * decl();
+  bool      type();
+  AstNode * statements();
+  AstNode * statement();
+  AstNode * procCall();
+  AstNode * arrayAccess();
+  AstNode * leftExpr();
+  AstNode * ident();
+  //   expression with binary operators of at least the given level
+  AstNode * expr(int level);
+  AstNode * primary();
+
+};  // class AslRecursiveParser
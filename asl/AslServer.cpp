@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslServer - Serves the compilations requested through a Unix
+//                socket (--server), see compileServer
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslServer.h"
+
+#include "antlr4-runtime.h"
+
+#include "../common/threadpool.h"
+#include "../common/compserver.h"
+
+#include <iostream>
+#include <cstdlib>    // EXIT_FAILURE, EXIT_SUCCESS
+#include <cstdio>     // sscanf
+
+// using namespace std;
+
+
+// Whether several threads can parse at the same time with their own
+// lexers and parsers. They share the DFA caches of the grammar, whose
+// states are read without a lock (while another thread may be adding
+// edges to them) in the ANTLR runtimes older than 4.10.
+static bool sharedDfaIsThreadSafe() {
+  int major = 0, minor = 0;
+  std::sscanf(antlr4::RuntimeMetaData::VERSION.c_str(), "%d.%d", &major, &minor);
+  return major > 4 or (major == 4 and minor >= 10);
+}
+
+int serveCompilations(const std::string & socketPath, std::size_t threads,
+		      const driverOptions & options) {
+  threadPool pool(threads);
+  if (pool.size() > 1 and not sharedDfaIsThreadSafe()) {
+    std::cerr << "ANTLR runtime " << antlr4::RuntimeMetaData::VERSION
+	      << " can not parse in several threads: serving with one" << std::endl;
+    return serveCompilations(socketPath, 1, options);
+  }
+  compileServer server(socketPath,
+		       [&options](const std::string & source, std::ostream & out) {
+			 // each worker keeps its tables from one request to the next
+			 static thread_local compilationTables tables;
+			 return compileSource(source.data(), source.size(), "",
+					      options, tables, out, out);
+		       });
+  std::string error;
+  if (not server.serve(pool, error)) {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslServer - Serves the compilations requested through a Unix
+//                socket (--server), see compileServer
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AslCompiler.h"
+
+#include <string>
+#include <cstddef>    // std::size_t
+
+// using namespace std;
+
+
+// Serves the compilations of the sources received through the Unix
+// socket <socketPath> (see compileServer) until it is asked to stop,
+// in 'threads' workers (one per core if 0). Each source is compiled to
+// t-code by a single worker, like with compileSource. The lexer and
+// parser DFA caches, shared by all the compilations, stay warm from
+// one request to the next, and each worker reuses its
+// compilationTables. If the ANTLR runtime can not parse in several
+// threads, the requests are served by a single worker.
+int serveCompilations(const std::string & socketPath, std::size_t threads,
+		      const driverOptions & options);
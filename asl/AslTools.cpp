@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslTools - Tools to look into the compiler: the disassembler of
+//               its object files and the listing of the tokens
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AslTools.h"
+#include "AslCompiler.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+#include "../common/atoms.h"
+#include "../common/code.h"
+#include "../common/objcode.h"
+#include "../common/bytestream.h"
+#include "AslFastLexer.h"
+
+#include <iostream>
+#include <memory>     // unique_ptr
+#include <cstdlib>    // EXIT_FAILURE, EXIT_SUCCESS
+
+// using namespace std;
+
+
+int disassemble(const std::string & objfile) {
+  objcode obj;
+  if (not obj.load(objfile)) {
+    std::cout << "Not a valid object file: " << objfile << std::endl;
+    return EXIT_FAILURE;
+  }
+  atomTable atoms;
+  code mycode(atoms);
+  obj.get_code(mycode);
+  return emitCode(mycode, "", std::cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int listTokens(const char *source, std::size_t size, bool fastLexer) {
+  std::unique_ptr<antlr4::CharStream> input;
+  byteCharStream *bytes = nullptr;
+  if (byteCharStream::fits(source, size))
+    input.reset(bytes = new byteCharStream(source, size));
+  else
+    input.reset(new antlr4::ANTLRInputStream(source, size));
+  AslLexer lexer(input.get());
+  lexer.removeErrorListeners();
+  std::unique_ptr<AslFastLexer> fast;
+  if (fastLexer and bytes) fast.reset(new AslFastLexer(bytes));
+  antlr4::TokenSource *tokens = fast ? static_cast<antlr4::TokenSource *>(fast.get()) : &lexer;
+  std::unique_ptr<antlr4::Token> token;
+  do {
+    token = tokens->nextToken();
+    std::cout << token->getType() << " " << long(token->getStartIndex()) << " "
+	      << long(token->getStopIndex()) << " " << token->getLine() << " "
+	      << token->getCharPositionInLine() << std::endl;
+  } while (token->getType() != antlr4::Token::EOF);
+  return EXIT_SUCCESS;
+}
+
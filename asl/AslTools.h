@@ -0,0 +1,47 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    AslTools - Tools to look into the compiler: the disassembler of
+//               its object files and the listing of the tokens
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <cstddef>    // std::size_t
+
+// using namespace std;
+
+
+// Prints the code of the object file <objfile> (written with -o) as
+// it would have been printed without -o, so both can be compared
+int disassemble(const std::string & objfile);
+
+// Prints the tokens of a source, one per line with its type, the
+// positions of its first and last characters, and its line and
+// column, up to the EOF. They are got from an AslFastLexer if
+// 'fastLexer' (and the source can be read in place), or else from an
+// AslLexer, so the outputs of both can be compared.
+int listTokens(const char *source, std::size_t size, bool fastLexer);
@@ -30,6 +30,7 @@
 #include "CodeGenListener.h"
 
 #include "antlr4-runtime.h"
+#include "AslAtomToken.h"
 
 #include "../common/TypesMgr.h"
 #include "../common/SymTable.h"
@@ -37,6 +38,7 @@
 #include "../common/code.h"
 
 #include <cstddef>    // std::size_t
+#include <utility>    // std::move
 
 // uncomment the following line to enable debugging messages with DEBUG*
 // #define DEBUG_BUILD
@@ -53,7 +55,9 @@ CodeGenListener::CodeGenListener(TypesMgr       & Types,
   Types{Types},
   Symbols{Symbols},
   Decorations{Decorations},
-  Code{Code} {
+  Code{Code},
+  Atoms{Code.get_atoms()},
+  Nodes{Code.get_memory()} {
 }
 
 void CodeGenListener::enterProgram(AslParser::ProgramContext *ctx) {
@@ -68,7 +72,7 @@ void CodeGenListener::exitProgram(AslParser::ProgramContext *ctx) {
 
 void CodeGenListener::enterFunction(AslParser::FunctionContext *ctx) {
   DEBUG_ENTER();
-  subroutine subr(ctx->ID()->getText());
+  subroutine subr(atomTextOf(ctx->ID()), Atoms);
   Code.add_subroutine(subr);
   SymTable::ScopeId sc = getScopeDecor(ctx);
   Symbols.pushThisScope(sc);
@@ -76,9 +80,7 @@ void CodeGenListener::enterFunction(AslParser::FunctionContext *ctx) {
 }
 void CodeGenListener::exitFunction(AslParser::FunctionContext *ctx) {
   subroutine & subrRef = Code.get_last_subroutine();
-  instructionList code = getCodeDecor(ctx->statements());
-
-  std::string ident = ctx->ID()->getText();
+  instructionList code = takeCodeDecor(ctx->statements());
 
   TypesMgr::TypeId t = getTypeDecor(ctx); 
 
@@ -91,15 +93,16 @@ void CodeGenListener::exitFunction(AslParser::FunctionContext *ctx) {
     AslParser::ArrayParamDeclContext* arraydeclaration = dynamic_cast<AslParser::ArrayParamDeclContext*>(decl); 
 
     if (basicdeclaration) {
-        subrRef.add_param(basicdeclaration->ID()->getText()); 
+        subrRef.add_param(atomTextOf(basicdeclaration->ID())); 
     }
     else if (arraydeclaration) {
-        subrRef.add_param(arraydeclaration->ID()->getText()); 
+        subrRef.add_param(atomTextOf(arraydeclaration->ID())); 
     }
  } 
 
-  code = code || instruction::RETURN();
+  code = std::move(code) || instruction::RETURN();
   subrRef.set_instructions(code);
+  Code.flush_last_subroutine();
   Symbols.popScope();
   DEBUG_EXIT();
 }
@@ -134,7 +137,7 @@ void CodeGenListener::exitBasicDecl(AslParser::BasicDeclContext *ctx) {
   std::size_t           size = Types.getSizeOfType(t1);
  
   for (auto identifier : ctx->ID()) {
-    subrRef.add_var(identifier->getText(), size); //Añadir variable a la subrutina
+    subrRef.add_var(atomTextOf(identifier), size); //Añadir variable a la subrutina
   } 
 
   DEBUG_EXIT();
@@ -151,7 +154,7 @@ void CodeGenListener::exitArrayDecl(AslParser::ArrayDeclContext *ctx) {
   for (auto identifier : ctx->ident()) {
     TypesMgr::TypeId        t1 = getTypeDecor(identifier);
     std::size_t           size = Types.getSizeOfType(t1);
-    subrRef.add_var(identifier->getText(), size); //Añadir variable a la subrutina
+    subrRef.add_var(atomTextOf(identifier->ID()), size); //Añadir variable a la subrutina
   }
 
  DEBUG_EXIT();
@@ -162,9 +165,10 @@ void CodeGenListener::enterIndexArrayLeftExpr(AslParser::IndexArrayLeftExprConte
 }
   
 void CodeGenListener::exitIndexArrayLeftExpr(AslParser::IndexArrayLeftExprContext *ctx) {
+  putSymbolDecor(ctx, getSymbolDecor(ctx->array_access()));
   putAddrDecor(ctx, getAddrDecor(ctx->array_access()));
   putOffsetDecor(ctx, getOffsetDecor(ctx->array_access()));
-  putCodeDecor(ctx, getCodeDecor(ctx->array_access()));
+  putCodeDecor(ctx, takeCodeDecor(ctx->array_access()));
   DEBUG_EXIT();
 }
 
@@ -173,24 +177,24 @@ void CodeGenListener::enterIndexArrayExpr(AslParser::IndexArrayExprContext *ctx)
 }
   
 void CodeGenListener::exitIndexArrayExpr(AslParser::IndexArrayExprContext *ctx) {
-  std::string addr     = getAddrDecor(ctx->array_access());
-  std::string offs     = getOffsetDecor(ctx->array_access());
-  instructionList code = getCodeDecor(ctx->array_access());
+  atomTable::atom addr = getAddrDecor(ctx->array_access());
+  atomTable::atom offs = getOffsetDecor(ctx->array_access());
+  instructionList code = takeCodeDecor(ctx->array_access());
 
-  std::string temp1 = "%"+codeCounters.newTEMP();
+  atomTable::atom temp1 = newTemp();
 
-  if (Symbols.isParameterClass(addr)) {
-    std::string temp2 = "%"+codeCounters.newTEMP();
-    code = code || instruction::LOAD(temp1, addr) || instruction::LOADX(temp2, temp1, offs);
+  if (getSymbolDecor(ctx->array_access()).isParameterClass()) {
+    atomTable::atom temp2 = newTemp();
+    code = std::move(code) || instruction::LOAD(temp1, addr) || instruction::LOADX(temp2, temp1, offs);
     putAddrDecor(ctx, temp2);
   } 
   else {
-    code = code || instruction::LOADX(temp1, addr, offs);
+    code = std::move(code) || instruction::LOADX(temp1, addr, offs);
     putAddrDecor(ctx, temp1);
   }
 
   putOffsetDecor(ctx, offs);
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
 
   DEBUG_EXIT();
 }
@@ -202,12 +206,13 @@ void CodeGenListener::enterArray_access(AslParser::Array_accessContext *ctx) {
 void CodeGenListener::exitArray_access(AslParser::Array_accessContext *ctx) {
   //What you have to do is to populate the offset ([thisnumber]),
   //but the code will be empty. 
-  std::string offset = getAddrDecor(ctx->expr());
-  instructionList code = getCodeDecor(ctx->expr());
+  atomTable::atom offset = getAddrDecor(ctx->expr());
+  instructionList code = takeCodeDecor(ctx->expr());
 
-  putAddrDecor(ctx, ctx->ident()->ID()->getText());
+  putSymbolDecor(ctx, getSymbolDecor(ctx->ident()));
+  putAddrDecor(ctx, atomOf(ctx->ident()->ID()));
   putOffsetDecor(ctx, offset);
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -224,9 +229,9 @@ void CodeGenListener::enterStatements(AslParser::StatementsContext *ctx) {
 void CodeGenListener::exitStatements(AslParser::StatementsContext *ctx) {
   instructionList code;
   for (auto stCtx : ctx->statement()) {
-    code = code || getCodeDecor(stCtx);
+    code = std::move(code) || takeCodeDecor(stCtx);
   }
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -235,23 +240,22 @@ void CodeGenListener::enterAssignStmt(AslParser::AssignStmtContext *ctx) {
 }
 void CodeGenListener::exitAssignStmt(AslParser::AssignStmtContext *ctx) {
   instructionList  code;
-  std::string     addr1 = getAddrDecor(ctx->left_expr());
-  std::string     offs1 = getOffsetDecor(ctx->left_expr());
-  instructionList code1 = getCodeDecor(ctx->left_expr());
+  atomTable::atom addr1 = getAddrDecor(ctx->left_expr());
+  atomTable::atom offs1 = getOffsetDecor(ctx->left_expr());
+  instructionList code1 = takeCodeDecor(ctx->left_expr());
   TypesMgr::TypeId tid1 = getTypeDecor(ctx->left_expr());
-  std::string     addr2 = getAddrDecor(ctx->expr());
-  std::string     offs2 = getOffsetDecor(ctx->expr());
-  instructionList code2 = getCodeDecor(ctx->expr());
+  atomTable::atom addr2 = getAddrDecor(ctx->expr());
+  instructionList code2 = takeCodeDecor(ctx->expr());
   TypesMgr::TypeId tid2 = getTypeDecor(ctx->expr());
 
-  if (offs1 != "") { //Is an array access!
-    std::string temp1 = "%"+codeCounters.newTEMP();
+  if (offs1 != atomTable::EMPTY) { //Is an array access!
+    atomTable::atom temp1 = newTemp();
     	  
-    if (Symbols.isParameterClass(addr1)) {
-      code = code1 || code2 || instruction::LOAD(temp1, addr1) || instruction::XLOAD(temp1, offs1, addr2);
+    if (getSymbolDecor(ctx->left_expr()).isParameterClass()) {
+      code = std::move(code1) || std::move(code2) || instruction::LOAD(temp1, addr1) || instruction::XLOAD(temp1, offs1, addr2);
     } 
     else {
-      code = code1 || code2 || instruction::XLOAD(addr1, offs1, addr2);
+      code = std::move(code1) || std::move(code2) || instruction::XLOAD(addr1, offs1, addr2);
     }
   }
   else {
@@ -262,38 +266,38 @@ void CodeGenListener::exitAssignStmt(AslParser::AssignStmtContext *ctx) {
  	instructionList copy;	
 	int array_size = Types.getArraySize(tid1);
 	
-    	std::string temp1 = "%"+codeCounters.newTEMP();
-    	std::string temp2 = "%"+codeCounters.newTEMP();
+    	atomTable::atom temp1 = newTemp();
+    	atomTable::atom temp2 = newTemp();
 
 	//Take into account that you can be using parameters here, so 
 	//probably you will have to use a temporal in between to use
 	//the base address of the array.
-	std::string aux1 = addr1;
-	std::string aux2 = addr2;
+	atomTable::atom aux1 = addr1;
+	atomTable::atom aux2 = addr2;
 
-	if (Symbols.isParameterClass(addr1)) {
-	  aux1 = "%"+codeCounters.newTEMP();
+	if (getSymbolDecor(ctx->left_expr()).isParameterClass()) {
+	  aux1 = newTemp();
 	  copy = instruction::LOAD(aux1, addr1);
 	}  
 
-	if (Symbols.isParameterClass(addr2)) {
-	  aux2 = "%"+codeCounters.newTEMP();
+	if (getSymbolDecor(ctx->expr()).isParameterClass()) {
+	  aux2 = newTemp();
 	  copy = instruction::LOAD(aux2, addr2);
 	}  
 
 	for (int i = 0; i < array_size; ++i) {
-	  copy = copy || instruction::ILOAD(temp1, std::to_string(i)) 	||
+	  copy = std::move(copy) || instruction::ILOAD(temp1, Atoms.intern(std::to_string(i))) 	||
  			 instruction::LOADX(temp2, aux2, temp1) 	|| 
 			 instruction::XLOAD(aux1, temp1, temp2);
 	}
-	code = code1 || code2 || copy;
+	code = std::move(code1) || std::move(code2) || std::move(copy);
     }
     else {
-      code = code1 || code2 || instruction::LOAD(addr1, addr2);
+      code = std::move(code1) || std::move(code2) || instruction::LOAD(addr1, addr2);
     }
   }
 
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -303,26 +307,26 @@ void CodeGenListener::enterIfStmt(AslParser::IfStmtContext *ctx) {
 
 void CodeGenListener::exitIfStmt(AslParser::IfStmtContext *ctx) {
   instructionList   code;
-  std::string      addr1 = getAddrDecor(ctx->expr());
-  instructionList  code1 = getCodeDecor(ctx->expr());
-  instructionList  code2 = getCodeDecor(ctx->statements(0));
-  std::string      label = codeCounters.newLabelIF();
+  atomTable::atom  addr1 = getAddrDecor(ctx->expr());
+  instructionList  code1 = takeCodeDecor(ctx->expr());
+  instructionList  code2 = takeCodeDecor(ctx->statements(0));
+  int              label = codeCounters.newLabelIF();
 
   if (ctx->statements(1)) {
     //else 
-    std::string labelElse = "else"+label;
-    instructionList code3 = getCodeDecor(ctx->statements(1));
-    code = code1 || instruction::FJUMP(addr1, labelElse) ||
-           code2 || instruction::LABEL(labelElse)        || 
-           code3;
+    atomTable::atom labelElse = counters::label(Atoms, "else", label);
+    instructionList code3 = takeCodeDecor(ctx->statements(1));
+    code = std::move(code1) || instruction::FJUMP(addr1, labelElse) ||
+           std::move(code2) || instruction::LABEL(labelElse)        || 
+           std::move(code3);
   }
   else {
-    std::string labelEndIf = "endif"+label;
-    code = code1 || instruction::FJUMP(addr1, labelEndIf) ||
-           code2 || instruction::LABEL(labelEndIf);
+    atomTable::atom labelEndIf = counters::label(Atoms, "endif", label);
+    code = std::move(code1) || instruction::FJUMP(addr1, labelEndIf) ||
+           std::move(code2) || instruction::LABEL(labelEndIf);
   }
 
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -332,19 +336,19 @@ void CodeGenListener::enterWhileStmt(AslParser::WhileStmtContext *ctx) {
 
 void CodeGenListener::exitWhileStmt(AslParser::WhileStmtContext *ctx) {
   instructionList   code;
-  std::string      addr1 = getAddrDecor(ctx->expr());
-  instructionList  code1 = getCodeDecor(ctx->expr());
-  instructionList  code2 = getCodeDecor(ctx->statements());
-  std::string      label = codeCounters.newLabelWHILE();
-  std::string labelStartWhile = "startwhile"+label;
-  std::string labelEndWhile = "endwhile"+label;
+  atomTable::atom  addr1 = getAddrDecor(ctx->expr());
+  instructionList  code1 = takeCodeDecor(ctx->expr());
+  instructionList  code2 = takeCodeDecor(ctx->statements());
+  int              label = codeCounters.newLabelWHILE();
+  atomTable::atom labelStartWhile = counters::label(Atoms, "startwhile", label);
+  atomTable::atom labelEndWhile = counters::label(Atoms, "endwhile", label);
 
   code = instruction::LABEL(labelStartWhile)                || 
-         code1 || instruction::FJUMP(addr1, labelEndWhile)  ||
-         code2 || instruction::UJUMP(labelStartWhile)       ||
+         std::move(code1) || instruction::FJUMP(addr1, labelEndWhile)  ||
+         std::move(code2) || instruction::UJUMP(labelStartWhile)       ||
          instruction::LABEL(labelEndWhile);
 
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -353,20 +357,21 @@ void CodeGenListener::enterReturnStmt(AslParser::ReturnStmtContext *ctx) {
 }
 
 void CodeGenListener::exitReturnStmt(AslParser::ReturnStmtContext *ctx) {
-  std::string     addr1;
+  atomTable::atom addr1 = atomTable::EMPTY;
   instructionList code1;
 
   if (ctx->expr()) {
     addr1 = getAddrDecor(ctx->expr());
-    code1 = getCodeDecor(ctx->expr());
-    std::string temp = "%"+codeCounters.newTEMP();
+    code1 = takeCodeDecor(ctx->expr());
+    // (a temporal is taken and not used)
+    newTemp();
 
-    code1 = code1 || instruction::LOAD("_result", addr1); 
+    code1 = std::move(code1) || instruction::LOAD(Atoms.intern("_result"), addr1); 
   }
   
   putAddrDecor(ctx, addr1);
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code1);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code1));
   DEBUG_EXIT();
   
   DEBUG_EXIT();
@@ -379,7 +384,7 @@ void CodeGenListener::enterProcCall(AslParser::ProcCallContext *ctx) {
 void CodeGenListener::exitProcCall(AslParser::ProcCallContext *ctx) {
   instructionList code;
   // std::string name = ctx->ident()->ID()->getSymbol()->getText();
-  std::string name = ctx->ident()->getText();
+  atomTable::atom name = atomOf(ctx->ident()->ID());
 
   TypesMgr::TypeId t = getTypeDecor(ctx->ident());
    
@@ -390,11 +395,11 @@ void CodeGenListener::exitProcCall(AslParser::ProcCallContext *ctx) {
  TypesMgr::TypeId function_type = getTypeDecor(ctx);
  
  int i = 0;
- std::string temp;
+ atomTable::atom temp = atomTable::EMPTY;
  
  for (auto param : ctx->expr()) {
-    std::string addr =          getAddrDecor(param);
-    instructionList paramcode = getCodeDecor(param); 
+    atomTable::atom addr =          getAddrDecor(param);
+    instructionList paramcode = takeCodeDecor(param); 
     
     instructionList conversioncode;
     TypesMgr::TypeId originalparam_type = Types.getParameterType(function_type, i);
@@ -404,31 +409,30 @@ void CodeGenListener::exitProcCall(AslParser::ProcCallContext *ctx) {
     }
 
     if (Types.isArrayTy(originalparam_type)) {
-        temp = "%"+codeCounters.newTEMP();
-        paramcode = paramcode || instruction::ALOAD(temp, addr);
+        temp = newTemp();
+        paramcode = std::move(paramcode) || instruction::ALOAD(temp, addr);
         addr = temp;
     }
 
-    code = code || paramcode || conversioncode || instruction::PUSH(addr);
+    code = std::move(code) || std::move(paramcode) || std::move(conversioncode) || instruction::PUSH(addr);
     //TODO Surely we have to do some conversions...
     i++;
   }
 
-  code = code || instruction::CALL(name);
+  code = std::move(code) || instruction::CALL(name);
 
-  for (auto param : ctx->expr()) {
-    std::string addr = getAddrDecor(param);
-    code = code || instruction::POP();
+  for (std::size_t n = ctx->expr().size(); n > 0; --n) {
+    code = std::move(code) || instruction::POP();
   }
   
-  temp = "";
+  temp = atomTable::EMPTY;
   if (not Types.isVoidFunction(t)) {
-    temp = "%"+codeCounters.newTEMP();
-    code = code || instruction::POP(temp);
+    temp = newTemp();
+    code = std::move(code) || instruction::POP(temp);
   }
   
   putAddrDecor(ctx, temp);
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -437,37 +441,37 @@ void CodeGenListener::enterReadStmt(AslParser::ReadStmtContext *ctx) {
 }
 void CodeGenListener::exitReadStmt(AslParser::ReadStmtContext *ctx) {
   instructionList  code;
-  std::string     addr1 = getAddrDecor(ctx->left_expr());
-  std::string     offs1 = getOffsetDecor(ctx->left_expr());
-  instructionList code1 = getCodeDecor(ctx->left_expr());
+  atomTable::atom addr1 = getAddrDecor(ctx->left_expr());
+  atomTable::atom offs1 = getOffsetDecor(ctx->left_expr());
+  instructionList code1 = takeCodeDecor(ctx->left_expr());
   TypesMgr::TypeId tid1 = getTypeDecor(ctx->left_expr());
 
-  std::string address;
+  atomTable::atom address;
 
-  if (offs1 != "") {
+  if (offs1 != atomTable::EMPTY) {
     //Array access
-    address = "%"+codeCounters.newTEMP();
+    address = newTemp();
   }
   else {
     address = addr1;
   }
 
   if (Types.isCharacterTy(tid1)) {
-    code = code1 || instruction::READC(address);
+    code = std::move(code1) || instruction::READC(address);
   }
   else if (Types.isFloatTy(tid1)) {
-    code = code1 || instruction::READF(address);
+    code = std::move(code1) || instruction::READF(address);
   }
   else {
-    code = code1 || instruction::READI(address);
+    code = std::move(code1) || instruction::READI(address);
   }
 
-  if (offs1 != "") {
-    code = code || instruction::XLOAD(addr1, offs1, address);
+  if (offs1 != atomTable::EMPTY) {
+    code = std::move(code) || instruction::XLOAD(addr1, offs1, address);
   }
 
   putOffsetDecor(ctx, offs1);
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -477,14 +481,14 @@ void CodeGenListener::enterChar(AslParser::CharContext *ctx) {
 
 void CodeGenListener::exitChar(AslParser::CharContext *ctx) {
   instructionList code;
-  std::string s = ctx->CHARS()->getText();
-  std::string temp = "%"+codeCounters.newTEMP();
+  const std::string & s = atomTextOf(ctx->CHARS());
+  atomTable::atom temp = newTemp();
   
-  code = instruction::CHLOAD(temp, s.substr(1, s.size()-2)); 
+  code = instruction::CHLOAD(temp, Atoms.intern(s.data()+1, s.size()-2)); 
  
   putAddrDecor(ctx, temp);	  
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code));
 
   DEBUG_EXIT();	
 }
@@ -494,24 +498,24 @@ void CodeGenListener::enterWriteExpr(AslParser::WriteExprContext *ctx) {
 }
 void CodeGenListener::exitWriteExpr(AslParser::WriteExprContext *ctx) {
   instructionList code;
-  std::string     addr1 = getAddrDecor(ctx->expr());
-  std::string     offs1 = getOffsetDecor(ctx->expr());
-  instructionList code1 = getCodeDecor(ctx->expr());
+  atomTable::atom addr1 = getAddrDecor(ctx->expr());
+  atomTable::atom offs1 = getOffsetDecor(ctx->expr());
+  instructionList code1 = takeCodeDecor(ctx->expr());
   
   TypesMgr::TypeId tid1 = getTypeDecor(ctx->expr());
 
   if (Types.isCharacterTy(tid1)) { 
-    code = code1 || instruction::WRITEC(addr1);
+    code = std::move(code1) || instruction::WRITEC(addr1);
   }
   else if (Types.isFloatTy(tid1)) {
-    code = code1 || instruction::WRITEF(addr1);
+    code = std::move(code1) || instruction::WRITEF(addr1);
   }
   else {
-    code = code1 || instruction::WRITEI(addr1);
+    code = std::move(code1) || instruction::WRITEI(addr1);
   }
 
   putOffsetDecor(ctx, offs1);
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -520,38 +524,38 @@ void CodeGenListener::enterWriteString(AslParser::WriteStringContext *ctx) {
 }
 void CodeGenListener::exitWriteString(AslParser::WriteStringContext *ctx) {
   instructionList code;
-  std::string s = ctx->STRING()->getText();
-  std::string temp = "%"+codeCounters.newTEMP();
+  const std::string & s = atomTextOf(ctx->STRING());
+  atomTable::atom temp = newTemp();
   int i = 1;
   while (i < int(s.size())-1) {
     if (s[i] != '\\') {
-      code = code ||
-	     instruction::CHLOAD(temp, s.substr(i,1)) ||
+      code = std::move(code) ||
+	     instruction::CHLOAD(temp, Atoms.intern(s.data()+i, 1)) ||
 	     instruction::WRITEC(temp);
       i += 1;
     }
     else {
       assert(i < int(s.size())-2);
       if (s[i+1] == 'n') {
-        code = code || instruction::WRITELN();
+        code = std::move(code) || instruction::WRITELN();
         i += 2;
       }
       else if (s[i+1] == 't' or s[i+1] == '"' or s[i+1] == '\\') {
-        code = code ||
-               instruction::CHLOAD(temp, s.substr(i,2)) ||
+        code = std::move(code) ||
+               instruction::CHLOAD(temp, Atoms.intern(s.data()+i, 2)) ||
 	       instruction::WRITEC(temp);
         i += 2;
       }
       else {
-        code = code ||
-               instruction::CHLOAD(temp, s.substr(i,1)) ||
+        code = std::move(code) ||
+               instruction::CHLOAD(temp, Atoms.intern(s.data()+i, 1)) ||
 	       instruction::WRITEC(temp);
         i += 1;
       }
     }
   }
 
-  putCodeDecor(ctx, code);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 /*
@@ -561,7 +565,7 @@ void CodeGenListener::enterLeft_expr(AslParser::Left_exprContext *ctx) {
 void CodeGenListener::exitLeft_expr(AslParser::Left_exprContext *ctx) {
   putAddrDecor(ctx, getAddrDecor(ctx->ident()));
   putOffsetDecor(ctx, getOffsetDecor(ctx->ident()));
-  putCodeDecor(ctx, getCodeDecor(ctx->ident()));
+  putCodeDecor(ctx, takeCodeDecor(ctx->ident()));
   DEBUG_ENTER();
 }
 */
@@ -569,11 +573,11 @@ void CodeGenListener::enterArithmetic(AslParser::ArithmeticContext *ctx) {
   DEBUG_ENTER();
 }
 void CodeGenListener::exitArithmetic(AslParser::ArithmeticContext *ctx) {
-  std::string     addr1 = getAddrDecor(ctx->expr(0));
-  instructionList code1 = getCodeDecor(ctx->expr(0));
-  std::string     addr2 = getAddrDecor(ctx->expr(1));
-  instructionList code2 = getCodeDecor(ctx->expr(1));
-  instructionList code  = code1 || code2;
+  atomTable::atom addr1 = getAddrDecor(ctx->expr(0));
+  instructionList code1 = takeCodeDecor(ctx->expr(0));
+  atomTable::atom addr2 = getAddrDecor(ctx->expr(1));
+  instructionList code2 = takeCodeDecor(ctx->expr(1));
+  instructionList code  = std::move(code1) || std::move(code2);
   
   TypesMgr::TypeId t1 = getTypeDecor(ctx->expr(0));
   TypesMgr::TypeId t2 = getTypeDecor(ctx->expr(1));
@@ -583,55 +587,55 @@ void CodeGenListener::exitArithmetic(AslParser::ArithmeticContext *ctx) {
   //Here we are doing an operation such as t1 OP t2 = t 
   //if t is of some type t, the operation must be of that type.
 
-  std::string temp = "%"+codeCounters.newTEMP();
+  atomTable::atom temp = newTemp();
   if (not Types.isFloatTy(t)) {
     if (ctx->MUL())
-      code = code || instruction::MUL(temp, addr1, addr2);
+      code = std::move(code) || instruction::MUL(temp, addr1, addr2);
     else if (ctx->PLUS())
-      code = code || instruction::ADD(temp, addr1, addr2);
+      code = std::move(code) || instruction::ADD(temp, addr1, addr2);
     else if (ctx->DIV())
-      code = code || instruction::DIV(temp, addr1, addr2);
+      code = std::move(code) || instruction::DIV(temp, addr1, addr2);
     else if (ctx->MOD()) {	
-      code = code || instruction::DIV(temp, addr1, addr2);
-      code = code || instruction::MUL(temp, temp, addr2);
-      code = code || instruction::SUB(temp, addr1, temp);
+      code = std::move(code) || instruction::DIV(temp, addr1, addr2);
+      code = std::move(code) || instruction::MUL(temp, temp, addr2);
+      code = std::move(code) || instruction::SUB(temp, addr1, temp);
       //TODO Must be checked someday
     }
     else if (ctx->SUB())
-      code = code || instruction::SUB(temp, addr1, addr2);
+      code = std::move(code) || instruction::SUB(temp, addr1, addr2);
   }
   else {
 
     //I reuse the temporal
 
     if (Types.isIntegerTy(t1)) {
-       code = code || instruction::FLOAT(temp, addr1);
+       code = std::move(code) || instruction::FLOAT(temp, addr1);
        addr1 = temp;
     }  
     
     if (Types.isIntegerTy(t2)) {
-       code = code || instruction::FLOAT(temp, addr2);
+       code = std::move(code) || instruction::FLOAT(temp, addr2);
        addr2 = temp;
     }  
 
     if (ctx->MUL())
-      code = code || instruction::FMUL(temp, addr1, addr2);
+      code = std::move(code) || instruction::FMUL(temp, addr1, addr2);
     else if (ctx->PLUS())
-      code = code || instruction::FADD(temp, addr1, addr2);
+      code = std::move(code) || instruction::FADD(temp, addr1, addr2);
     else if (ctx->DIV())
-      code = code || instruction::FDIV(temp, addr1, addr2);
+      code = std::move(code) || instruction::FDIV(temp, addr1, addr2);
     else if (ctx->MOD()) {	
-      code = code || instruction::FDIV(temp, addr1, addr2);
-      code = code || instruction::FMUL(temp, temp, addr2);
-      code = code || instruction::FSUB(temp, addr1, temp);
+      code = std::move(code) || instruction::FDIV(temp, addr1, addr2);
+      code = std::move(code) || instruction::FMUL(temp, temp, addr2);
+      code = std::move(code) || instruction::FSUB(temp, addr1, temp);
       //TODO Must be checked someday
     }
     else if (ctx->SUB())
-      code = code || instruction::FSUB(temp, addr1, addr2);
+      code = std::move(code) || instruction::FSUB(temp, addr1, addr2);
   }
   putAddrDecor(ctx, temp);
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
   
@@ -640,9 +644,10 @@ void CodeGenListener::enterParenthesis(AslParser::ParenthesisContext *ctx) {
 }
   
 void CodeGenListener::exitParenthesis(AslParser::ParenthesisContext *ctx) {
+  putSymbolDecor(ctx, getSymbolDecor(ctx->expr()));
   putAddrDecor(ctx, getAddrDecor(ctx->expr()));
   putOffsetDecor(ctx, getOffsetDecor(ctx->expr()));
-  putCodeDecor(ctx, getCodeDecor(ctx->expr()));
+  putCodeDecor(ctx, takeCodeDecor(ctx->expr()));
   DEBUG_EXIT();
 }
 
@@ -650,39 +655,39 @@ void CodeGenListener::enterRelational(AslParser::RelationalContext *ctx) {
   DEBUG_ENTER();
 }
 void CodeGenListener::exitRelational(AslParser::RelationalContext *ctx) {
-  std::string     addr1 = getAddrDecor(ctx->expr(0));
-  instructionList code1 = getCodeDecor(ctx->expr(0));
-  std::string     addr2 = getAddrDecor(ctx->expr(1));
-  instructionList code2 = getCodeDecor(ctx->expr(1));
-  instructionList code  = code1 || code2;
+  atomTable::atom addr1 = getAddrDecor(ctx->expr(0));
+  instructionList code1 = takeCodeDecor(ctx->expr(0));
+  atomTable::atom addr2 = getAddrDecor(ctx->expr(1));
+  instructionList code2 = takeCodeDecor(ctx->expr(1));
+  instructionList code  = std::move(code1) || std::move(code2);
   // TypesMgr::TypeId t1 = getTypeDecor(ctx->expr(0));
   // TypesMgr::TypeId t2 = getTypeDecor(ctx->expr(1));
   // TypesMgr::TypeId t  = getTypeDecor(ctx);
-  std::string temp = "%"+codeCounters.newTEMP();
+  atomTable::atom temp = newTemp();
   if (ctx->EQUAL())
-    code = code || instruction::EQ(temp, addr1, addr2);
+    code = std::move(code) || instruction::EQ(temp, addr1, addr2);
   else if (ctx->DIFF()) {
-    code = code || instruction::EQ(temp, addr1, addr2);
-    code = code || instruction::NOT(temp, temp);
+    code = std::move(code) || instruction::EQ(temp, addr1, addr2);
+    code = std::move(code) || instruction::NOT(temp, temp);
   }
   else if (ctx->GTE()) {
-    code = code || instruction::LT(temp, addr1, addr2);    
-    code = code || instruction::NOT(temp, temp);    
+    code = std::move(code) || instruction::LT(temp, addr1, addr2);    
+    code = std::move(code) || instruction::NOT(temp, temp);    
   }
   else if (ctx->GT()) {
-    code = code || instruction::LE(temp, addr1, addr2);    
-    code = code || instruction::NOT(temp, temp);    
+    code = std::move(code) || instruction::LE(temp, addr1, addr2);    
+    code = std::move(code) || instruction::NOT(temp, temp);    
   }
   else if (ctx->LTE()) {
-    code = code || instruction::LE(temp, addr1, addr2);    
+    code = std::move(code) || instruction::LE(temp, addr1, addr2);    
   }
   else if (ctx->LT()) {
-    code = code || instruction::LT(temp, addr1, addr2);    
+    code = std::move(code) || instruction::LT(temp, addr1, addr2);    
   }
 
   putAddrDecor(ctx, temp);
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }  
   
@@ -691,30 +696,30 @@ void CodeGenListener::enterUnary(AslParser::UnaryContext *ctx) {
 }
    
 void CodeGenListener::exitUnary(AslParser::UnaryContext *ctx) {
-  std::string     addr1 = getAddrDecor(ctx->expr());
-  instructionList code1 = getCodeDecor(ctx->expr());
-  std::string temp = "%"+codeCounters.newTEMP();
+  atomTable::atom addr1 = getAddrDecor(ctx->expr());
+  instructionList code1 = takeCodeDecor(ctx->expr());
+  atomTable::atom temp = newTemp();
 
   TypesMgr::TypeId t_expr  = getTypeDecor(ctx->expr());
   
   if (ctx->NOT()) {
-    code1 = code1 || instruction::NOT(temp, addr1);
+    code1 = std::move(code1) || instruction::NOT(temp, addr1);
   }
 
   if (Types.isFloatTy(t_expr)) {
     if (ctx->SUB()) {
-      code1 = code1 || instruction::FSUB(temp, "", addr1);
+      code1 = std::move(code1) || instruction::FSUB(temp, atomTable::EMPTY, addr1);
     }
   }
   else {
     if (ctx->SUB()) {
-      code1 = code1 || instruction::SUB(temp, "", addr1);
+      code1 = std::move(code1) || instruction::SUB(temp, atomTable::EMPTY, addr1);
     }
   }
 
   putAddrDecor(ctx, temp);
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code1);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code1));
   DEBUG_EXIT();
 }
 
@@ -723,23 +728,23 @@ void CodeGenListener::enterBoolean(AslParser::BooleanContext* ctx) {
 }
 
 void CodeGenListener::exitBoolean(AslParser::BooleanContext *ctx) {
-  std::string     addr1 = getAddrDecor(ctx->expr(0));
-  instructionList code1 = getCodeDecor(ctx->expr(0));
-  std::string     addr2 = getAddrDecor(ctx->expr(1));
-  instructionList code2 = getCodeDecor(ctx->expr(1));
-  instructionList code  = code1 || code2;
-  std::string temp = "%"+codeCounters.newTEMP();
+  atomTable::atom addr1 = getAddrDecor(ctx->expr(0));
+  instructionList code1 = takeCodeDecor(ctx->expr(0));
+  atomTable::atom addr2 = getAddrDecor(ctx->expr(1));
+  instructionList code2 = takeCodeDecor(ctx->expr(1));
+  instructionList code  = std::move(code1) || std::move(code2);
+  atomTable::atom temp = newTemp();
 
   if (ctx->AND()) {
-    code = code || instruction::AND(temp, addr1, addr2);
+    code = std::move(code) || instruction::AND(temp, addr1, addr2);
   }
   else if (ctx->OR()) {
-    code = code || instruction::OR(temp, addr1, addr2);
+    code = std::move(code) || instruction::OR(temp, addr1, addr2);
   }
 
   putAddrDecor(ctx, temp);
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -750,13 +755,13 @@ void CodeGenListener::enterIntegervalue(AslParser::IntegervalueContext *ctx) {
 void CodeGenListener::exitIntegervalue(AslParser::IntegervalueContext *ctx) {
   instructionList code;
 
-  std::string ident = ctx->getText();
+  atomTable::atom ident = atomOf(ctx->INTVAL());
 
-  std::string temp = "%"+codeCounters.newTEMP();
+  atomTable::atom temp = newTemp();
   code = instruction::ILOAD(temp, ident);
   putAddrDecor(ctx, temp);
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -766,11 +771,11 @@ void CodeGenListener::enterFloatvalue(AslParser::FloatvalueContext *ctx) {
 
 void CodeGenListener::exitFloatvalue(AslParser::FloatvalueContext *ctx) {
   instructionList code;
-  std::string temp = "%"+codeCounters.newTEMP();
-  code = instruction::FLOAD(temp, ctx->getText());
+  atomTable::atom temp = newTemp();
+  code = instruction::FLOAD(temp, atomOf(ctx->FLOATVAL()));
   putAddrDecor(ctx, temp);
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -780,18 +785,18 @@ void CodeGenListener::enterBooleanvalue(AslParser::BooleanvalueContext *ctx) {
 
 void CodeGenListener::exitBooleanvalue(AslParser::BooleanvalueContext *ctx) {
   instructionList code;
-  std::string temp = "%"+codeCounters.newTEMP();
+  atomTable::atom temp = newTemp();
   std::string true_false = ctx->getText();
   if (true_false == "true") {
-    code = instruction::ILOAD(temp, "1");
+    code = instruction::ILOAD(temp, Atoms.intern("1"));
   }
   else if (true_false == "false") {
-    code = instruction::ILOAD(temp, "0");
+    code = instruction::ILOAD(temp, Atoms.intern("0"));
   }
 
   putAddrDecor(ctx, temp);
-  putOffsetDecor(ctx, "");
-  putCodeDecor(ctx, code);
+  putOffsetDecor(ctx, atomTable::EMPTY);
+  putCodeDecor(ctx, std::move(code));
   DEBUG_EXIT();
 }
 
@@ -800,9 +805,10 @@ void CodeGenListener::enterExprIdent(AslParser::ExprIdentContext *ctx) {
 }
 
 void CodeGenListener::exitExprIdent(AslParser::ExprIdentContext *ctx) {
+  putSymbolDecor(ctx, getSymbolDecor(ctx->ident()));
   putAddrDecor(ctx, getAddrDecor(ctx->ident()));
   putOffsetDecor(ctx, getOffsetDecor(ctx->ident()));
-  putCodeDecor(ctx, getCodeDecor(ctx->ident()));
+  putCodeDecor(ctx, takeCodeDecor(ctx->ident()));
   DEBUG_EXIT();
 }
 
@@ -810,8 +816,8 @@ void CodeGenListener::enterIdent(AslParser::IdentContext *ctx) {
   DEBUG_ENTER();
 }
 void CodeGenListener::exitIdent(AslParser::IdentContext *ctx) {
-  putAddrDecor(ctx, ctx->ID()->getText());
-  putOffsetDecor(ctx, "");
+  putAddrDecor(ctx, atomOf(ctx->ID()));
+  putOffsetDecor(ctx, atomTable::EMPTY);
   putCodeDecor(ctx, instructionList());
   DEBUG_EXIT();
 }
@@ -821,9 +827,10 @@ void CodeGenListener::enterIdentifier(AslParser::IdentifierContext *ctx) {
 }
 
 void CodeGenListener::exitIdentifier(AslParser::IdentifierContext *ctx) {
+  putSymbolDecor(ctx, getSymbolDecor(ctx->ident()));
   putAddrDecor(ctx, getAddrDecor(ctx->ident()));
   putOffsetDecor(ctx, getOffsetDecor(ctx->ident()));
-  putCodeDecor(ctx, getCodeDecor(ctx->ident()));
+  putCodeDecor(ctx, takeCodeDecor(ctx->ident()));
 
   DEBUG_EXIT();
 }
@@ -835,7 +842,7 @@ void CodeGenListener::enterFunctionAsExpr(AslParser::FunctionAsExprContext *ctx)
 void CodeGenListener::exitFunctionAsExpr(AslParser::FunctionAsExprContext *ctx) {
   putAddrDecor(ctx, getAddrDecor(ctx->functioncall()));
   putOffsetDecor(ctx, getOffsetDecor(ctx->functioncall()));
-  putCodeDecor(ctx, getCodeDecor(ctx->functioncall()));
+  putCodeDecor(ctx, takeCodeDecor(ctx->functioncall()));
   DEBUG_EXIT();
 }
 
@@ -855,7 +862,7 @@ void CodeGenListener::enterFuncStmt(AslParser::FuncStmtContext *ctx) {
 void CodeGenListener::exitFuncStmt(AslParser::FuncStmtContext *ctx) {
   putAddrDecor(ctx, getAddrDecor(ctx->functioncall()));
   putOffsetDecor(ctx, getOffsetDecor(ctx->functioncall()));
-  putCodeDecor(ctx, getCodeDecor(ctx->functioncall()));
+  putCodeDecor(ctx, takeCodeDecor(ctx->functioncall()));
   DEBUG_EXIT();
 }
 
@@ -873,31 +880,42 @@ void CodeGenListener::exitFuncStmt(AslParser::FuncStmtContext *ctx) {
 
 
 // Getters for the necessary tree node atributes:
-//   Scope, Type, Addr, Offset and Code
+//   Scope, Type, Symbol, Addr, Offset and Code
 SymTable::ScopeId CodeGenListener::getScopeDecor(antlr4::ParserRuleContext *ctx) {
   return Decorations.getScope(ctx);
 }
 TypesMgr::TypeId CodeGenListener::getTypeDecor(antlr4::ParserRuleContext *ctx) {
   return Decorations.getType(ctx);
 }
-std::string CodeGenListener::getAddrDecor(antlr4::ParserRuleContext *ctx) {
+SymTable::SymbolHandle CodeGenListener::getSymbolDecor(antlr4::ParserRuleContext *ctx) {
+  return Decorations.getSymbol(ctx);
+}
+atomTable::atom CodeGenListener::getAddrDecor(antlr4::ParserRuleContext *ctx) {
   return Decorations.getAddr(ctx);
 }
-std::string  CodeGenListener::getOffsetDecor(antlr4::ParserRuleContext *ctx) {
+atomTable::atom CodeGenListener::getOffsetDecor(antlr4::ParserRuleContext *ctx) {
   return Decorations.getOffset(ctx);
 }
-instructionList CodeGenListener::getCodeDecor(antlr4::ParserRuleContext *ctx) {
-  return Decorations.getCode(ctx);
+instructionList CodeGenListener::takeCodeDecor(antlr4::ParserRuleContext *ctx) {
+  return Decorations.takeCode(ctx);
 }
 
 // Setters for the necessary tree node attributes:
-//   Addr, Offset and Code
-void CodeGenListener::putAddrDecor(antlr4::ParserRuleContext *ctx, const std::string & a) {
+//   Symbol, Addr, Offset and Code
+void CodeGenListener::putSymbolDecor(antlr4::ParserRuleContext *ctx, const SymTable::SymbolHandle & s) {
+  Decorations.putSymbol(ctx, s);
+}
+void CodeGenListener::putAddrDecor(antlr4::ParserRuleContext *ctx, atomTable::atom a) {
   Decorations.putAddr(ctx, a);
 }
-void CodeGenListener::putOffsetDecor(antlr4::ParserRuleContext *ctx, const std::string & o) {
+void CodeGenListener::putOffsetDecor(antlr4::ParserRuleContext *ctx, atomTable::atom o) {
   Decorations.putOffset(ctx, o);
 }
-void CodeGenListener::putCodeDecor(antlr4::ParserRuleContext *ctx, const instructionList & c) {
-  Decorations.putCode(ctx, c);
+void CodeGenListener::putCodeDecor(antlr4::ParserRuleContext *ctx, instructionList && c) {
+  Decorations.putCode(ctx, std::move(c));
+}
+
+// New temporal (with its '%')
+atomTable::atom CodeGenListener::newTemp() {
+  return codeCounters.newTEMP(Atoms);
 }
@@ -181,20 +181,31 @@ private:
   SymTable        & Symbols;
   TreeDecoration  & Decorations;
   code            & Code;
+  // table of the atoms of the operands of the instructions of Code
+  // (the one of the tokens, or an extension of it)
+  atomTable       & Atoms;
   counters          codeCounters;
+  // while the listener is alive, the lists of instructions made by its
+  // thread take their nodes from the arena of the code
+  instructionList::useArena Nodes;
 
   // Getters for the necessary tree node atributes:
-  //   Scope, Type, Addr, Offset and Code
+  //   Scope, Type, Symbol, Addr, Offset and Code
   SymTable::ScopeId getScopeDecor  (antlr4::ParserRuleContext *ctx);
   TypesMgr::TypeId  getTypeDecor   (antlr4::ParserRuleContext *ctx);
-  std::string       getAddrDecor   (antlr4::ParserRuleContext *ctx);
-  std::string       getOffsetDecor (antlr4::ParserRuleContext *ctx);
-  instructionList   getCodeDecor   (antlr4::ParserRuleContext *ctx);
+  SymTable::SymbolHandle getSymbolDecor (antlr4::ParserRuleContext *ctx);
+  atomTable::atom   getAddrDecor   (antlr4::ParserRuleContext *ctx);
+  atomTable::atom   getOffsetDecor (antlr4::ParserRuleContext *ctx);
+  instructionList   takeCodeDecor  (antlr4::ParserRuleContext *ctx);
 
   // Setters for the necessary tree node attributes:
-  //   Addr, Offset and Code
-  void putAddrDecor   (antlr4::ParserRuleContext *ctx, const std::string & a);
-  void putOffsetDecor (antlr4::ParserRuleContext *ctx, const std::string & o);
-  void putCodeDecor   (antlr4::ParserRuleContext *ctx, const instructionList & c);
+  //   Symbol, Addr, Offset and Code
+  void putSymbolDecor (antlr4::ParserRuleContext *ctx, const SymTable::SymbolHandle & s);
+  void putAddrDecor   (antlr4::ParserRuleContext *ctx, atomTable::atom a);
+  void putOffsetDecor (antlr4::ParserRuleContext *ctx, atomTable::atom o);
+  void putCodeDecor   (antlr4::ParserRuleContext *ctx, instructionList && c);
+
+  // New temporal (with its '%')
+  atomTable::atom newTemp ();
 
 };
@@ -0,0 +1,487 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    CodeGenPass - Generates the code of a program, walking its
+//                  AST
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+
+#include "CodeGenPass.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/code.h"
+
+#include <cstddef>    // std::size_t
+#include <utility>    // std::move
+
+// using namespace std;
+
+
+// Constructor
+CodeGenPass::CodeGenPass(TypesMgr & Types,
+			 SymTable & Symbols,
+			 code     & Code) :
+  Types{Types},
+  Symbols{Symbols},
+  Code{Code},
+  Atoms{Code.get_atoms()},
+  Ast{nullptr} {
+}
+
+void CodeGenPass::walk(AslAst & ast) {
+  // the lists of instructions take their nodes from the arena of the code
+  instructionList::useArena nodes(Code.get_memory());
+  Ast = &ast;
+  AstNode *program = ast.root;
+  Symbols.pushThisScope(program->scope);
+  for (std::uint32_t i = 0; i < program->count; ++i) {
+    function(program->child[i]);
+  }
+  Symbols.popScope();
+}
+
+void CodeGenPass::function(AstNode *node) {
+  subroutine subr(Ast->atomText(node->token), Atoms);
+  Code.add_subroutine(subr);
+  Symbols.pushThisScope(node->scope);
+  codeCounters.reset();
+
+  // the code of the sizes of the arrays is not used, but it takes
+  // its temporals, like in the CodeGenListener
+  std::uint32_t numParams = node->count - 2;
+  for (std::uint32_t i = 0; i < numParams; ++i) {
+    AstNode *param = node->child[i];
+    if (param->kind == AstKind::ArrayParamDecl) expr(param->child[0]);
+  }
+  AstNode *decls = node->child[numParams];
+  for (std::uint32_t d = 0; d < decls->count; ++d) {
+    AstNode *decl = decls->child[d];
+    if (decl->kind == AstKind::BasicDecl) {
+      std::size_t size = Types.getSizeOfType(decl->type);
+      for (std::uint32_t id = decl->token; id + 1 < decl->aux; id += 2) {
+	Code.get_last_subroutine().add_var(Ast->atomText(id), size);
+      }
+    }
+    else {
+      expr(decl->child[decl->count - 1]);
+      for (std::uint32_t i = 0; i + 1 < decl->count; ++i) {
+	AstNode *ident = decl->child[i];
+	Code.get_last_subroutine().add_var(Ast->atomText(ident->token), Types.getSizeOfType(ident->type));
+      }
+    }
+  }
+  instructionList code = statements(node->child[numParams + 1]);
+
+  subroutine & subrRef = Code.get_last_subroutine();
+  if (not Types.isVoidFunction(node->type)) {
+    subrRef.add_param("_result");
+  }
+  for (std::uint32_t i = 0; i < numParams; ++i) {
+    subrRef.add_param(Ast->atomText(node->child[i]->token));
+  }
+  code = std::move(code) || instruction::RETURN();
+  subrRef.set_instructions(code);
+  Code.flush_last_subroutine();
+  Symbols.popScope();
+}
+
+instructionList CodeGenPass::statements(AstNode *node) {
+  instructionList code;
+  for (std::uint32_t i = 0; i < node->count; ++i) {
+    code = std::move(code) || statement(node->child[i]);
+  }
+  return code;
+}
+
+instructionList CodeGenPass::statement(AstNode *node) {
+  instructionList code;
+  switch (node->kind) {
+  case AstKind::AssignStmt: {
+    attributes left = expr(node->child[0]);
+    attributes right = expr(node->child[1]);
+    TypesMgr::TypeId tid1 = node->child[0]->type;
+    TypesMgr::TypeId tid2 = node->child[1]->type;
+    if (left.offs != atomTable::EMPTY) {
+      // array access
+      atomTable::atom temp1 = newTemp();
+      if (left.symbol.isParameterClass())
+	code = std::move(left.code) || std::move(right.code) ||
+	       instruction::LOAD(temp1, left.addr) || instruction::XLOAD(temp1, left.offs, right.addr);
+      else
+	code = std::move(left.code) || std::move(right.code) ||
+	       instruction::XLOAD(left.addr, left.offs, right.addr);
+    }
+    else if (Types.isArrayTy(tid1) and Types.isArrayTy(tid2)) {
+      // copy of the elements, through the base address of the
+      // parameters (the CodeGenListener keeps only the load of the
+      // last one, and so does this)
+      instructionList copy;
+      int array_size = Types.getArraySize(tid1);
+      atomTable::atom temp1 = newTemp();
+      atomTable::atom temp2 = newTemp();
+      atomTable::atom aux1 = left.addr;
+      atomTable::atom aux2 = right.addr;
+      if (left.symbol.isParameterClass()) {
+	aux1 = newTemp();
+	copy = instruction::LOAD(aux1, left.addr);
+      }
+      if (right.symbol.isParameterClass()) {
+	aux2 = newTemp();
+	copy = instruction::LOAD(aux2, right.addr);
+      }
+      for (int i = 0; i < array_size; ++i) {
+	copy = std::move(copy) || instruction::ILOAD(temp1, Atoms.intern(std::to_string(i))) ||
+	       instruction::LOADX(temp2, aux2, temp1) ||
+	       instruction::XLOAD(aux1, temp1, temp2);
+      }
+      code = std::move(left.code) || std::move(right.code) || std::move(copy);
+    }
+    else {
+      code = std::move(left.code) || std::move(right.code) ||
+	     instruction::LOAD(left.addr, right.addr);
+    }
+    break;
+  }
+  case AstKind::IfStmt: {
+    attributes cond = expr(node->child[0]);
+    instructionList code2 = statements(node->child[1]);
+    instructionList code3;
+    if (node->count > 2) code3 = statements(node->child[2]);
+    int label = codeCounters.newLabelIF();
+    if (node->count > 2) {
+      atomTable::atom labelElse = counters::label(Atoms, "else", label);
+      code = std::move(cond.code) || instruction::FJUMP(cond.addr, labelElse) ||
+	     std::move(code2) || instruction::LABEL(labelElse) ||
+	     std::move(code3);
+    }
+    else {
+      atomTable::atom labelEndIf = counters::label(Atoms, "endif", label);
+      code = std::move(cond.code) || instruction::FJUMP(cond.addr, labelEndIf) ||
+	     std::move(code2) || instruction::LABEL(labelEndIf);
+    }
+    break;
+  }
+  case AstKind::WhileStmt: {
+    attributes cond = expr(node->child[0]);
+    instructionList code2 = statements(node->child[1]);
+    int label = codeCounters.newLabelWHILE();
+    atomTable::atom labelStartWhile = counters::label(Atoms, "startwhile", label);
+    atomTable::atom labelEndWhile = counters::label(Atoms, "endwhile", label);
+    code = instruction::LABEL(labelStartWhile) ||
+	   std::move(cond.code) || instruction::FJUMP(cond.addr, labelEndWhile) ||
+	   std::move(code2) || instruction::UJUMP(labelStartWhile) ||
+	   instruction::LABEL(labelEndWhile);
+    break;
+  }
+  case AstKind::FuncStmt:
+    code = std::move(expr(node->child[0]).code);
+    break;
+  case AstKind::ReadStmt: {
+    attributes left = expr(node->child[0]);
+    TypesMgr::TypeId tid1 = node->child[0]->type;
+    atomTable::atom address = left.offs != atomTable::EMPTY ? newTemp() : left.addr;
+    if (Types.isCharacterTy(tid1))
+      code = std::move(left.code) || instruction::READC(address);
+    else if (Types.isFloatTy(tid1))
+      code = std::move(left.code) || instruction::READF(address);
+    else
+      code = std::move(left.code) || instruction::READI(address);
+    if (left.offs != atomTable::EMPTY)
+      code = std::move(code) || instruction::XLOAD(left.addr, left.offs, address);
+    break;
+  }
+  case AstKind::WriteExpr: {
+    attributes e = expr(node->child[0]);
+    TypesMgr::TypeId tid1 = node->child[0]->type;
+    if (Types.isCharacterTy(tid1))
+      code = std::move(e.code) || instruction::WRITEC(e.addr);
+    else if (Types.isFloatTy(tid1))
+      code = std::move(e.code) || instruction::WRITEF(e.addr);
+    else
+      code = std::move(e.code) || instruction::WRITEI(e.addr);
+    break;
+  }
+  case AstKind::WriteString: {
+    const std::string & s = Ast->atomText(node->token);
+    atomTable::atom temp = newTemp();
+    int i = 1;
+    while (i < int(s.size())-1) {
+      if (s[i] != '\\') {
+	code = std::move(code) ||
+	       instruction::CHLOAD(temp, Atoms.intern(s.data()+i, 1)) ||
+	       instruction::WRITEC(temp);
+	i += 1;
+      }
+      else {
+	assert(i < int(s.size())-2);
+	if (s[i+1] == 'n') {
+	  code = std::move(code) || instruction::WRITELN();
+	  i += 2;
+	}
+	else if (s[i+1] == 't' or s[i+1] == '"' or s[i+1] == '\\') {
+	  code = std::move(code) ||
+		 instruction::CHLOAD(temp, Atoms.intern(s.data()+i, 2)) ||
+		 instruction::WRITEC(temp);
+	  i += 2;
+	}
+	else {
+	  code = std::move(code) ||
+		 instruction::CHLOAD(temp, Atoms.intern(s.data()+i, 1)) ||
+		 instruction::WRITEC(temp);
+	  i += 1;
+	}
+      }
+    }
+    break;
+  }
+  case AstKind::ReturnStmt:
+    if (node->count > 0) {
+      attributes e = expr(node->child[0]);
+      // (a temporal is taken and not used, like in the CodeGenListener)
+      newTemp();
+      code = std::move(e.code) || instruction::LOAD(Atoms.intern("_result"), e.addr);
+    }
+    break;
+  default:
+    break;
+  }
+  return code;
+}
+
+CodeGenPass::attributes CodeGenPass::expr(AstNode *node) {
+  attributes result;
+  switch (node->kind) {
+  case AstKind::Ident:
+    result.symbol = node->symbol;
+    result.addr = Ast->atom(node->token);
+    break;
+  case AstKind::ExprIdent:
+  case AstKind::Identifier:
+  case AstKind::Parenthesis:
+  case AstKind::IndexArrayLeftExpr:
+  case AstKind::FunctionAsExpr:
+    result = expr(node->child[0]);
+    break;
+  case AstKind::ArrayAccess: {
+    attributes index = expr(node->child[1]);
+    result.symbol = node->child[0]->symbol;
+    result.addr = Ast->atom(node->child[0]->token);
+    result.offs = index.addr;
+    result.code = std::move(index.code);
+    break;
+  }
+  case AstKind::IndexArrayExpr: {
+    attributes access = expr(node->child[0]);
+    atomTable::atom temp1 = newTemp();
+    if (access.symbol.isParameterClass()) {
+      atomTable::atom temp2 = newTemp();
+      result.code = std::move(access.code) || instruction::LOAD(temp1, access.addr) ||
+		    instruction::LOADX(temp2, temp1, access.offs);
+      result.addr = temp2;
+    }
+    else {
+      result.code = std::move(access.code) || instruction::LOADX(temp1, access.addr, access.offs);
+      result.addr = temp1;
+    }
+    result.offs = access.offs;
+    break;
+  }
+  case AstKind::ProcCall: {
+    std::uint32_t numArgs = node->count - 1;
+    std::vector<attributes> args;
+    args.reserve(numArgs);
+    for (std::uint32_t i = 0; i < numArgs; ++i) args.push_back(expr(node->child[i + 1]));
+    atomTable::atom name = Ast->atom(node->child[0]->token);
+    TypesMgr::TypeId t = node->child[0]->type;
+    TypesMgr::TypeId function_type = node->type;
+    if (not Types.isVoidFunction(t)) {
+      result.code = instruction::PUSH();
+    }
+    for (std::uint32_t i = 0; i < numArgs; ++i) {
+      atomTable::atom addr = args[i].addr;
+      instructionList paramcode = std::move(args[i].code);
+      instructionList conversioncode;
+      TypesMgr::TypeId originalparam_type = Types.getParameterType(function_type, i);
+      TypesMgr::TypeId passedparam_type = node->child[i + 1]->type;
+      if (Types.isFloatTy(originalparam_type) and Types.isIntegerTy(passedparam_type)) {
+	conversioncode = instruction::FLOAT(addr, addr);
+      }
+      if (Types.isArrayTy(originalparam_type)) {
+	atomTable::atom temp = newTemp();
+	paramcode = std::move(paramcode) || instruction::ALOAD(temp, addr);
+	addr = temp;
+      }
+      result.code = std::move(result.code) || std::move(paramcode) ||
+		    std::move(conversioncode) || instruction::PUSH(addr);
+    }
+    result.code = std::move(result.code) || instruction::CALL(name);
+    for (std::uint32_t i = 0; i < numArgs; ++i) {
+      result.code = std::move(result.code) || instruction::POP();
+    }
+    if (not Types.isVoidFunction(t)) {
+      result.addr = newTemp();
+      result.code = std::move(result.code) || instruction::POP(result.addr);
+    }
+    break;
+  }
+  case AstKind::Unary: {
+    attributes e = expr(node->child[0]);
+    atomTable::atom temp = newTemp();
+    TypesMgr::TypeId t_expr = node->child[0]->type;
+    result.code = std::move(e.code);
+    std::size_t op = Ast->type(node->token);
+    if (op == AslLexer::NOT) {
+      result.code = std::move(result.code) || instruction::NOT(temp, e.addr);
+    }
+    else if (op == AslLexer::SUB) {
+      if (Types.isFloatTy(t_expr))
+	result.code = std::move(result.code) || instruction::FSUB(temp, atomTable::EMPTY, e.addr);
+      else
+	result.code = std::move(result.code) || instruction::SUB(temp, atomTable::EMPTY, e.addr);
+    }
+    result.addr = temp;
+    break;
+  }
+  case AstKind::Arithmetic: {
+    attributes e1 = expr(node->child[0]);
+    attributes e2 = expr(node->child[1]);
+    instructionList code = std::move(e1.code) || std::move(e2.code);
+    TypesMgr::TypeId t1 = node->child[0]->type;
+    TypesMgr::TypeId t2 = node->child[1]->type;
+    atomTable::atom addr1 = e1.addr, addr2 = e2.addr;
+    atomTable::atom temp = newTemp();
+    std::size_t op = Ast->type(node->token);
+    if (not Types.isFloatTy(node->type)) {
+      if (op == AslLexer::MUL)
+	code = std::move(code) || instruction::MUL(temp, addr1, addr2);
+      else if (op == AslLexer::PLUS)
+	code = std::move(code) || instruction::ADD(temp, addr1, addr2);
+      else if (op == AslLexer::DIV)
+	code = std::move(code) || instruction::DIV(temp, addr1, addr2);
+      else if (op == AslLexer::MOD)
+	code = std::move(code) || instruction::DIV(temp, addr1, addr2) ||
+	       instruction::MUL(temp, temp, addr2) || instruction::SUB(temp, addr1, temp);
+      else
+	code = std::move(code) || instruction::SUB(temp, addr1, addr2);
+    }
+    else {
+      // the integer operands are converted in the result temporal
+      if (Types.isIntegerTy(t1)) {
+	code = std::move(code) || instruction::FLOAT(temp, addr1);
+	addr1 = temp;
+      }
+      if (Types.isIntegerTy(t2)) {
+	code = std::move(code) || instruction::FLOAT(temp, addr2);
+	addr2 = temp;
+      }
+      if (op == AslLexer::MUL)
+	code = std::move(code) || instruction::FMUL(temp, addr1, addr2);
+      else if (op == AslLexer::PLUS)
+	code = std::move(code) || instruction::FADD(temp, addr1, addr2);
+      else if (op == AslLexer::DIV)
+	code = std::move(code) || instruction::FDIV(temp, addr1, addr2);
+      else if (op == AslLexer::MOD)
+	code = std::move(code) || instruction::FDIV(temp, addr1, addr2) ||
+	       instruction::FMUL(temp, temp, addr2) || instruction::FSUB(temp, addr1, temp);
+      else
+	code = std::move(code) || instruction::FSUB(temp, addr1, addr2);
+    }
+    result.addr = temp;
+    result.code = std::move(code);
+    break;
+  }
+  case AstKind::Relational: {
+    attributes e1 = expr(node->child[0]);
+    attributes e2 = expr(node->child[1]);
+    instructionList code = std::move(e1.code) || std::move(e2.code);
+    atomTable::atom temp = newTemp();
+    switch (Ast->type(node->token)) {
+    case AslLexer::EQUAL:
+      code = std::move(code) || instruction::EQ(temp, e1.addr, e2.addr);
+      break;
+    case AslLexer::DIFF:
+      code = std::move(code) || instruction::EQ(temp, e1.addr, e2.addr) || instruction::NOT(temp, temp);
+      break;
+    case AslLexer::GTE:
+      code = std::move(code) || instruction::LT(temp, e1.addr, e2.addr) || instruction::NOT(temp, temp);
+      break;
+    case AslLexer::GT:
+      code = std::move(code) || instruction::LE(temp, e1.addr, e2.addr) || instruction::NOT(temp, temp);
+      break;
+    case AslLexer::LTE:
+      code = std::move(code) || instruction::LE(temp, e1.addr, e2.addr);
+      break;
+    default:
+      code = std::move(code) || instruction::LT(temp, e1.addr, e2.addr);
+      break;
+    }
+    result.addr = temp;
+    result.code = std::move(code);
+    break;
+  }
+  case AstKind::Boolean: {
+    attributes e1 = expr(node->child[0]);
+    attributes e2 = expr(node->child[1]);
+    instructionList code = std::move(e1.code) || std::move(e2.code);
+    atomTable::atom temp = newTemp();
+    if (Ast->type(node->token) == AslLexer::AND)
+      code = std::move(code) || instruction::AND(temp, e1.addr, e2.addr);
+    else
+      code = std::move(code) || instruction::OR(temp, e1.addr, e2.addr);
+    result.addr = temp;
+    result.code = std::move(code);
+    break;
+  }
+  case AstKind::Integervalue:
+    result.addr = newTemp();
+    result.code = instruction::ILOAD(result.addr, Ast->atom(node->token));
+    break;
+  case AstKind::Floatvalue:
+    result.addr = newTemp();
+    result.code = instruction::FLOAD(result.addr, Ast->atom(node->token));
+    break;
+  case AstKind::Booleanvalue:
+    result.addr = newTemp();
+    result.code = instruction::ILOAD(result.addr, Atoms.intern(Ast->type(node->token) == AslLexer::TRUE ? "1" : "0"));
+    break;
+  case AstKind::Char: {
+    const std::string & s = Ast->atomText(node->token);
+    result.addr = newTemp();
+    result.code = instruction::CHLOAD(result.addr, Atoms.intern(s.data()+1, s.size()-2));
+    break;
+  }
+  default:
+    break;
+  }
+  return result;
+}
+
+atomTable::atom CodeGenPass::newTemp() {
+  return codeCounters.newTEMP(Atoms);
+}
@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    CodeGenPass - Generates the code of a program, walking its
+//                  AST
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "AslAst.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/code.h"
+
+#include <string>
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Class CodeGenPass: does on the AST built by the AslRecursiveParser
+// what the CodeGenListener does on the parse tree, once the
+// SymbolsPass and the TypeCheckPass have finished with no semantic
+// error. The code generated is the same, instruction by instruction
+// (the temporals and labels are numbered in the same order). Instead
+// of decorating the nodes with their address, offset and code, each
+// node returns them to its parent.
+
+class CodeGenPass {
+
+public:
+
+  // Constructor
+  CodeGenPass(TypesMgr & Types,
+	      SymTable & Symbols,
+	      code     & Code);
+
+  // Generates the code of every function of the program
+  void walk(AslAst & ast);
+
+private:
+
+  // The attributes of the code of an expression (symbol is the one
+  // of the identifier that is its addr, if it is one)
+  struct attributes {
+    SymTable::SymbolHandle symbol;
+    atomTable::atom addr = atomTable::EMPTY;
+    atomTable::atom offs = atomTable::EMPTY;
+    instructionList code;
+  };
+
+  // Attributes:
+  TypesMgr & Types;
+  SymTable & Symbols;
+  code     & Code;
+  // table of the atoms of the operands of the instructions of Code
+  atomTable & Atoms;
+  counters   codeCounters;
+  AslAst   * Ast;
+
+  void            function   (AstNode *node);
+  instructionList statements (AstNode *node);
+  instructionList statement  (AstNode *node);
+  // any expression, left expression, call or ident
+  attributes      expr       (AstNode *node);
+
+  // New temporal (with its '%')
+  atomTable::atom newTemp();
+
+};  // class CodeGenPass
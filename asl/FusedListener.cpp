@@ -0,0 +1,141 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    FusedListener - Walk the parser tree only once to do the
+//                    symbol collection, the typecheck and the
+//                    generation of code of every function
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "FusedListener.h"
+
+#include "antlr4-runtime.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/TreeDecoration.h"
+#include "../common/SemErrors.h"
+#include "../common/code.h"
+
+// using namespace std;
+
+
+// Constructor
+FusedListener::FusedListener(TypesMgr       & Types,
+			     SymTable       & Symbols,
+			     TreeDecoration & Decorations,
+			     SemErrors      & Errors,
+			     code           & Code) :
+  Symbols{Symbols},
+  Decorations{Decorations},
+  Errors{Errors},
+  symbols{Types, Symbols, Decorations, Errors},
+  typecheck{Types, Symbols, Decorations, Errors},
+  codegen{Types, Symbols, Decorations, Code},
+  generating{true} {
+}
+
+// The tree walker calls enterEveryRule before, and exitEveryRule after,
+// the specific enter/exit method of the node (empty in AslBaseListener),
+// so the nodes are dispatched here to the three listeners
+void FusedListener::enterEveryRule(antlr4::ParserRuleContext *ctx) {
+  if (auto progCtx = dynamic_cast<AslParser::ProgramContext *>(ctx)) {
+    declareFunctions(progCtx);
+  }
+  else {
+    ctx->enterRule(&symbols);
+  }
+  ctx->enterRule(&typecheck);
+  enterCodeGen(ctx);
+}
+
+void FusedListener::exitEveryRule(antlr4::ParserRuleContext *ctx) {
+  if (dynamic_cast<AslParser::FunctionContext *>(ctx)) {
+    // the function was declared in advance: only close its scope
+    Symbols.popScope();
+    ctx->exitRule(&typecheck);
+  }
+  else if (dynamic_cast<AslParser::IdentContext *>(ctx) and
+	   dynamic_cast<AslParser::ArrayDeclContext *>(ctx->parent)) {
+    // typechecked in the exit of arrayDecl, once it is declared
+    ctx->exitRule(&symbols);
+  }
+  else if (auto declCtx = dynamic_cast<AslParser::ArrayDeclContext *>(ctx)) {
+    ctx->exitRule(&symbols);
+    for (auto identCtx : declCtx->ident()) {
+      identCtx->exitRule(&typecheck);
+    }
+    ctx->exitRule(&typecheck);
+  }
+  else {
+    ctx->exitRule(&symbols);
+    ctx->exitRule(&typecheck);
+  }
+  exitCodeGen(ctx);
+}
+
+// Does the work of SymbolsListener::enterProgram and, in advance, the
+// declaration that SymbolsListener::exitFunction does for each function
+void FusedListener::declareFunctions(AslParser::ProgramContext *ctx) {
+  symbols.enterProgram(ctx);
+  for (auto funcCtx : ctx->function()) {
+    for (auto declCtx : funcCtx->param_decl()) {
+      if (auto basicCtx = dynamic_cast<AslParser::BasicParamDeclContext *>(declCtx))
+	symbols.exitType(basicCtx->type());
+      else if (auto arrayCtx = dynamic_cast<AslParser::ArrayParamDeclContext *>(declCtx))
+	symbols.exitType(arrayCtx->type());
+    }
+    if (funcCtx->type())
+      symbols.exitType(funcCtx->type());
+    symbols.declareFunction(funcCtx);
+  }
+}
+
+void FusedListener::enterCodeGen(antlr4::ParserRuleContext *ctx) {
+  if (isGenerating()) {
+    ctx->enterRule(&codegen);
+  }
+  else if (dynamic_cast<AslParser::ProgramContext *>(ctx) or
+	   dynamic_cast<AslParser::FunctionContext *>(ctx)) {
+    Symbols.pushThisScope(Decorations.getScope(ctx));
+  }
+}
+
+void FusedListener::exitCodeGen(antlr4::ParserRuleContext *ctx) {
+  if (isGenerating()) {
+    ctx->exitRule(&codegen);
+  }
+  else if (dynamic_cast<AslParser::ProgramContext *>(ctx) or
+	   dynamic_cast<AslParser::FunctionContext *>(ctx)) {
+    Symbols.popScope();
+  }
+}
+
+// The CodeGenListener relies on a correct tree: once there is an error
+// no more code is generated (and the code will not be written)
+bool FusedListener::isGenerating() {
+  if (generating and Errors.getNumberOfSemanticErrors() > 0)
+    generating = false;
+  return generating;
+}
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    FusedListener - Walk the parser tree only once to do the
+//                    symbol collection, the typecheck and the
+//                    generation of code of every function
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "antlr4-runtime.h"
+#include "AslBaseListener.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/TreeDecoration.h"
+#include "../common/SemErrors.h"
+#include "../common/code.h"
+
+#include "SymbolsListener.h"
+#include "TypeCheckListener.h"
+#include "CodeGenListener.h"
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Class FusedListener:  derived from AslBaseListener.
+// It does in a single walk of the parse tree the work of the three
+// listeners (SymbolsListener, TypeCheckListener and CodeGenListener),
+// calling them in this order on every node. The resulting code and
+// errors are the same as with three separate walks:
+//   - the signatures of all the functions are registered when
+//     entering the program, so calls to functions defined later in
+//     the source can be checked,
+//   - the typecheck of the identifiers of an array declaration waits
+//     until they have been declared (exit of arrayDecl),
+//   - code is generated only while no semantic error has been found,
+//     and the code object must not print the subroutines as they are
+//     completed (the errors can be found after that).
+
+class FusedListener final : public AslBaseListener {
+
+public:
+
+  // Constructor
+  FusedListener(TypesMgr       & Types,
+		SymTable       & Symbols,
+		TreeDecoration & Decorations,
+		SemErrors      & Errors,
+		code           & Code);
+
+  void enterEveryRule(antlr4::ParserRuleContext *ctx);
+  void exitEveryRule(antlr4::ParserRuleContext *ctx);
+
+private:
+
+  // Attributes:
+  SymTable          & Symbols;
+  TreeDecoration    & Decorations;
+  SemErrors         & Errors;
+  SymbolsListener   symbols;
+  TypeCheckListener typecheck;
+  CodeGenListener   codegen;
+  bool              generating;
+
+  // Registers the global scope and the signatures of all the functions
+  void declareFunctions(AslParser::ProgramContext *ctx);
+
+  // Call the CodeGenListener on the node, or when code is no longer
+  // generated, just keep the scopes it would push and pop
+  void enterCodeGen(antlr4::ParserRuleContext *ctx);
+  void exitCodeGen(antlr4::ParserRuleContext *ctx);
+  bool isGenerating();
+
+};  // class FusedListener
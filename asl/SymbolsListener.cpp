@@ -31,6 +31,7 @@
 #include "SymbolsListener.h"
 
 #include "antlr4-runtime.h"
+#include "AslAtomToken.h"
 
 #include "../common/TypesMgr.h"
 #include "../common/SymTable.h"
@@ -74,15 +75,21 @@ void SymbolsListener::exitProgram(AslParser::ProgramContext *ctx) {
 
 void SymbolsListener::enterFunction(AslParser::FunctionContext *ctx) {
   DEBUG_ENTER();
-  std::string funcName = ctx->ID()->getText();
-  SymTable::ScopeId sc = Symbols.pushNewScope(funcName);
+  SymTable::ScopeId sc = Symbols.pushNewScope(atomTextOf(ctx->ID()));
   putScopeDecor(ctx, sc);
 }
 
 void SymbolsListener::exitFunction(AslParser::FunctionContext *ctx) {
   // Symbols.print();
   Symbols.popScope();
-  std::string ident = ctx->ID()->getText();
+  declareFunction(ctx);
+  DEBUG_EXIT();
+}
+
+// Adds the function to the current (global) scope, once the types of
+// its parameters and its return type have been decorated by exitType
+void SymbolsListener::declareFunction(AslParser::FunctionContext *ctx) {
+  SymTable::Atom ident = atomOf(ctx->ID());
   if (Symbols.findInCurrentScope(ident)) {
     Errors.declaredIdent(ctx->ID());
   }
@@ -142,7 +149,6 @@ void SymbolsListener::exitFunction(AslParser::FunctionContext *ctx) {
 
     Symbols.addFunction(ident, tFunc);
   }
-  DEBUG_EXIT();
 }
 
 void SymbolsListener::enterDeclarations(AslParser::DeclarationsContext *ctx) {
@@ -159,7 +165,7 @@ void SymbolsListener::enterBasicDecl(AslParser::BasicDeclContext *ctx) {
 
 void SymbolsListener::exitBasicDecl(AslParser::BasicDeclContext *ctx) {
     for (auto sdechoque : ctx->ID()) {
-        std::string ident = sdechoque->getText();
+        SymTable::Atom ident = atomOf(sdechoque);
         if (Symbols.findInCurrentScope(ident)) {
             Errors.declaredIdent(sdechoque);
         }
@@ -179,7 +185,7 @@ void SymbolsListener::exitArrayDecl(AslParser::ArrayDeclContext *ctx) {
 
   for (auto sdechoque : ctx->ident()) {
 		  
-		 std::string ident = sdechoque->ID()->getText();
+		 SymTable::Atom ident = atomOf(sdechoque->ID());
 
 		  if (Symbols.findInCurrentScope(ident)) {
 			Errors.declaredIdent(sdechoque->ID());
@@ -219,7 +225,7 @@ void SymbolsListener::enterArrayParamDecl(AslParser::ArrayParamDeclContext *ctx)
 
 void SymbolsListener::exitArrayParamDecl(AslParser::ArrayParamDeclContext *ctx) {
 
-		 std::string ident = ctx->ID()->getText();
+		 SymTable::Atom ident = atomOf(ctx->ID());
 
 		  if (Symbols.findInCurrentScope(ident)) {
 			Errors.declaredIdent(ctx->ID());
@@ -254,7 +260,7 @@ void SymbolsListener::enterBasicParamDecl(AslParser::BasicParamDeclContext *ctx)
 }
 
 void SymbolsListener::exitBasicParamDecl(AslParser::BasicParamDeclContext *ctx) {
-        std::string ident = ctx->ID()->getText();
+        SymTable::Atom ident = atomOf(ctx->ID());
         if (Symbols.findInCurrentScope(ident)) {
             Errors.declaredIdent(ctx->ID());
         }
@@ -123,6 +123,10 @@ public:
   void enterBasicParamDecl(AslParser::BasicParamDeclContext *ctx);
   void exitBasicParamDecl(AslParser::BasicParamDeclContext *ctx);
 
+  // Registers the function in the global scope (done by exitFunction,
+  // or in advance for all the functions by the FusedListener)
+  void declareFunction(AslParser::FunctionContext *ctx);
+
   // void enterEveryRule(antlr4::ParserRuleContext *ctx);
   // void exitEveryRule(antlr4::ParserRuleContext *ctx);
   // void visitTerminal(antlr4::tree::TerminalNode *node);
@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    SymbolsPass - Registers the symbols of a program in the symbol
+//                  table, walking its AST
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+
+#include "SymbolsPass.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/SemErrors.h"
+
+#include <string>
+#include <vector>
+
+// using namespace std;
+
+
+// Constructor
+SymbolsPass::SymbolsPass(TypesMgr  & Types,
+			 SymTable  & Symbols,
+			 SemErrors & Errors) :
+  Types{Types},
+  Symbols{Symbols},
+  Errors{Errors},
+  Ast{nullptr} {
+}
+
+void SymbolsPass::walk(AslAst & ast) {
+  Ast = &ast;
+  AstNode *program = ast.root;
+  program->scope = Symbols.pushNewScope("$global$");
+  for (std::uint32_t i = 0; i < program->count; ++i) {
+    function(program->child[i]);
+  }
+  Symbols.popScope();
+}
+
+void SymbolsPass::function(AstNode *node) {
+  node->scope = Symbols.pushNewScope(Ast->atomText(node->token));
+  // the parameters, then the declarations (the statements declare nothing)
+  for (std::uint32_t i = 0; i + 2 < node->count; ++i) {
+    paramDecl(node->child[i]);
+  }
+  declarations(node->child[node->count - 2]);
+  Symbols.popScope();
+  declareFunction(node);
+}
+
+// Adds the function to the current (global) scope, like
+// SymbolsListener::declareFunction
+void SymbolsPass::declareFunction(AstNode *node) {
+  SymTable::Atom ident = Ast->atom(node->token);
+  if (Symbols.findInCurrentScope(ident)) {
+    Errors.declaredIdent(Ast->line(node->token), Ast->column(node->token), Ast->atomText(node->token));
+    return;
+  }
+  std::vector<TypesMgr::TypeId> lParamsTy;
+  for (std::uint32_t i = 0; i + 2 < node->count; ++i) {
+    AstNode *param = node->child[i];
+    TypesMgr::TypeId t = basicType(param->aux);
+    if (param->kind == AstKind::ArrayParamDecl) {
+      int array_size = arraySize(param);
+      t = Types.createArrayTy(array_size, t);
+    }
+    lParamsTy.push_back(t);
+  }
+  TypesMgr::TypeId tRet;
+  if (node->aux != AstNode::NONE)
+    tRet = basicType(node->aux);
+  else
+    tRet = Types.createVoidTy();
+  node->type = Types.createFunctionTy(lParamsTy, tRet);
+  Symbols.addFunction(ident, node->type);
+}
+
+void SymbolsPass::paramDecl(AstNode *node) {
+  SymTable::Atom ident = Ast->atom(node->token);
+  if (Symbols.findInCurrentScope(ident)) {
+    Errors.declaredIdent(Ast->line(node->token), Ast->column(node->token), Ast->atomText(node->token));
+  }
+  else if (node->kind == AstKind::ArrayParamDecl) {
+    int array_size = arraySize(node);
+    Symbols.addParameter(ident, Types.createArrayTy(array_size, basicType(node->aux)));
+  }
+  else {
+    Symbols.addParameter(ident, basicType(node->aux));
+  }
+}
+
+void SymbolsPass::declarations(AstNode *node) {
+  for (std::uint32_t d = 0; d < node->count; ++d) {
+    AstNode *decl = node->child[d];
+    if (decl->kind == AstKind::BasicDecl) {
+      // the type is kept in the node (for the CodeGenPass), and the IDs
+      // are every other token, up to the ':' before the type
+      decl->type = basicType(decl->aux);
+      for (std::uint32_t id = decl->token; id + 1 < decl->aux; id += 2) {
+	SymTable::Atom ident = Ast->atom(id);
+	if (Symbols.findInCurrentScope(ident))
+	  Errors.declaredIdent(Ast->line(id), Ast->column(id), Ast->atomText(id));
+	else
+	  Symbols.addLocalVar(ident, decl->type);
+      }
+    }
+    else {
+      // the idents, and the size as the last child
+      for (std::uint32_t i = 0; i + 1 < decl->count; ++i) {
+	std::uint32_t id = decl->child[i]->token;
+	SymTable::Atom ident = Ast->atom(id);
+	if (Symbols.findInCurrentScope(ident)) {
+	  Errors.declaredIdent(Ast->line(id), Ast->column(id), Ast->atomText(id));
+	}
+	else {
+	  int array_size = arraySize(decl);
+	  Symbols.addLocalVar(ident, Types.createArrayTy(array_size, basicType(decl->aux)));
+	}
+      }
+    }
+  }
+}
+
+TypesMgr::TypeId SymbolsPass::basicType(std::uint32_t token) {
+  switch (Ast->type(token)) {
+  case AslLexer::INT:
+    return Types.createIntegerTy();
+  case AslLexer::FLOAT:
+    return Types.createFloatTy();
+  case AslLexer::BOOL:
+    return Types.createBooleanTy();
+  default:
+    return Types.createCharacterTy();
+  }
+}
+
+int SymbolsPass::arraySize(AstNode *decl) {
+  // like the SymbolsListener, the number at the start of its text
+  return std::stoi(Ast->sizeText(decl));
+}
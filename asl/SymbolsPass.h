@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    SymbolsPass - Registers the symbols of a program in the symbol
+//                  table, walking its AST
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "AslAst.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/SemErrors.h"
+
+#include <string>
+#include <cstdint>    // std::uint32_t
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Class SymbolsPass: does on the AST built by the AslRecursiveParser
+// what the SymbolsListener does on the parse tree: it registers the
+// symbols of the program in their scopes (and decorates the program
+// and function nodes with their scope, the functions with their type
+// and the basic declarations with the type declared), and reports the identifiers declared twice. The symbols, the
+// types and the errors (and their order) are the same.
+
+class SymbolsPass {
+
+public:
+
+  // Constructor
+  SymbolsPass(TypesMgr  & Types,
+	      SymTable  & Symbols,
+	      SemErrors & Errors);
+
+  // Registers the symbols of the whole program
+  void walk(AslAst & ast);
+
+private:
+
+  // Attributes:
+  TypesMgr  & Types;
+  SymTable  & Symbols;
+  SemErrors & Errors;
+  AslAst    * Ast;
+
+  void function        (AstNode *node);
+  void declareFunction (AstNode *node);
+  void paramDecl       (AstNode *node);
+  void declarations    (AstNode *node);
+
+  // Type named by the token of a 'type' (int, float, bool or char)
+  TypesMgr::TypeId basicType (std::uint32_t token);
+  // Size of an array declaration (taken from the text of its size)
+  int arraySize (AstNode *decl);
+
+};  // class SymbolsPass
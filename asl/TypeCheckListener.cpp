@@ -30,6 +30,7 @@
 #include "TypeCheckListener.h"
 
 #include "antlr4-runtime.h"
+#include "AslAtomToken.h"
 
 #include "../common/TypesMgr.h"
 #include "../common/SymTable.h"
@@ -329,18 +330,20 @@ void TypeCheckListener::enterIdent(AslParser::IdentContext *ctx) {
 }
 
 void TypeCheckListener::exitIdent(AslParser::IdentContext *ctx) {
-  std::string ident = ctx->ID()->getText();
-  int found_stack = Symbols.findInStack(ident);
-  if (found_stack == -1) {
+  // the identifier is resolved only here (by the atom of its token):
+  // the later passes use the handle kept as its symbol attribute
+  SymTable::SymbolHandle symbol = Symbols.lookup(atomOf(ctx->ID()));
+  putSymbolDecor(ctx, symbol);
+  if (not symbol.isFound()) {
     Errors.undeclaredIdent(ctx->ID());
     TypesMgr::TypeId te = Types.createErrorTy();
     putTypeDecor(ctx, te);
     putIsLValueDecor(ctx, true);
   }
   else {
-    TypesMgr::TypeId t1 = Symbols.getType(ident);
+    TypesMgr::TypeId t1 = symbol.getType();
     putTypeDecor(ctx, t1);
-    if (Symbols.isFunctionClass(ident))
+    if (symbol.isFunctionClass())
       putIsLValueDecor(ctx, false);
     else
       putIsLValueDecor(ctx, true);
@@ -600,7 +603,7 @@ bool TypeCheckListener::getIsLValueDecor(antlr4::ParserRuleContext *ctx) {
 }
 
 // Setters for the necessary tree node attributes:
-//   Scope, Type ans IsLValue
+//   Scope, Type, IsLValue and Symbol
 void TypeCheckListener::putScopeDecor(antlr4::ParserRuleContext *ctx, SymTable::ScopeId s) {
   Decorations.putScope(ctx, s);
 }
@@ -610,3 +613,6 @@ void TypeCheckListener::putTypeDecor(antlr4::ParserRuleContext *ctx, TypesMgr::T
 void TypeCheckListener::putIsLValueDecor(antlr4::ParserRuleContext *ctx, bool b) {
   Decorations.putIsLValue(ctx, b);
 }
+void TypeCheckListener::putSymbolDecor(antlr4::ParserRuleContext *ctx, const SymTable::SymbolHandle & s) {
+  Decorations.putSymbol(ctx, s);
+}
@@ -175,9 +175,10 @@ private:
   bool              getIsLValueDecor (antlr4::ParserRuleContext *ctx);
 
   // Setters for the necessary tree node attributes:
-  //   Scope, Type ans IsLValue
+  //   Scope, Type, IsLValue and Symbol
   void putScopeDecor    (antlr4::ParserRuleContext *ctx, SymTable::ScopeId s);
   void putTypeDecor     (antlr4::ParserRuleContext *ctx, TypesMgr::TypeId t);
   void putIsLValueDecor (antlr4::ParserRuleContext *ctx, bool b);
+  void putSymbolDecor   (antlr4::ParserRuleContext *ctx, const SymTable::SymbolHandle & s);
 
 };  // class TypeCheckListener
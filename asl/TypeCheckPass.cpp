@@ -0,0 +1,334 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    TypeCheckPass - Checks the types of a program, walking its
+//                    AST
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+
+#include "TypeCheckPass.h"
+
+#include "antlr4-runtime.h"
+#include "AslLexer.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/SemErrors.h"
+
+#include <string>
+
+// using namespace std;
+
+
+// Constructor
+TypeCheckPass::TypeCheckPass(TypesMgr  & Types,
+			     SymTable  & Symbols,
+			     SemErrors & Errors) :
+  Types{Types},
+  Symbols{Symbols},
+  Errors{Errors},
+  Ast{nullptr} {
+}
+
+void TypeCheckPass::walk(AslAst & ast) {
+  Ast = &ast;
+  AstNode *program = ast.root;
+  Symbols.pushThisScope(program->scope);
+  for (std::uint32_t i = 0; i < program->count; ++i) {
+    function(program->child[i]);
+  }
+  // localized at the EOF (the last token of the program)
+  if (Symbols.noMainProperlyDeclared())
+    Errors.noMainProperlyDeclared(ast.line(program->token), ast.column(program->token));
+  Symbols.popScope();
+  Errors.print();
+}
+
+void TypeCheckPass::function(AstNode *node) {
+  Symbols.pushThisScope(node->scope);
+  Symbols.setCurrentFunctionTy(node->type);
+  // the sizes of the array parameters and declarations are expressions too
+  for (std::uint32_t i = 0; i + 2 < node->count; ++i) {
+    AstNode *param = node->child[i];
+    if (param->kind == AstKind::ArrayParamDecl) expr(param->child[0]);
+  }
+  AstNode *decls = node->child[node->count - 2];
+  for (std::uint32_t d = 0; d < decls->count; ++d) {
+    AstNode *decl = decls->child[d];
+    for (std::uint32_t i = 0; i < decl->count; ++i) expr(decl->child[i]);
+  }
+  statements(node->child[node->count - 1]);
+  Symbols.popScope();
+}
+
+void TypeCheckPass::statements(AstNode *node) {
+  for (std::uint32_t i = 0; i < node->count; ++i) {
+    statement(node->child[i]);
+  }
+}
+
+void TypeCheckPass::statement(AstNode *node) {
+  std::size_t line = Ast->line(node->first), coln = Ast->column(node->first);
+  switch (node->kind) {
+  case AstKind::AssignStmt: {
+    AstNode *left = node->child[0], *right = node->child[1];
+    expr(left);
+    expr(right);
+    TypesMgr::TypeId t1 = left->type;
+    TypesMgr::TypeId t2 = right->type;
+    if ((not Types.isErrorTy(t1)) and (not left->isLValue))
+      Errors.nonReferenceableLeftExpr(line, coln);
+    if ((not Types.isErrorTy(t1)) and (not Types.isErrorTy(t2)) and
+	(not Types.copyableTypes(t1, t2)))
+      Errors.incompatibleAssignment(Ast->line(node->token), Ast->column(node->token));
+    break;
+  }
+  case AstKind::IfStmt:
+  case AstKind::WhileStmt: {
+    expr(node->child[0]);
+    for (std::uint32_t i = 1; i < node->count; ++i) statements(node->child[i]);
+    TypesMgr::TypeId t1 = node->child[0]->type;
+    if ((not Types.isErrorTy(t1)) and (not Types.isBooleanTy(t1)))
+      Errors.booleanRequired(line, coln, Ast->text(node->first));
+    break;
+  }
+  case AstKind::FuncStmt:
+    expr(node->child[0]);
+    break;
+  case AstKind::ReadStmt: {
+    AstNode *left = node->child[0];
+    expr(left);
+    TypesMgr::TypeId t1 = left->type;
+    if ((not Types.isErrorTy(t1)) and (not Types.isPrimitiveTy(t1)) and
+	(not Types.isFunctionTy(t1)))
+      Errors.readWriteRequireBasic(line, coln, Ast->text(node->first));
+    if ((not Types.isErrorTy(t1)) and (not left->isLValue))
+      Errors.nonReferenceableExpression(line, coln, Ast->text(node->first));
+    break;
+  }
+  case AstKind::WriteExpr: {
+    expr(node->child[0]);
+    TypesMgr::TypeId t1 = node->child[0]->type;
+    if ((not Types.isErrorTy(t1)) and (not Types.isPrimitiveTy(t1)))
+      Errors.readWriteRequireBasic(line, coln, Ast->text(node->first));
+    break;
+  }
+  case AstKind::ReturnStmt: {
+    // without expression, its type is the one of an undecorated node
+    TypesMgr::TypeId exprtype = TypesMgr::TypeId();
+    if (node->count > 0) {
+      expr(node->child[0]);
+      exprtype = node->child[0]->type;
+    }
+    TypesMgr::TypeId functype = Symbols.getCurrentFunctionTy();
+    if ((not Types.isErrorTy(functype)) and (Types.isFunctionTy(functype))) {
+      TypesMgr::TypeId returntype = Types.getFuncReturnType(functype);
+      if (node->count == 0 and (not Types.isErrorTy(returntype)) and
+	  (not Types.isVoidTy(returntype)))
+	Errors.incompatibleReturn(line, coln);
+      if ((not Types.isErrorTy(returntype)) and (not Types.isErrorTy(exprtype)) and
+	  (not Types.copyableTypes(returntype, exprtype)))
+	Errors.incompatibleReturn(line, coln);
+    }
+    break;
+  }
+  default:
+    // WriteString: nothing to check
+    break;
+  }
+}
+
+void TypeCheckPass::expr(AstNode *node) {
+  for (std::uint32_t i = 0; i < node->count; ++i) {
+    expr(node->child[i]);
+  }
+  std::size_t line = Ast->line(node->first), coln = Ast->column(node->first);
+  switch (node->kind) {
+  case AstKind::Ident: {
+    SymTable::SymbolHandle symbol = Symbols.lookup(Ast->atom(node->token));
+    node->symbol = symbol;
+    if (not symbol.isFound()) {
+      Errors.undeclaredIdent(line, coln, Ast->atomText(node->token));
+      node->type = Types.createErrorTy();
+      node->isLValue = true;
+    }
+    else {
+      node->type = symbol.getType();
+      node->isLValue = not symbol.isFunctionClass();
+    }
+    break;
+  }
+  case AstKind::ExprIdent:
+  case AstKind::Identifier:
+  case AstKind::Parenthesis:
+    node->type = node->child[0]->type;
+    node->isLValue = node->child[0]->isLValue;
+    break;
+  case AstKind::ArrayAccess: {
+    TypesMgr::TypeId ident_type = node->child[0]->type;
+    TypesMgr::TypeId index_type = node->child[1]->type;
+    if ((not Types.isErrorTy(ident_type)) and (not Types.isArrayTy(ident_type))) {
+      Errors.nonArrayInArrayAccess(line, coln);
+      node->type = Types.createErrorTy();
+      node->isLValue = false;
+    }
+    if ((not Types.isErrorTy(index_type)) and (not Types.isIntegerTy(index_type))) {
+      AstNode *index = node->child[1];
+      Errors.nonIntegerIndexInArrayAccess(Ast->line(index->first), Ast->column(index->first));
+      node->type = Types.createErrorTy();
+      node->isLValue = false;
+    }
+    if ((not Types.isErrorTy(ident_type)) and (Types.isArrayTy(ident_type))) {
+      node->type = Types.getArrayElemType(ident_type);
+      node->isLValue = true;
+    }
+    break;
+  }
+  case AstKind::IndexArrayLeftExpr:
+  case AstKind::IndexArrayExpr:
+    node->type = node->child[0]->type;
+    node->isLValue = true;
+    break;
+  case AstKind::ProcCall: {
+    AstNode *ident = node->child[0];
+    TypesMgr::TypeId t1 = ident->type;
+    if (not Types.isFunctionTy(t1) and not Types.isErrorTy(t1))
+      Errors.isNotCallable(line, coln, Ast->atomText(ident->token));
+    if (not Types.isErrorTy(t1) and Types.isFunctionTy(t1)) {
+      std::uint32_t num_params = Types.getNumOfParameters(t1);
+      std::uint32_t num_args = node->count - 1;
+      for (std::uint32_t i = 0; i < num_args and i < num_params; ++i) {
+	AstNode *arg = node->child[i + 1];
+	TypesMgr::TypeId called_param_type = arg->type;
+	TypesMgr::TypeId declared_param_type = Types.getParameterType(t1, i);
+	if ((not Types.isErrorTy(called_param_type)) and (not Types.isErrorTy(declared_param_type)) and
+	    (not Types.copyableTypes(declared_param_type, called_param_type)))
+	  Errors.incompatibleParameter(Ast->line(arg->first), Ast->column(arg->first), i + 1,
+				       Ast->atomText(ident->token));
+      }
+      if (num_args != num_params)
+	Errors.numberOfParameters(line, coln, Ast->atomText(ident->token));
+      node->type = t1;
+      node->isLValue = false;
+    }
+    break;
+  }
+  case AstKind::FunctionAsExpr: {
+    TypesMgr::TypeId t = node->child[0]->type;
+    if (Types.isFunctionTy(t)) {
+      TypesMgr::TypeId rettype = Types.getFuncReturnType(t);
+      if (Types.isVoidTy(rettype)) {
+	Errors.isNotFunction(line, coln, Ast->text(node->first));
+      }
+      else {
+	node->type = rettype;
+	node->isLValue = false;
+      }
+    }
+    else {
+      node->type = t;
+      node->isLValue = false;
+    }
+    break;
+  }
+  case AstKind::Unary: {
+    TypesMgr::TypeId t1 = node->child[0]->type;
+    if (Ast->type(node->token) != AslLexer::NOT) {
+      if ((not Types.isErrorTy(t1)) and (not Types.isNumericTy(t1)))
+	Errors.incompatibleOperator(line, coln, Ast->text(node->token));
+      node->type = t1;
+    }
+    else {
+      if ((not Types.isErrorTy(t1)) and (not Types.isBooleanTy(t1)))
+	Errors.incompatibleOperator(line, coln, Ast->text(node->token));
+      node->type = Types.createBooleanTy();
+    }
+    node->isLValue = false;
+    break;
+  }
+  case AstKind::Arithmetic: {
+    TypesMgr::TypeId t1 = node->child[0]->type;
+    TypesMgr::TypeId t2 = node->child[1]->type;
+    std::size_t opLine = Ast->line(node->token), opColn = Ast->column(node->token);
+    if (Ast->type(node->token) == AslLexer::MOD) {
+      if (((not Types.isErrorTy(t1)) and (not Types.isIntegerTy(t1))) or
+	  ((not Types.isErrorTy(t2)) and (not Types.isIntegerTy(t2))))
+	Errors.incompatibleOperator(opLine, opColn, Ast->text(node->token));
+    }
+    else {
+      if (((not Types.isErrorTy(t1)) and (not Types.isNumericTy(t1))) or
+	  ((not Types.isErrorTy(t2)) and (not Types.isNumericTy(t2))))
+	Errors.incompatibleOperator(opLine, opColn, Ast->text(node->token));
+    }
+    if ((not Types.isErrorTy(t1)) and (not Types.isErrorTy(t2)) and
+	(Types.isFloatTy(t1) or Types.isFloatTy(t2)))
+      node->type = Types.createFloatTy();
+    else
+      node->type = Types.createIntegerTy();
+    node->isLValue = false;
+    break;
+  }
+  case AstKind::Boolean: {
+    TypesMgr::TypeId t1 = node->child[0]->type;
+    TypesMgr::TypeId t2 = node->child[1]->type;
+    if (((not Types.isErrorTy(t1)) and (not Types.isBooleanTy(t1))) or
+	((not Types.isErrorTy(t2)) and (not Types.isBooleanTy(t2))))
+      Errors.incompatibleOperator(Ast->line(node->token), Ast->column(node->token),
+				  Ast->text(node->token));
+    node->type = Types.createBooleanTy();
+    node->isLValue = false;
+    break;
+  }
+  case AstKind::Relational: {
+    TypesMgr::TypeId t1 = node->child[0]->type;
+    TypesMgr::TypeId t2 = node->child[1]->type;
+    std::string oper = Ast->text(node->token);
+    if ((not Types.isErrorTy(t1)) and (not Types.isErrorTy(t2)) and
+	(not Types.comparableTypes(t1, t2, oper)))
+      Errors.incompatibleOperator(Ast->line(node->token), Ast->column(node->token), oper);
+    node->type = Types.createBooleanTy();
+    node->isLValue = false;
+    break;
+  }
+  case AstKind::Integervalue:
+    node->type = Types.createIntegerTy();
+    node->isLValue = false;
+    break;
+  case AstKind::Floatvalue:
+    node->type = Types.createFloatTy();
+    node->isLValue = false;
+    break;
+  case AstKind::Char:
+    node->type = Types.createCharacterTy();
+    node->isLValue = false;
+    break;
+  case AstKind::Booleanvalue:
+    node->type = Types.createBooleanTy();
+    node->isLValue = false;
+    break;
+  default:
+    break;
+  }
+}
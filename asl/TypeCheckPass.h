@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    TypeCheckPass - Checks the types of a program, walking its
+//                    AST
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "AslAst.h"
+
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/SemErrors.h"
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Class TypeCheckPass: does on the AST built by the AslRecursiveParser
+// what the TypeCheckListener does on the parse tree, once the
+// SymbolsPass has registered the symbols: it decorates the
+// expressions with their type and whether they are referenceable,
+// and reports the semantic errors (in the same order, so once sorted
+// they are printed the same). The nodes are visited in the same
+// order as the tree walker does (the children, from left to right,
+// before the node).
+
+class TypeCheckPass {
+
+public:
+
+  // Constructor
+  TypeCheckPass(TypesMgr  & Types,
+		SymTable  & Symbols,
+		SemErrors & Errors);
+
+  // Checks the whole program, and prints the errors found
+  void walk(AslAst & ast);
+
+private:
+
+  // Attributes:
+  TypesMgr  & Types;
+  SymTable  & Symbols;
+  SemErrors & Errors;
+  AslAst    * Ast;
+
+  void function   (AstNode *node);
+  void statements (AstNode *node);
+  void statement  (AstNode *node);
+  // any expression, left expression, call or ident
+  void expr       (AstNode *node);
+
+};  // class TypeCheckPass
@@ -50,6 +50,111 @@
 #done
 #echo "END   examples-initial/execution"
 
+ echo ""
+ echo "BEGIN examples-full/objcode"
+ for f in ../examples/jp*_genc_*.asl; do
+     echo $(basename "$f")
+     ./asl "$f" > tmp.t
+     ./asl -o tmp.o "$f"
+     ./asl --disassemble tmp.o > tmp-o.t
+     diff tmp.t tmp-o.t
+     rm -f tmp.t tmp.o tmp-o.t
+ done
+ echo "END   examples-full/objcode"
+
+ echo ""
+ echo "BEGIN examples-full/fused"
+ for f in ../examples/jp*_*.asl; do
+     echo $(basename "$f")
+     ./asl "$f" > tmp.t
+     ./asl --fused "$f" > tmp-fused.t
+     diff tmp.t tmp-fused.t
+     rm -f tmp.t tmp-fused.t
+ done
+ echo "END   examples-full/fused"
+
+ echo ""
+ echo "BEGIN examples-full/threads"
+ for f in ../examples/jp*_*.asl; do
+     echo $(basename "$f")
+     ./asl "$f" > tmp.t
+     ./asl -j 4 "$f" > tmp-j.t
+     diff tmp.t tmp-j.t
+     rm -f tmp.t tmp-j.t
+ done
+ echo "END   examples-full/threads"
+
+ echo ""
+ echo "BEGIN examples-full/cache"
+ rm -rf tmp-cache
+ for f in ../examples/jp*_genc_*.asl; do
+     echo $(basename "$f")
+     ./asl --cache-dir tmp-cache --cache-functions "$f" > /dev/null
+     # a new function: the file is not in the cache, but its functions are
+     (cat "$f"; printf "\nfunc check_cache_extra()\nendfunc\n") > tmp-extra.asl
+     ./asl tmp-extra.asl > tmp.t
+     ./asl --cache-dir tmp-cache --cache-functions tmp-extra.asl > tmp-cached.t
+     diff tmp.t tmp-cached.t
+     rm -f tmp-extra.asl tmp.t tmp-cached.t
+ done
+ rm -rf tmp-cache
+ echo "END   examples-full/cache"
+
+ echo ""
+ echo "BEGIN examples-full/tokens"
+ for f in ../examples/*.asl ../tvm/examples/*.t; do
+     echo $(basename "$f")
+     ./asl --tokens "$f" > tmp.tokens
+     ./asl --fast-lexer --tokens "$f" > tmp-fast.tokens
+     diff tmp.tokens tmp-fast.tokens
+     rm -f tmp.tokens tmp-fast.tokens
+ done
+ echo "END   examples-full/tokens"
+
+ echo ""
+ echo "BEGIN examples-full/rd-parser"
+ for f in ../examples/*.asl; do
+     echo $(basename "$f")
+     ./asl "$f" > tmp.t 2>&1
+     ./asl --rd-parser "$f" > tmp-rd.t 2>&1
+     diff tmp.t tmp-rd.t
+     rm -f tmp.t tmp-rd.t
+ done
+ echo "END   examples-full/rd-parser"
+
+ # the passes of the AST (SymbolsPass, TypeCheckPass, CodeGenPass)
+ # against the expected results, not only against the listeners
+ echo ""
+ echo "BEGIN examples-full/rd-parser-typecheck"
+ for f in ../examples/jp*_chkt_*.asl; do
+     echo $(basename "$f")
+     ./asl --rd-parser "$f" | egrep ^L > tmp.err
+     diff tmp.err "${f/asl/err}"
+     rm -f tmp.err
+ done
+ echo "END   examples-full/rd-parser-typecheck"
+
+ echo ""
+ echo "BEGIN examples-full/rd-parser-codegen"
+ for f in ../examples/jpbasic_genc_*.asl; do
+     echo $(basename "$f")
+     ./asl --rd-parser "$f" | egrep -v '^\(' > tmp.t
+     diff tmp.t "${f/asl/t}"
+     rm -f tmp.t
+ done
+ echo "END   examples-full/rd-parser-codegen"
+
+ echo ""
+ echo "BEGIN examples-full/rd-parser-execution"
+ for f in ../examples/jp*_genc_*.asl; do
+     echo $(basename "$f")
+     ./asl --rd-parser "$f" > tmp.t
+     ../tvm/tvm tmp.t < "${f/asl/in}" > tmp.out
+     diff tmp.out "${f/asl/out}"
+     rm -f tmp.t tmp.out
+ done
+ echo "END   examples-full/rd-parser-execution"
+
  contador=1
 
  echo ""
@@ -31,108 +31,71 @@
 
 
 #include "antlr4-runtime.h"
-#include "AslLexer.h"
-#include "AslParser.h"
-#include "tree/ParseTreeWalker.h"
 
-#include "../common/TypesMgr.h"
-#include "../common/SymTable.h"
-#include "../common/TreeDecoration.h"
-#include "../common/SemErrors.h"
-#include "SymbolsListener.h"
-#include "TypeCheckListener.h"
-#include "../common/code.h"
-#include "CodeGenListener.h"
+#include "../common/threadpool.h"
+#include "../common/compcache.h"
+#include "../common/sourcetext.h"
+#include "AslCompiler.h"
+#include "AslBatch.h"
+#include "AslTools.h"
+#include "AslOptions.h"
+#include "AslServer.h"
 
 #include <iostream>
-#include <fstream>    // ifstream
+#include <string>
+#include <memory>     // unique_ptr
 
-#include <cstdio>     // fopen
 #include <cstdlib>    // EXIT_FAILURE, EXIT_SUCCESS
+#include <unistd.h>   // STDIN_FILENO
 
 // using namespace std;
 // using namespace antlr4;
 
 
 int main(int argc, const char* argv[]) {
-  // check the correct use of the program
-  if (argc > 2) {
-    std::cout << "Usage: ./main [<file>]" << std::endl;
+  // check the correct use of the program (see commandLine)
+  commandLine cmd;
+  std::string error;
+  if (not parseCommandLine(argc, argv, cmd, error)) {
+    std::cout << error << std::endl;
+    printUsage(std::cout);
     return EXIT_FAILURE;
   }
-  if (argc == 2 and not std::fopen(argv[1], "r")) {
-    std::cout << "No such file: " << argv[1] << std::endl;
-    return EXIT_FAILURE;
-  }
-
-  // open input file (or std::cin) and create a character stream
-  antlr4::ANTLRInputStream input;
-  if (argc == 2) {  // reads from <file>
-    std::ifstream stream;
-    stream.open(argv[1]);
-    input = antlr4::ANTLRInputStream(stream);
-  }
-  else {            // reads fron std::cin
-    input = antlr4::ANTLRInputStream(std::cin);
+  if (not cmd.disassembled.empty())
+    return disassemble(cmd.disassembled);
+
+  driverOptions & options = cmd.options;
+  std::unique_ptr<compilationCache> cache;
+  if (not cmd.cacheDir.empty()) {
+    cache.reset(new compilationCache(cmd.cacheDir, cmd.cacheSize*1024*1024));
+    options.cache = cache.get();
   }
 
-  // create a lexer that consumes the character stream and produce a token stream
-  AslLexer lexer(&input);
-  antlr4::CommonTokenStream tokens(&lexer);
+  // the server has its own workers, each request compiled sequentially
+  if (not cmd.socketPath.empty())
+    return serveCompilations(cmd.socketPath, cmd.threads, options);
 
-  // create a parser that consumes the token stream, and parses it.
-  AslParser parser(&tokens);
+  std::unique_ptr<threadPool> pool;
+  if (cmd.parallel)
+    pool.reset(new threadPool(cmd.threads));
+  options.pool = pool.get();
 
-  // call the parser and get the parse tree
-  antlr4::tree::ParseTree *tree = parser.program();
+  if (cmd.batch)
+    return compileBatch(cmd.files, cmd.outputDir, options);
 
-  // check for lexical or syntactical errors
-  if (lexer.getNumberOfSyntaxErrors() > 0 or
-      parser.getNumberOfSyntaxErrors() > 0) {
-    std::cout << "Lexical and/or syntactical errors have been found." << std::endl;
+  // read the whole input file (or std::cin)
+  sourceText source;
+  bool file = not cmd.files.empty();
+  if (file ? not source.load(cmd.files[0]) : not source.load(STDIN_FILENO)) {
+    std::cout << "No such file: " << (file ? cmd.files[0] : "<stdin>") << std::endl;
     return EXIT_FAILURE;
   }
-
-  // print the parse tree (for debugging purposes)
-  // std::cout << tree->toStringTree(&parser) << std::endl;
-
-  // create a walker that will traverse the tree and do several things,
-  // like checking variable types or generating code.
-  antlr4::tree::ParseTreeWalker walker;
-
-  // Auxililary classes we are going to need to store information while
-  // traversing the tree. They are described below in this document
-  TypesMgr       types;
-  SymTable       symbols(types);
-  TreeDecoration decorations;
-  SemErrors      errors;
-
-  // Create a Listener that looks for variables and function declarations in the tree
-  // and stores required information
-  SymbolsListener symboldecl(types, symbols, decorations, errors);
-  // Traverse the tree using this listener, to collect information about declared identifiers
-  walker.walk(&symboldecl, tree);
-
-  // Create another Listener that will perform type checkings wherever it is needed
-  // (on expressions, assignments, parameter passing, etc)
-  TypeCheckListener typecheck(types, symbols, decorations, errors);
-  // Traverse the tree using this listener, so all types are checked
-  walker.walk(&typecheck, tree);
-
-  if (errors.getNumberOfSemanticErrors() > 0) {
-    std::cout << "There are semantic errors: no code generated." << std::endl;
-    return EXIT_FAILURE;
-  }
-
-  // Auxiliary class to store the code we will be creating
-  code mycode;
-  // Create a third listener that will generate code for each part of the tree
-  CodeGenListener codegenerator(types, symbols, decorations, mycode);
-  // Traverse the tree using this listener, so code is generated and stored in 'mycode'
-  walker.walk(&codegenerator, tree);
-
-  // print generated code as output
-  std::cout << mycode.dump() << std::endl;
-
-  return EXIT_SUCCESS;
+  if (cmd.tokens)
+    return listTokens(source.data(), source.size(), options.fastLexer);
+
+  // (the tables of a single compilation are kept in an arena)
+  arena memory;
+  compilationTables tables(&memory);
+  return compileSource(source.data(), source.size(), cmd.objfile, options, tables, std::cout, std::cerr) ?
+         EXIT_SUCCESS : EXIT_FAILURE;
 }
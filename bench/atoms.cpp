@@ -0,0 +1,206 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    atoms - Allocations made to get the identifiers and literals
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Counts the allocations (calls to operator new, and bytes) made to
+// lex a large program and to get the text of each identifier and
+// literal as the listeners do (once in each of the three passes) and
+// its atom as the SymTable does: before, with the tokens of the
+// CommonTokenFactory (the text is made by getText, and then
+// interned), and now, with those of the AslAtomTokenFactory (they are
+// interned once, as they are lexed, and each pass reads the text of
+// the atom). It is done with the AslLexer and with the AslFastLexer,
+// and it also counts the allocations of the AslRecursiveParser, that
+// interns them as it builds the AslAst, and those of the passes that
+// compile its AST (whose code has its operands in the same atom table
+// as the tokens). They are printed per token.
+//
+// usage: atoms [copies]            (copies of the examples, def. 20)
+
+#include "bench.h"
+#include "corpus.h"
+
+#include "AslLexer.h"
+#include "AslFastLexer.h"
+#include "AslAtomToken.h"
+#include "AslRecursiveParser.h"
+#include "AslAst.h"
+#include "SymbolsPass.h"
+#include "TypeCheckPass.h"
+#include "CodeGenPass.h"
+#include "antlr4-runtime.h"
+#include "bytestream.h"
+#include "atoms.h"
+#include "arena.h"
+#include "code.h"
+#include "SemErrors.h"
+
+#include <new>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+
+// using namespace std;
+
+
+// Allocations made so far (by any operator new of the program)
+static std::size_t allocations = 0, allocatedBytes = 0;
+
+void * operator new(std::size_t size) {
+  ++allocations;
+  allocatedBytes += size;
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+  std::free(p);
+}
+
+// Calls to operator new and bytes allocated by f
+struct counts {
+  std::size_t calls, bytes;
+};
+
+template <typename F>
+counts countAllocations(F f) {
+  std::size_t calls = allocations, bytes = allocatedBytes;
+  f();
+  return counts{allocations - calls, allocatedBytes - bytes};
+}
+
+// The listeners get the text of each identifier or literal once in
+// each of these passes
+static const unsigned PASSES = 3;
+
+static bool isAtomType(std::size_t type) {
+  return (type == AslLexer::ID or type == AslLexer::INTVAL or type == AslLexer::FLOATVAL or
+	  type == AslLexer::CHARS or type == AslLexer::STRING);
+}
+
+// Lexes with 'lexer' as a CommonTokenStream does (keeping all the
+// tokens), and then gets each text: with getText and interning it,
+// or, if 'atomTokens', from the atom of the token. Returns the number
+// of tokens (with the EOF)
+static std::size_t lexAndRead(antlr4::TokenSource & lexer, atomTable & atoms,
+                              bool atomTokens, std::size_t & checksum) {
+  std::vector<std::unique_ptr<antlr4::Token>> tokens;
+  do tokens.push_back(lexer.nextToken());
+  while (tokens.back()->getType() != antlr4::Token::EOF);
+  for (unsigned pass = 0; pass < PASSES; ++pass) {
+    for (auto & token : tokens) {
+      if (not isAtomType(token->getType())) continue;
+      if (atomTokens) {
+        AslAtomToken *t = static_cast<AslAtomToken *>(token.get());
+        checksum += t->getAtomText().size() + t->getAtom();
+      }
+      else {
+        std::string text = token->getText();
+        checksum += text.size() + atoms.intern(text);
+      }
+    }
+  }
+  return tokens.size();
+}
+
+int main(int argc, char *argv[]) {
+  unsigned copies = copiesArg(argc, argv, 20);
+  std::string source = scaledCorpus(copies);
+  std::size_t tokens = 0, checksum = 0;
+
+  auto antlrLexer = [&](bool atomTokens) {
+    return countAllocations([&] {
+      atomTable atoms;
+      antlr4::ANTLRInputStream input(source);
+      AslLexer lexer(&input);
+      if (atomTokens) lexer.setTokenFactory(std::make_shared<AslAtomTokenFactory>(atoms));
+      tokens = lexAndRead(lexer, atoms, atomTokens, checksum);
+    });
+  };
+  auto fastLexer = [&](bool atomTokens) {
+    return countAllocations([&] {
+      atomTable atoms;
+      byteCharStream input(source.data(), source.size());
+      AslFastLexer lexer(&input);
+      if (atomTokens) lexer.setTokenFactory(std::make_shared<AslAtomTokenFactory>(atoms, &input));
+      tokens = lexAndRead(lexer, atoms, atomTokens, checksum);
+    });
+  };
+  // the ANTLR lexers are run once before, to warm up their DFA caches
+  antlrLexer(false);
+  counts antlrBefore = antlrLexer(false), antlrNow = antlrLexer(true);
+  counts fastBefore = fastLexer(false), fastNow = fastLexer(true);
+  bool ok = true;
+  counts recursive = countAllocations([&] {
+    atomTable atoms;
+    byteCharStream input(source.data(), source.size());
+    AslAst ast(input.data(), atoms);
+    ok = AslRecursiveParser(&input).parse(ast);
+  });
+  counts passes{0, 0};
+  if (ok) {
+    atomTable atoms;
+    byteCharStream input(source.data(), source.size());
+    AslAst ast(input.data(), atoms);
+    AslRecursiveParser(&input).parse(ast);
+    std::ostringstream out;
+    passes = countAllocations([&] {
+      arena memory;
+      TypesMgr types(&memory);
+      SymTable symbols(types, atoms, &memory);
+      SemErrors errors(out);
+      code mycode(atoms, &memory, &out);
+      SymbolsPass(types, symbols, errors).walk(ast);
+      TypeCheckPass(types, symbols, errors).walk(ast);
+      CodeGenPass(types, symbols, mycode).walk(ast);
+    });
+    checksum += out.str().size();
+  }
+  if (not ok) {
+    std::cerr << "the corpus has syntax errors" << std::endl;
+    return 1;
+  }
+
+  auto print = [&](const std::string & what, counts c) {
+    report(what, double(c.calls) / tokens, "allocs/token");
+    report(what, double(c.bytes) / tokens, "bytes/token");
+  };
+  report("tokens", tokens);
+  print("AslLexer, getText", antlrBefore);
+  print("AslLexer, atom tokens", antlrNow);
+  print("AslFastLexer, getText", fastBefore);
+  print("AslFastLexer, atom tokens", fastNow);
+  print("AslRecursiveParser (lexing and parsing)", recursive);
+  print("SymbolsPass, TypeCheckPass and CodeGenPass", passes);
+  report("(checksum)", checksum);
+}
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    bench - Helpers shared by the benchmark drivers
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <glob.h>
+
+// using namespace std;
+
+
+// Directory of the examples, relative to bench/
+const std::string EXAMPLES = "../examples/";
+
+// Best wall time, in seconds, of 'runs' calls to f (the best one is
+// the one least disturbed by the rest of the machine)
+template <typename F>
+double bestTime(unsigned runs, F f) {
+  double best = 0;
+  for (unsigned i = 0; i < runs; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    if (i == 0 or elapsed.count() < best) best = elapsed.count();
+  }
+  return best;
+}
+
+// Contents of the file 'name' (empty if it can not be read)
+inline std::string readFile(const std::string & name) {
+  std::ifstream f(name, std::ios::binary);
+  std::ostringstream s;
+  s << f.rdbuf();
+  return s.str();
+}
+
+// Names of the files matching 'pattern', sorted
+inline std::vector<std::string> globFiles(const std::string & pattern) {
+  std::vector<std::string> names;
+  glob_t g;
+  if (glob(pattern.c_str(), 0, nullptr, &g) == 0)
+    names.assign(g.gl_pathv, g.gl_pathv + g.gl_pathc);
+  globfree(&g);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+// Prints one line of results: what was measured, its value and unit
+inline void report(const std::string & what, double value,
+                   const std::string & unit) {
+  std::cout << std::left << std::setw(44) << what << std::right
+            << std::fixed << std::setprecision(3) << std::setw(14)
+            << value << " " << unit << std::endl;
+}
+
+// Prints one line of results that is a count
+inline void report(const std::string & what, std::size_t count) {
+  std::cout << std::left << std::setw(44) << what << std::right
+            << std::setw(14) << count << std::endl;
+}
+
+// Number of copies given as the first argument (or 'def')
+inline unsigned copiesArg(int argc, char *argv[], unsigned def) {
+  return argc > 1 ? std::max(1, std::atoi(argv[1])) : def;
+}
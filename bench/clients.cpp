@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    clients - Load of concurrent clients on a compile server
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Connects to a compile server (asl --server <socket>) a number of
+// clients that send, each one through its own connection, compile
+// requests of the code generation examples, plus a number of idle
+// clients that never send anything. Prints the throughput seen by the
+// clients, and the statistics of the server (with its latencies).
+//
+// usage: clients <socket> [clients] [requests] [idle]
+//        (def. 4 clients of 200 requests each, and 8 idle clients)
+
+#include "bench.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// using namespace std;
+
+
+// Socket connected to the server at 'path' (-1 if it can not be)
+static int connectTo(const std::string & path) {
+  struct sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd >= 0 and
+      connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0) {
+    close(fd);
+    fd = -1;
+  }
+  return fd;
+}
+
+// Sends a request and reads its answer (status and body). Returns
+// false if the connection fails.
+static bool request(int fd, const std::string & message,
+                    std::string & status, std::string & body) {
+  for (std::size_t sent = 0; sent < message.size(); ) {
+    ssize_t n = write(fd, message.data() + sent, message.size() - sent);
+    if (n <= 0) return false;
+    sent += n;
+  }
+  std::string received;
+  char chunk[4096];
+  std::size_t eol;
+  while ((eol = received.find('\n')) == std::string::npos) {
+    ssize_t n = read(fd, chunk, sizeof(chunk));
+    if (n <= 0) return false;
+    received.append(chunk, n);
+  }
+  std::size_t blank = received.find(' ');
+  if (blank > eol) return false;
+  status = received.substr(0, blank);
+  std::size_t size = std::strtoul(received.c_str() + blank + 1, nullptr, 10);
+  while (received.size() < eol + 1 + size) {
+    ssize_t n = read(fd, chunk, sizeof(chunk));
+    if (n <= 0) return false;
+    received.append(chunk, n);
+  }
+  body = received.substr(eol + 1, size);
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: clients <socket> [clients] [requests] [idle]" << std::endl;
+    return 1;
+  }
+  std::string path = argv[1];
+  unsigned numClients = argc > 2 ? std::atoi(argv[2]) : 4;
+  unsigned numRequests = argc > 3 ? std::atoi(argv[3]) : 200;
+  unsigned numIdle = argc > 4 ? std::atoi(argv[4]) : 8;
+
+  std::vector<std::string> sources;
+  for (auto & name : globFiles(EXAMPLES + "jp*_genc_*.asl"))
+    sources.push_back(readFile(name));
+
+  std::vector<int> idle;
+  for (unsigned i = 0; i < numIdle; ++i) idle.push_back(connectTo(path));
+
+  std::atomic<unsigned> done(0), failed(0);
+  double secs = bestTime(1, [&] {
+      std::vector<std::thread> clients;
+      for (unsigned c = 0; c < numClients; ++c)
+        clients.emplace_back([&, c] {
+            int fd = connectTo(path);
+            std::string status, body;
+            for (unsigned i = 0; i < numRequests and fd >= 0; ++i) {
+              const std::string & source = sources[(c + i) % sources.size()];
+              if (not request(fd, "compile " + std::to_string(source.size()) + "\n" + source,
+                              status, body))
+                break;
+              ++done;
+              if (status != "ok") ++failed;
+            }
+            if (fd >= 0) close(fd);
+          });
+      for (auto & t : clients) t.join();
+    });
+  for (int fd : idle) if (fd >= 0) close(fd);
+
+  report("requests answered", done);
+  report("requests failed", failed);
+  report("throughput", done / secs, "requests/s");
+  int fd = connectTo(path);
+  std::string status, body;
+  if (fd >= 0 and request(fd, "stats\n", status, body))
+    std::cout << "server statistics:" << std::endl << body;
+  if (fd >= 0) close(fd);
+  return done == numClients * numRequests ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    corpus - Prints a large program made of copies of the examples
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Prints the program built by scaledCorpus, for the benchmark scripts
+// that run the whole compiler on it.
+//
+// usage: corpus [copies]           (copies of the examples, def. 20)
+
+#include "corpus.h"
+
+#include <iostream>
+
+// using namespace std;
+
+
+int main(int argc, char *argv[]) {
+  std::cout << scaledCorpus(copiesArg(argc, argv, 20));
+}
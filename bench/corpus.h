@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    corpus - Large Asl programs made of copies of the examples
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "bench.h"
+#include "AslFastLexer.h"
+#include "AslLexer.h"
+
+#include "../common/bytestream.h"
+
+#include <string>
+
+// using namespace std;
+
+
+// Source of one program made of 'copies' copies of the examples that
+// generate code (jp*_genc_*.asl). The identifiers of each copy of a
+// file get the suffix _<file>_<copy>, so that nothing clashes, and an
+// empty main is added at the end. The layout of the examples is kept,
+// so the corpus lexes and parses like them, only longer.
+inline std::string scaledCorpus(unsigned copies) {
+  std::vector<std::string> sources;
+  for (auto & name : globFiles(EXAMPLES + "jp*_genc_*.asl"))
+    sources.push_back(readFile(name));
+  std::string corpus;
+  for (unsigned k = 0; k < copies; ++k) {
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+      const std::string & s = sources[i];
+      std::string suffix = "_" + std::to_string(i) + "_" + std::to_string(k);
+      byteCharStream bytes(s.data(), s.size());
+      AslFastLexer lexer(&bytes);
+      std::size_t done = 0;
+      for (auto t = lexer.scan(); t.type != antlr4::Token::EOF; t = lexer.scan()) {
+        corpus.append(s, done, t.stop + 1 - done);
+        if (t.type == AslLexer::ID) corpus += suffix;
+        done = t.stop + 1;
+      }
+      corpus.append(s, done, std::string::npos);
+      corpus += "\n";
+    }
+  }
+  corpus += "func main()\nendfunc\n";
+  return corpus;
+}
@@ -0,0 +1,146 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    decorations - Cost of the tree decorations (maps vs. vectors)
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Parses a large program and times the accesses that the passes of
+// the compiler make to the attributes of the tree, with the attributes
+// stored as they were first (a ParseTreeProperty map for each of
+// them) and as they are now (TreeDecoration: vectors indexed by the
+// id of the node). Every node is visited bottom-up, as the exit
+// methods of the listeners do: it reads the attributes of its
+// children and writes its own ones.
+//
+// usage: decorations [copies]      (copies of the examples, def. 20)
+
+#include "bench.h"
+#include "corpus.h"
+
+#include "AslLexer.h"
+#include "AslParser.h"
+#include "antlr4-runtime.h"
+
+#include "../common/TreeDecoration.h"
+#include "../common/TypesMgr.h"
+#include "../common/SymTable.h"
+#include "../common/code.h"
+
+#include <string>
+#include <vector>
+
+// using namespace std;
+
+
+// The attributes as they were stored before TreeDecoration used
+// vectors: one map from the address of the node for each of them
+class mapDecoration {
+public:
+  TypesMgr::TypeId getType (antlr4::ParserRuleContext *ctx) { return TypeDecor.get(ctx); }
+  bool getIsLValue (antlr4::ParserRuleContext *ctx) { return IsLValueDecor.get(ctx); }
+  atomTable::atom getAddr (antlr4::ParserRuleContext *ctx) { return AddrDecor.get(ctx); }
+  atomTable::atom getOffset (antlr4::ParserRuleContext *ctx) { return OffsetDecor.get(ctx); }
+  instructionList getCode (antlr4::ParserRuleContext *ctx) { return CodeDecor.get(ctx); }
+  void putType (antlr4::ParserRuleContext *ctx, TypesMgr::TypeId t) { TypeDecor.put(ctx, t); }
+  void putIsLValue (antlr4::ParserRuleContext *ctx, bool b) { IsLValueDecor.put(ctx, b); }
+  void putAddr (antlr4::ParserRuleContext *ctx, atomTable::atom a) { AddrDecor.put(ctx, a); }
+  void putOffset (antlr4::ParserRuleContext *ctx, atomTable::atom o) { OffsetDecor.put(ctx, o); }
+  void putCode (antlr4::ParserRuleContext *ctx, const instructionList & c) { CodeDecor.put(ctx, c); }
+private:
+  antlr4::tree::ParseTreeProperty<TypesMgr::TypeId> TypeDecor;
+  antlr4::tree::ParseTreeProperty<bool>             IsLValueDecor;
+  antlr4::tree::ParseTreeProperty<atomTable::atom>  AddrDecor;
+  antlr4::tree::ParseTreeProperty<atomTable::atom>  OffsetDecor;
+  antlr4::tree::ParseTreeProperty<instructionList>  CodeDecor;
+};
+
+// The rule nodes of the tree, children before their parent
+static void postorder(antlr4::tree::ParseTree *node,
+                      std::vector<antlr4::ParserRuleContext *> & nodes) {
+  for (auto child : node->children) postorder(child, nodes);
+  if (auto ctx = dynamic_cast<antlr4::ParserRuleContext *>(node))
+    nodes.push_back(ctx);
+}
+
+// The accesses of a type check and a code generation pass
+template <typename Decoration>
+static void decorate(Decoration & decor,
+                     const std::vector<antlr4::ParserRuleContext *> & nodes) {
+  const instructionList one(instruction::NOOP());
+  TypesMgr::TypeId t = 0;
+  for (auto ctx : nodes) {
+    bool b = false;
+    for (auto child : ctx->children)
+      if (auto c = dynamic_cast<antlr4::ParserRuleContext *>(child)) {
+        t += decor.getType(c);
+        b = b or decor.getIsLValue(c);
+      }
+    decor.putType(ctx, t % 8);
+    decor.putIsLValue(ctx, b);
+  }
+  for (auto ctx : nodes) {
+    std::size_t n = 0;
+    for (auto child : ctx->children)
+      if (auto c = dynamic_cast<antlr4::ParserRuleContext *>(child))
+        n += decor.getAddr(c) + decor.getOffset(c) + decor.getCode(c).size();
+    decor.putAddr(ctx, atomTable::atom(n % 100));
+    decor.putOffset(ctx, atomTable::EMPTY);
+    decor.putCode(ctx, one);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  unsigned copies = copiesArg(argc, argv, 20);
+  std::string source = scaledCorpus(copies);
+
+  antlr4::ANTLRInputStream input(source);
+  AslLexer lexer(&input);
+  antlr4::CommonTokenStream tokens(&lexer);
+  AslParser parser(&tokens);
+  antlr4::tree::ParseTree *tree = parser.program();
+  if (parser.getNumberOfSyntaxErrors() > 0) {
+    std::cerr << "the corpus has syntax errors" << std::endl;
+    return 1;
+  }
+  std::vector<antlr4::ParserRuleContext *> nodes;
+  postorder(tree, nodes);
+
+  const unsigned RUNS = 5;
+  double maps = bestTime(RUNS, [&] {
+      mapDecoration decor;
+      decorate(decor, nodes);
+    });
+  double vectors = bestTime(RUNS, [&] {
+      TreeDecoration decor;
+      decor.numberNodes(tree);
+      decorate(decor, nodes);
+    });
+
+  report("nodes of the tree", nodes.size());
+  report("ParseTreeProperty maps", 1e9 * maps / nodes.size(), "ns/node");
+  report("TreeDecoration vectors (numbering included)",
+         1e9 * vectors / nodes.size(), "ns/node");
+  report("speedup", maps / vectors, "x");
+}
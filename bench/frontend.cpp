@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    frontend - Time from the source to a tree, by each front end
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Lexes and parses a large program with each front end of the
+// compiler, and prints the time of each: the AslLexer and the
+// AslParser (with SLL prediction, as the compiler tries first), the
+// AslFastLexer and the AslParser (--fast-lexer), and the
+// AslRecursiveParser, that builds an AslAst (--rd-parser). The DFA
+// caches of ANTLR are warmed up by a first parse that is not timed.
+//
+// usage: frontend [copies]         (copies of the examples, def. 20)
+
+#include "bench.h"
+#include "corpus.h"
+
+#include "AslLexer.h"
+#include "AslParser.h"
+#include "AslFastLexer.h"
+#include "AslRecursiveParser.h"
+#include "AslAst.h"
+#include "antlr4-runtime.h"
+#include "bytestream.h"
+#include "atoms.h"
+
+#include <string>
+
+// using namespace std;
+
+
+// Parses the tokens of 'lexer' with the AslParser, giving up at the
+// first error, and returns whether there were no syntax errors
+static bool parse(antlr4::TokenSource & lexer) {
+  antlr4::CommonTokenStream tokens(&lexer);
+  AslParser parser(&tokens);
+  parser.removeErrorListeners();
+  parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
+  parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+  try {
+    parser.program();
+  }
+  catch (antlr4::ParseCancellationException &) {
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned copies = copiesArg(argc, argv, 20);
+  std::string source = scaledCorpus(copies);
+
+  bool ok = true;
+  auto antlrFrontEnd = [&] {
+    antlr4::ANTLRInputStream input(source);
+    AslLexer lexer(&input);
+    ok = parse(lexer) and ok;
+  };
+  auto fastLexerFrontEnd = [&] {
+    byteCharStream input(source.data(), source.size());
+    AslFastLexer lexer(&input);
+    ok = parse(lexer) and ok;
+  };
+  auto recursiveFrontEnd = [&] {
+    byteCharStream input(source.data(), source.size());
+    atomTable atoms;
+    AslAst ast(input.data(), atoms);
+    ok = AslRecursiveParser(&input).parse(ast) and ok;
+  };
+  antlrFrontEnd();
+  fastLexerFrontEnd();
+  recursiveFrontEnd();
+  if (not ok) {
+    std::cerr << "the corpus has syntax errors" << std::endl;
+    return 1;
+  }
+
+  const unsigned RUNS = 3;
+  double antlr = bestTime(RUNS, antlrFrontEnd);
+  double fastLexer = bestTime(RUNS, fastLexerFrontEnd);
+  double recursive = bestTime(RUNS, recursiveFrontEnd);
+
+  report("bytes of source", source.size());
+  report("AslLexer and AslParser", 1e3 * antlr, "ms");
+  report("AslFastLexer and AslParser", 1e3 * fastLexer, "ms");
+  report("AslRecursiveParser", 1e3 * recursive, "ms");
+  report("speedup of --fast-lexer", antlr / fastLexer, "x");
+  report("speedup of --rd-parser", antlr / recursive, "x");
+}
@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    jumps - Cost of the jumps of a branch-heavy loop
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Builds a subroutine that is a loop made of many small blocks, each
+// one ending in a jump to the next one, and follows its jumps as an
+// interpreter would, finding the program counter of each target: by
+// the name of the label with a scan of the instructions (as it was
+// done first), by the handle of the label with get_label_pc, and with
+// the targets resolved by finalize. It prints the time per jump.
+//
+// usage: jumps [blocks]            (blocks of the loop, def. 500)
+
+#include "bench.h"
+
+#include "../common/code.h"
+
+#include <string>
+
+// using namespace std;
+
+
+// Program counter of the label 'lab' found with a scan of the
+// instructions of 'sub', comparing the texts
+static std::size_t scanLabel(const subroutine & sub, const std::string & lab) {
+  const atomTable & atoms = sub.get_atoms();
+  for (std::size_t pc = 0; pc < sub.get_num_instructions(); ++pc) {
+    const instruction & inst = sub.get_instruction_at(pc);
+    if (inst.oper == instruction::_LABEL and atoms.text(inst.arg1) == lab)
+      return pc;
+  }
+  return sub.get_num_instructions();
+}
+
+// Label of a jump
+static atomTable::atom jumpLabel(const instruction & inst) {
+  return inst.oper == instruction::_FJUMP ? inst.arg2 : inst.arg1;
+}
+
+// Follows 'jumps' jumps of the loop of 'sub' from its start, finding
+// each target with 'find', and returns the instructions executed
+template <typename Find>
+static std::size_t follow(const subroutine & sub, std::size_t jumps, Find find) {
+  std::size_t pc = 0, executed = 0;
+  while (jumps > 0) {
+    const instruction & inst = sub.get_instruction_at(pc);
+    ++executed;
+    if (inst.oper == instruction::_UJUMP or inst.oper == instruction::_FJUMP) {
+      pc = find(inst);
+      --jumps;
+    }
+    else ++pc;
+  }
+  return executed;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned blocks = copiesArg(argc, argv, 500);
+  atomTable atoms;
+  subroutine sub("loop", atoms);
+  atomTable::atom t1 = atoms.intern("%1"), t2 = atoms.intern("%2"), one = atoms.intern("1");
+  for (unsigned i = 0; i < blocks; ++i) {
+    atomTable::atom next = atoms.intern("L" + std::to_string((i + 1) % blocks));
+    sub.add_instruction(instruction::LABEL(atoms.intern("L" + std::to_string(i))));
+    sub.add_instruction(instruction::ADD(t1, t1, one));
+    if (i % 2) sub.add_instruction(instruction::FJUMP(t2, next));
+    else       sub.add_instruction(instruction::UJUMP(next));
+  }
+  sub.finalize();
+
+  const std::size_t JUMPS = 2000000;
+  const unsigned RUNS = 3;
+  std::size_t executed = 0;
+  double scan = bestTime(RUNS, [&] {
+      executed = follow(sub, JUMPS / 100, [&](const instruction & inst) {
+          return scanLabel(sub, atoms.text(jumpLabel(inst)));
+        });
+    }) * 100;
+  double index = bestTime(RUNS, [&] {
+      executed = follow(sub, JUMPS, [&](const instruction & inst) {
+          return sub.get_label_pc(jumpLabel(inst));
+        });
+    });
+  double resolved = bestTime(RUNS, [&] {
+      executed = follow(sub, JUMPS, [&](const instruction & inst) {
+          return inst.target;
+        });
+    });
+
+  report("instructions of the loop", sub.get_num_instructions());
+  report("instructions executed per run", executed);
+  report("label found with a scan (by name)", 1e9 * scan / JUMPS, "ns/jump");
+  report("label found with get_label_pc (by handle)", 1e9 * index / JUMPS, "ns/jump");
+  report("target resolved by finalize", 1e9 * resolved / JUMPS, "ns/jump");
+}
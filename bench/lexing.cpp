@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    lexing - Throughput of AslLexer and of AslFastLexer
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Lexes a large program with the AslLexer generated by ANTLR and with
+// the hand-written AslFastLexer, and prints the throughput of each
+// (megabytes and tokens per second). The DFA cache of the AslLexer is
+// warmed up by a first pass that is not timed. Both must give the
+// same number of tokens.
+//
+// usage: lexing [copies]           (copies of the examples, def. 20)
+
+#include "bench.h"
+#include "corpus.h"
+
+#include "AslLexer.h"
+#include "AslFastLexer.h"
+#include "antlr4-runtime.h"
+#include "bytestream.h"
+
+#include <string>
+
+// using namespace std;
+
+
+// Number of tokens that 'lexer' gives, up to the EOF (not counted)
+static std::size_t countTokens(antlr4::TokenSource & lexer) {
+  std::size_t n = 0;
+  while (lexer.nextToken()->getType() != antlr4::Token::EOF) ++n;
+  return n;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned copies = copiesArg(argc, argv, 20);
+  std::string source = scaledCorpus(copies);
+
+  std::size_t antlrTokens = 0, fastTokens = 0;
+  auto antlrLex = [&] {
+    antlr4::ANTLRInputStream input(source);
+    AslLexer lexer(&input);
+    antlrTokens = countTokens(lexer);
+  };
+  auto fastLex = [&] {
+    byteCharStream input(source.data(), source.size());
+    AslFastLexer lexer(&input);
+    fastTokens = countTokens(lexer);
+  };
+  antlrLex();
+  fastLex();
+  if (antlrTokens != fastTokens) {
+    std::cerr << "the lexers give " << antlrTokens << " and "
+              << fastTokens << " tokens" << std::endl;
+    return 1;
+  }
+
+  const unsigned RUNS = 3;
+  double antlr = bestTime(RUNS, antlrLex);
+  double fast = bestTime(RUNS, fastLex);
+
+  double megabytes = source.size() / (1024.0 * 1024.0);
+  report("bytes of source", source.size());
+  report("tokens", antlrTokens);
+  report("AslLexer", megabytes / antlr, "MB/s");
+  report("AslLexer", antlrTokens / antlr / 1e6, "Mtokens/s");
+  report("AslFastLexer", megabytes / fast, "MB/s");
+  report("AslFastLexer", fastTokens / fast / 1e6, "Mtokens/s");
+  report("speedup", antlr / fast, "x");
+}
@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    lookups - Searches of the SymTable per identifier checked
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Checks many identifiers as TypeCheckListener::exitIdent does, in a
+// table with a global scope of functions and the local scope of one
+// of them, and prints the searches and the time per identifier: with
+// the three calls it made first (findInStack, getType and
+// isFunctionClass), and with the single lookup it makes now. The map
+// searches are counted from the scope where each identifier is found
+// (at depth d): findInStack searches d+1 scopes, and each other call
+// searched d+1 scopes and then once more the scope found, before the
+// calls were built on lookup (that searches d+1 scopes).
+//
+// usage: lookups [millions]        (millions of identifiers, def. 1)
+
+#include "bench.h"
+
+#include "SymTable.h"
+#include "TypesMgr.h"
+#include "atoms.h"
+
+#include <string>
+#include <vector>
+
+// using namespace std;
+
+
+int main(int argc, char *argv[]) {
+  const std::size_t N = copiesArg(argc, argv, 1) * std::size_t(1000000);
+  const std::size_t FUNCTIONS = 50, PARAMETERS = 10, LOCALS = 20;
+
+  TypesMgr types;
+  atomTable atoms;
+  SymTable symbols(types, atoms);
+  TypesMgr::TypeId intTy = types.createIntegerTy();
+  std::vector<std::string> names;
+  symbols.pushNewScope("$global$");
+  for (std::size_t i = 0; i < FUNCTIONS; ++i) {
+    names.push_back("function_" + std::to_string(i));
+    symbols.addFunction(names.back(), types.createFunctionTy({}, intTy));
+  }
+  symbols.pushNewScope(names[0]);
+  for (std::size_t i = 0; i < PARAMETERS; ++i) {
+    names.push_back("param_" + std::to_string(i));
+    symbols.addParameter(names.back(), intTy);
+  }
+  for (std::size_t i = 0; i < LOCALS; ++i) {
+    names.push_back("local_" + std::to_string(i));
+    symbols.addLocalVar(names.back(), intTy);
+  }
+
+  // the identifiers checked: mostly variables, some calls
+  std::vector<const std::string *> idents(N);
+  for (std::size_t i = 0; i < N; ++i) {
+    std::size_t k = i * 7919;
+    idents[i] = &names[k % 5 == 0 ? k % FUNCTIONS : FUNCTIONS + k % (PARAMETERS + LOCALS)];
+  }
+  std::size_t before = 0, now = 0;
+  for (const std::string *ident : idents) {
+    std::size_t scopes = symbols.findInStack(*ident) + 1;
+    before += scopes + 2 * (scopes + 1);
+    now += scopes;
+  }
+
+  std::size_t checksum = 0;
+  double threeCalls = bestTime(3, [&] {
+      for (const std::string *ident : idents) {
+	if (symbols.findInStack(*ident) != -1)
+	  checksum += symbols.getType(*ident) + symbols.isFunctionClass(*ident);
+      }
+    });
+  double oneLookup = bestTime(3, [&] {
+      for (const std::string *ident : idents) {
+	SymTable::SymbolHandle symbol = symbols.lookup(*ident);
+	if (symbol.isFound())
+	  checksum += symbol.getType() + symbol.isFunctionClass();
+      }
+    });
+
+  report("identifiers", N);
+  report("map searches per identifier, before", double(before) / N, "searches");
+  report("map searches per identifier, now", double(now) / N, "searches");
+  report("findInStack, getType, isFunctionClass", 1e9 * threeCalls / N, "ns/ident");
+  report("lookup", 1e9 * oneLookup / N, "ns/ident");
+  report("speedup", threeCalls / oneLookup, "x");
+  report("(checksum)", checksum);
+}
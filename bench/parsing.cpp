@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    parsing - Time to parse with SLL and with full LL prediction
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Parses a large program with the full LL prediction of the parser (as
+// it was done first) and with the faster SLL prediction that the
+// compiler tries first, and prints the time of each. The tokens are
+// read before, so only the parsing is timed. The DFA cache of the
+// parser is warmed up by a first parse that is not timed.
+//
+// usage: parsing [copies]          (copies of the examples, def. 20)
+
+#include "bench.h"
+#include "corpus.h"
+
+#include "AslLexer.h"
+#include "AslParser.h"
+#include "antlr4-runtime.h"
+
+#include <string>
+
+// using namespace std;
+
+
+// Parses the tokens with the given prediction mode (giving up at the
+// first error with SLL, like the compiler does), and returns whether
+// there were no syntax errors
+static bool parse(antlr4::CommonTokenStream & tokens,
+                  antlr4::atn::PredictionMode mode) {
+  tokens.seek(0);
+  AslParser parser(&tokens);
+  parser.removeErrorListeners();
+  if (mode == antlr4::atn::PredictionMode::SLL)
+    parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
+  parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(mode);
+  try {
+    parser.program();
+  }
+  catch (antlr4::ParseCancellationException &) {
+    return false;
+  }
+  return parser.getNumberOfSyntaxErrors() == 0;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned copies = copiesArg(argc, argv, 20);
+  std::string source = scaledCorpus(copies);
+
+  antlr4::ANTLRInputStream input(source);
+  AslLexer lexer(&input);
+  antlr4::CommonTokenStream tokens(&lexer);
+  tokens.fill();
+  if (not parse(tokens, antlr4::atn::PredictionMode::LL)) {
+    std::cerr << "the corpus has syntax errors" << std::endl;
+    return 1;
+  }
+
+  const unsigned RUNS = 3;
+  double ll = bestTime(RUNS, [&] {
+      parse(tokens, antlr4::atn::PredictionMode::LL);
+    });
+  bool sllOk = parse(tokens, antlr4::atn::PredictionMode::SLL);
+  double sll = bestTime(RUNS, [&] {
+      parse(tokens, antlr4::atn::PredictionMode::SLL);
+    });
+
+  report("bytes of source", source.size());
+  report("tokens", tokens.size());
+  report("parsed by SLL (no fall back to LL)", std::size_t(sllOk));
+  report("full LL prediction", 1e3 * ll, "ms");
+  report("SLL prediction", 1e3 * sll, "ms");
+  report("speedup", ll / sll, "x");
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# Compiles a large program (see corpus.cpp) with three walks of the
+# parse tree (the default) and with a single fused walk (--fused), and
+# prints the time of each and, if perf is installed, the cache misses.
+# Both must give the same output, that is checked first.
+#
+# usage: ./passes.sh [copies]      (copies of the examples, def. 20)
+
+cd "$(dirname "$0")"
+make -s corpus || exit 1
+./corpus ${1:-20} > tmp-corpus.asl
+
+../asl/asl tmp-corpus.asl > tmp-passes.t
+../asl/asl --fused tmp-corpus.asl > tmp-fused.t
+if ! cmp -s tmp-passes.t tmp-fused.t; then
+    echo "asl and asl --fused give different outputs"
+    rm -f tmp-corpus.asl tmp-passes.t tmp-fused.t
+    exit 1
+fi
+rm -f tmp-passes.t tmp-fused.t
+
+for mode in "" "--fused"; do
+    echo "== asl $mode"
+    if command -v perf > /dev/null; then
+	perf stat -r 5 -e task-clock,cache-references,cache-misses \
+	     ../asl/asl $mode tmp-corpus.asl > /dev/null
+    else
+	time (for i in 1 2 3 4 5; do ../asl/asl $mode tmp-corpus.asl > /dev/null; done)
+    fi
+done
+rm -f tmp-corpus.asl
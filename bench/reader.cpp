@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    reader - Throughput of the t-code reader
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Reads the t-code of the examples (the .t files of examples/ and of
+// tvm/examples/) many times with read_code, and prints the throughput
+// in MB/s of text read, along with the one of loading the same code
+// from an object file (see objcode) for comparison.
+//
+// usage: reader [rounds]           (times each file is read, def. 200)
+
+#include "bench.h"
+
+#include "../common/code.h"
+#include "../common/codereader.h"
+#include "../common/objcode.h"
+
+#include <string>
+#include <vector>
+#include <cstdio>     // remove
+
+// using namespace std;
+
+
+int main(int argc, char *argv[]) {
+  unsigned rounds = copiesArg(argc, argv, 200);
+  std::vector<std::string> names = globFiles(EXAMPLES + "*.t");
+  for (auto & name : globFiles("../tvm/examples/*.t")) names.push_back(name);
+
+  std::vector<std::string> texts, objfiles;
+  std::size_t bytes = 0;
+  for (auto & name : names) {
+    texts.push_back(readFile(name));
+    bytes += texts.back().size();
+    atomTable atoms;
+    code c(atoms);
+    std::string error;
+    if (not read_code(texts.back().data(), texts.back().size(), c, error)) {
+      std::cerr << name << ": " << error << std::endl;
+      return 1;
+    }
+    objfiles.push_back("reader-" + std::to_string(objfiles.size()) + ".o");
+    write_objcode(c, objfiles.back());
+  }
+
+  const unsigned RUNS = 3;
+  double text = bestTime(RUNS, [&] {
+      for (unsigned k = 0; k < rounds; ++k)
+        for (auto & t : texts) {
+          atomTable atoms;
+          code c(atoms);
+          std::string error;
+          read_code(t.data(), t.size(), c, error);
+        }
+    });
+  double object = bestTime(RUNS, [&] {
+      for (unsigned k = 0; k < rounds; ++k)
+        for (auto & o : objfiles) {
+          objcode obj;
+          obj.load(o);
+          atomTable atoms;
+          code c(atoms);
+          obj.get_code(c);
+        }
+    });
+  for (auto & o : objfiles) std::remove(o.c_str());
+
+  double mb = double(bytes) * rounds / (1024 * 1024);
+  report("files", names.size());
+  report("MB of t-code read", mb, "MB");
+  report("read_code", mb / text, "MB/s");
+  report("objcode load and get_code (same code)", mb / object, "MB/s");
+}
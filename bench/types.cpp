@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    types - Creation and comparison of types in the TypesMgr
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+// Creates millions of array and function types in a TypesMgr with
+// a few shapes only, as the declarations of a large program do, and
+// prints how many types are kept (as they are hash-consed, one per
+// shape) and the time to create them and to compare them. Then it
+// creates millions of different array types, and prints the memory
+// they take and the time of the common queries on them.
+//
+// usage: types [millions]          (millions of types created, def. 1)
+
+#include "bench.h"
+
+#include "TypesMgr.h"
+#include "arena.h"
+
+#include <vector>
+
+// using namespace std;
+
+
+int main(int argc, char *argv[]) {
+  const std::size_t N = copiesArg(argc, argv, 1) * std::size_t(1000000);
+  // the shapes: arrays of 1 to 16 elements of int, and functions of
+  // 0 to 3 int parameters that return those arrays' elements
+  const std::size_t SHAPES = 16;
+
+  arena memory;
+  TypesMgr types(&memory);
+  TypesMgr::TypeId intTy = types.createIntegerTy();
+  std::vector<TypesMgr::TypeId> ids(2*N);
+  double create = bestTime(1, [&] {
+      for (std::size_t i = 0; i < N; ++i) {
+	ids[2*i] = types.createArrayTy(i % SHAPES + 1, intTy);
+	std::vector<TypesMgr::TypeId> params(i % 4, intTy);
+	ids[2*i+1] = types.createFunctionTy(params, intTy);
+      }
+    });
+  TypesMgr::TypeId largest = *std::max_element(ids.begin(), ids.end());
+
+  // each type against the one created SHAPES iterations later (the
+  // same shape) and the next one (another shape)
+  std::size_t equal = 0, compared = 0;
+  double compare = bestTime(3, [&] {
+      equal = compared = 0;
+      for (std::size_t i = 0; i + 2*SHAPES < 2*N; ++i, compared += 2)
+	equal += types.equalTypes(ids[i], ids[i + 2*SHAPES]) +
+	         types.equalTypes(ids[i], ids[i + 1]);
+    });
+
+  report("types created", 2*N);
+  report("types kept", largest + 1);
+  report("bytes taken from the arena", memory.bytes_allocated());
+  report("create", 1e9 * create / (2*N), "ns/type");
+  report("pairs compared", compared);
+  report("equal pairs", equal);
+  report("equalTypes", 1e9 * compare / compared, "ns/call");
+
+  // all different: arrays of 1 to N elements of int, float or char
+  arena distinctMemory;
+  TypesMgr distinct(&distinctMemory);
+  const TypesMgr::TypeId elems[] = {
+    distinct.createIntegerTy(), distinct.createFloatTy(), distinct.createCharacterTy()
+  };
+  double createDistinct = bestTime(1, [&] {
+      for (std::size_t i = 0; i < N; ++i)
+	ids[i] = distinct.createArrayTy(i + 1, elems[i % 3]);
+    });
+  // the queries of the type checks and the code generation, on the
+  // types in a scattered order (i * 7919 is a permutation modulo N
+  // if N is not a multiple of the prime 7919)
+  std::size_t sum = 0;
+  double query = bestTime(3, [&] {
+      sum = 0;
+      for (std::size_t i = 0; i < N; ++i) {
+	TypesMgr::TypeId t = ids[i * 7919 % N];
+	if (distinct.isArrayTy(t))
+	  sum += distinct.getSizeOfType(t) + distinct.isIntegerTy(distinct.getArrayElemType(t));
+      }
+    });
+
+  report("different array types", N);
+  report("bytes taken from the arena", distinctMemory.bytes_allocated());
+  report("bytes per type", double(distinctMemory.bytes_allocated()) / N, "bytes");
+  report("create", 1e9 * createDistinct / N, "ns/type");
+  report("isArrayTy, getSizeOfType, getArrayElemType", 1e9 * query / N, "ns/type");
+  report("(checksum)", sum);
+}
@@ -0,0 +1,56 @@
+//////////////////////////////////////////////////////////////////////
+//
+//    DecoratedContext - Parser tree nodes with an id,
+//                       for the Asl programming language
+//
+//    Copyright (C) 2018  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: José Miguel Rivero (rivero@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.110 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+//////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "antlr4-runtime.h"
+
+#include <cstddef>    // std::size_t
+
+// using namespace std;
+
+
+//////////////////////////////////////////////////////////////////////
+// Class DecoratedContext: base class of all the context classes
+// generated by antlr4 for the rules of the grammar (option
+// contextSuperClass in Asl.g4). Once the tree has been built,
+// TreeDecoration numbers its nodes with consecutive ids, so that
+// their attributes can be stored in vectors indexed by these ids.
+// The id 0 is not given to any node (it is the one of a null node).
+
+class DecoratedContext : public antlr4::ParserRuleContext {
+
+public:
+  // same constructors as antlr4::ParserRuleContext
+  using antlr4::ParserRuleContext::ParserRuleContext;
+
+  // id of the node (0 until the tree is numbered)
+  std::size_t nodeId = 0;
+
+};  // class DecoratedContext
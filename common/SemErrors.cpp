@@ -37,9 +37,12 @@
 // using namespace std;
 
 
+SemErrors::SemErrors(std::ostream & Out) : Out{&Out} {
+}
+
 void SemErrors::print() {
   std::sort(ErrorList.begin(), ErrorList.end(), less);  
-  for (auto & error : ErrorList) error.print();
+  for (auto & error : ErrorList) error.print(*Out);
 }
 
 bool SemErrors::less(const ErrorInfo & e1, const ErrorInfo & e2) {
@@ -51,97 +54,200 @@ std::size_t SemErrors::getNumberOfSemanticErrors() const {
   return ErrorList.size();
 }
 
+void SemErrors::append(const SemErrors & other) {
+  ErrorList.insert(ErrorList.end(), other.ErrorList.begin(), other.ErrorList.end());
+}
+
 void SemErrors::declaredIdent(antlr4::tree::TerminalNode *node) {
-  ErrorInfo error(node->getSymbol()->getLine(), node->getSymbol()->getCharPositionInLine(), "Identifier '" + node->getSymbol()->getText() + "' already declared.");
-  ErrorList.push_back(error);
+  declaredIdent(node->getSymbol()->getLine(), node->getSymbol()->getCharPositionInLine(),
+                node->getSymbol()->getText());
 }
 
 void SemErrors::undeclaredIdent(antlr4::tree::TerminalNode *node) {
-  ErrorInfo error(node->getSymbol()->getLine(), node->getSymbol()->getCharPositionInLine(), "Identifier '" + node->getSymbol()->getText() + "' is undeclared.");
-  ErrorList.push_back(error);
+  undeclaredIdent(node->getSymbol()->getLine(), node->getSymbol()->getCharPositionInLine(),
+                  node->getSymbol()->getText());
 }
 
 void SemErrors::incompatibleAssignment(antlr4::tree::TerminalNode *node) {
-  ErrorInfo error(node->getSymbol()->getLine(), node->getSymbol()->getCharPositionInLine(), "Assignment with incompatible types.");
-  ErrorList.push_back(error);
+  incompatibleAssignment(node->getSymbol()->getLine(), node->getSymbol()->getCharPositionInLine());
 }
 
 void SemErrors::nonReferenceableLeftExpr(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Left expression of assignment is not referenceable.");
-  ErrorList.push_back(error);
+  nonReferenceableLeftExpr(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine());
 }
 
 void SemErrors::incompatibleOperator(antlr4::Token* tok) {
-  ErrorInfo error(tok->getLine(), tok->getCharPositionInLine(), "Operator '" + tok->getText() + "' with incompatible types.");
-  ErrorList.push_back(error);
+  incompatibleOperator(tok->getLine(), tok->getCharPositionInLine(), tok->getText());
 }
 
 void SemErrors::nonArrayInArrayAccess(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Array access to a non array operand.");
-  ErrorList.push_back(error);
+  nonArrayInArrayAccess(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine());
 }
 
 void SemErrors::nonIntegerIndexInArrayAccess(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Array access witn non integer index.");
-  ErrorList.push_back(error);
+  nonIntegerIndexInArrayAccess(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine());
 }
 
 void SemErrors::booleanRequired(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Instruction '" + ctx->getStart()->getText() + "' requires a boolean condition.");
-  ErrorList.push_back(error);
+  booleanRequired(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(),
+                  ctx->getStart()->getText());
 }
 
 void SemErrors::isNotCallable(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Identifier '" + ctx->getStart()->getText() + "' is not a callable function.");
-  ErrorList.push_back(error);
+  isNotCallable(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(),
+                ctx->getStart()->getText());
 }
 
 void SemErrors::isNotProcedure(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Identifier '" + ctx->getStart()->getText() + "' is not a procedure.");
-  ErrorList.push_back(error);
+  isNotProcedure(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(),
+                 ctx->getStart()->getText());
 }
 
 void SemErrors::isNotFunction(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Identifier '" + ctx->getStart()->getText() + "' is a void returning function.");
-  ErrorList.push_back(error);
+  isNotFunction(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(),
+                ctx->getStart()->getText());
 }
 
 void SemErrors::numberOfParameters(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "The number of parameters in the call to '" + ctx->getStart()->getText() + "' does not match.");
-  ErrorList.push_back(error);
+  numberOfParameters(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(),
+                     ctx->getStart()->getText());
 }
 
 void SemErrors::incompatibleParameter(antlr4::ParserRuleContext *pCtx,
 				      unsigned int n,
 				      antlr4::ParserRuleContext *cCtx) {
-  ErrorInfo error(pCtx->getStart()->getLine(), pCtx->getStart()->getCharPositionInLine(), "Parameter #" + std::to_string(n) + " with incompatible types in call to '" + cCtx->getStart()->getText() + "'.");
-  ErrorList.push_back(error);
+  incompatibleParameter(pCtx->getStart()->getLine(), pCtx->getStart()->getCharPositionInLine(),
+                        n, cCtx->getStart()->getText());
 }
 
 void SemErrors::referenceableParameter(antlr4::ParserRuleContext *pCtx,
 				       unsigned int n,
 				       antlr4::ParserRuleContext *cCtx) {
-  ErrorInfo error(pCtx->getStart()->getLine(), pCtx->getStart()->getCharPositionInLine(), "Parameter #" + std::to_string(n) + " is expected to be referenceable in call to '" + cCtx->getStart()->getText() + "'.");
-  ErrorList.push_back(error);
+  referenceableParameter(pCtx->getStart()->getLine(), pCtx->getStart()->getCharPositionInLine(),
+                         n, cCtx->getStart()->getText());
 }
 
 void SemErrors::incompatibleReturn(antlr4::tree::TerminalNode *node) {
-  ErrorInfo error(node->getSymbol()->getLine(), node->getSymbol()->getCharPositionInLine(), "Return with incompatible type.");
-  ErrorList.push_back(error);
+  incompatibleReturn(node->getSymbol()->getLine(), node->getSymbol()->getCharPositionInLine());
 }
 
 void SemErrors::readWriteRequireBasic(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Basic type required in '" + ctx->getStart()->getText() + "'.");
-  ErrorList.push_back(error);
+  readWriteRequireBasic(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(),
+                        ctx->getStart()->getText());
 }
 
 void SemErrors::nonReferenceableExpression(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(), "Referenceable expression required in '" + ctx->getStart()->getText() + "'.");
-  ErrorList.push_back(error);
+  nonReferenceableExpression(ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine(),
+                             ctx->getStart()->getText());
 }
 
 void SemErrors::noMainProperlyDeclared(antlr4::ParserRuleContext *ctx) {
-  ErrorInfo error(ctx->getStop()->getLine(), ctx->getStop()->getCharPositionInLine(), "There is no 'main' function properly declared.");
+  noMainProperlyDeclared(ctx->getStop()->getLine(), ctx->getStop()->getCharPositionInLine());
+}
+
+// The messages are built here, from the position (and the text of the
+// token) that the methods above take from the nodes of the tree
+void SemErrors::declaredIdent(std::size_t line, std::size_t coln,
+                              const std::string & ident) {
+  ErrorInfo error(line, coln, "Identifier '" + ident + "' already declared.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::undeclaredIdent(std::size_t line, std::size_t coln,
+                                const std::string & ident) {
+  ErrorInfo error(line, coln, "Identifier '" + ident + "' is undeclared.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::incompatibleAssignment(std::size_t line, std::size_t coln) {
+  ErrorInfo error(line, coln, "Assignment with incompatible types.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::nonReferenceableLeftExpr(std::size_t line, std::size_t coln) {
+  ErrorInfo error(line, coln, "Left expression of assignment is not referenceable.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::incompatibleOperator(std::size_t line, std::size_t coln,
+                                     const std::string & oper) {
+  ErrorInfo error(line, coln, "Operator '" + oper + "' with incompatible types.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::nonArrayInArrayAccess(std::size_t line, std::size_t coln) {
+  ErrorInfo error(line, coln, "Array access to a non array operand.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::nonIntegerIndexInArrayAccess(std::size_t line, std::size_t coln) {
+  ErrorInfo error(line, coln, "Array access witn non integer index.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::booleanRequired(std::size_t line, std::size_t coln,
+                                const std::string & instruction) {
+  ErrorInfo error(line, coln, "Instruction '" + instruction + "' requires a boolean condition.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::isNotCallable(std::size_t line, std::size_t coln,
+                              const std::string & ident) {
+  ErrorInfo error(line, coln, "Identifier '" + ident + "' is not a callable function.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::isNotProcedure(std::size_t line, std::size_t coln,
+                               const std::string & ident) {
+  ErrorInfo error(line, coln, "Identifier '" + ident + "' is not a procedure.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::isNotFunction(std::size_t line, std::size_t coln,
+                              const std::string & ident) {
+  ErrorInfo error(line, coln, "Identifier '" + ident + "' is a void returning function.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::numberOfParameters(std::size_t line, std::size_t coln,
+                                   const std::string & ident) {
+  ErrorInfo error(line, coln, "The number of parameters in the call to '" + ident + "' does not match.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::incompatibleParameter(std::size_t line, std::size_t coln,
+                                      unsigned int n,
+                                      const std::string & ident) {
+  ErrorInfo error(line, coln, "Parameter #" + std::to_string(n) + " with incompatible types in call to '" + ident + "'.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::referenceableParameter(std::size_t line, std::size_t coln,
+                                       unsigned int n,
+                                       const std::string & ident) {
+  ErrorInfo error(line, coln, "Parameter #" + std::to_string(n) + " is expected to be referenceable in call to '" + ident + "'.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::incompatibleReturn(std::size_t line, std::size_t coln) {
+  ErrorInfo error(line, coln, "Return with incompatible type.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::readWriteRequireBasic(std::size_t line, std::size_t coln,
+                                      const std::string & instruction) {
+  ErrorInfo error(line, coln, "Basic type required in '" + instruction + "'.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::nonReferenceableExpression(std::size_t line, std::size_t coln,
+                                           const std::string & instruction) {
+  ErrorInfo error(line, coln, "Referenceable expression required in '" + instruction + "'.");
+  ErrorList.push_back(error);
+}
+
+void SemErrors::noMainProperlyDeclared(std::size_t line, std::size_t coln) {
+  ErrorInfo error(line, coln, "There is no 'main' function properly declared.");
   ErrorList.push_back(error);
 }
 
@@ -149,8 +255,8 @@ SemErrors::ErrorInfo::ErrorInfo(std::size_t line, std::size_t coln, std::string
   : line{line}, coln{coln}, message{message} {
 }
 
-void SemErrors::ErrorInfo::print() const {
-  std::cout << "Line " << line << ":" << coln << " error: " << message << std::endl;
+void SemErrors::ErrorInfo::print(std::ostream & out) const {
+  out << "Line " << line << ":" << coln << " error: " << message << std::endl;
 }
 
 std::size_t SemErrors::ErrorInfo::getLine() const {
@@ -32,6 +32,7 @@
 
 #include <string>
 #include <vector>
+#include <iostream>
 
 // using namespace std;
 
@@ -49,8 +50,8 @@ class SemErrors {
 
 public:
 
-  // Constructor
-  SemErrors() = default;
+  // Constructor (the errors are printed to Out)
+  SemErrors(std::ostream & Out = std::cout);
 
   // Write the semantic errors ordered by line number
   void print ();
@@ -58,6 +59,10 @@ public:
   // Accessor to get the number of semantic errors
   std::size_t getNumberOfSemanticErrors () const;
 
+  // Add (after the current ones) the errors stored in another object,
+  // e.g. the ones found checking a function in a separate thread
+  void append (const SemErrors & other);
+
   // Methods that store the error messages
   //   node is the terminal node correspondig to the token IDENT in a declaration
   void declaredIdent                (antlr4::tree::TerminalNode *node);
@@ -105,6 +110,33 @@ public:
   //   ctx is the program node (grammar start symbol) 
   void noMainProperlyDeclared       (antlr4::ParserRuleContext *ctx);
 
+  // The same methods, given the line and column where the error is
+  // localized (the first token of the node, or the token itself) and
+  // the text of that token when the message includes it. They are
+  // used by the passes on the AST built by AslRecursiveParser
+  void declaredIdent                (std::size_t line, std::size_t coln, const std::string & ident);
+  void undeclaredIdent              (std::size_t line, std::size_t coln, const std::string & ident);
+  void incompatibleAssignment       (std::size_t line, std::size_t coln);
+  void nonReferenceableLeftExpr     (std::size_t line, std::size_t coln);
+  void incompatibleOperator         (std::size_t line, std::size_t coln, const std::string & oper);
+  void nonArrayInArrayAccess        (std::size_t line, std::size_t coln);
+  void nonIntegerIndexInArrayAccess (std::size_t line, std::size_t coln);
+  void booleanRequired              (std::size_t line, std::size_t coln, const std::string & instruction);
+  void isNotCallable                (std::size_t line, std::size_t coln, const std::string & ident);
+  void isNotProcedure               (std::size_t line, std::size_t coln, const std::string & ident);
+  void isNotFunction                (std::size_t line, std::size_t coln, const std::string & ident);
+  void numberOfParameters           (std::size_t line, std::size_t coln, const std::string & ident);
+  //   n is the number of argument, and ident the name of the function called
+  void incompatibleParameter        (std::size_t line, std::size_t coln, unsigned int n,
+				     const std::string & ident);
+  void referenceableParameter       (std::size_t line, std::size_t coln, unsigned int n,
+				     const std::string & ident);
+  void incompatibleReturn           (std::size_t line, std::size_t coln);
+  void readWriteRequireBasic        (std::size_t line, std::size_t coln, const std::string & instruction);
+  void nonReferenceableExpression   (std::size_t line, std::size_t coln, const std::string & instruction);
+  //   the position is the one of the end of file
+  void noMainProperlyDeclared       (std::size_t line, std::size_t coln);
+
 
 private:
 
@@ -114,7 +146,7 @@ private:
     ErrorInfo(std::size_t line, std::size_t coln, std::string message);
     std::size_t getLine() const;
     std::size_t getColumnInLine() const;
-    void print() const;
+    void print(std::ostream & out) const;
   private:
     std::size_t line, coln;
     std::string message;
@@ -123,6 +155,9 @@ private:
   // List of semantic errors
   std::vector<ErrorInfo> ErrorList;
 
+  // Stream where the errors are printed
+  std::ostream * Out;
+
   // Compare two errors to determine the order (needed in print)
   static bool less(const ErrorInfo & e1, const ErrorInfo & e2);
 
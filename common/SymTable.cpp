@@ -42,15 +42,33 @@
 
 
 // Constructor
-SymTable::SymTable(TypesMgr & Types) :
-  Types{Types} {
+SymTable::SymTable(TypesMgr & Types, atomTable & Atoms, arena * Memory) :
+  Types{Types},
+  Atoms(Atoms),
+  Memory{Memory},
+  OwnScopesVec(arena_allocator<ScopeInfo>(Memory)),
+  ScopesVec(OwnScopesVec) {
+}
+
+SymTable::SymTable(TypesMgr & Types, SymTable & Shared) :
+  Types{Types},
+  Atoms(Shared.Atoms),
+  Memory{Shared.Memory},
+  ScopesVec(Shared.ScopesVec) {
+}
+
+// Removes all the scopes
+void SymTable::clear() {
+  assert(&ScopesVec == &OwnScopesVec);
+  ScopesVec.clear();
+  ScopeIdsStack.clear();
 }
 
 // Creates a new scope, push its ScopeId in the stack
 // and returns this ScopeId.
 SymTable::ScopeId SymTable::pushNewScope(const std::string & name) {
   ScopeId currScope = ScopesVec.size();
-  ScopesVec.push_back(ScopeInfo(name));
+  ScopesVec.push_back(ScopeInfo(name, Memory));
   ScopeIdsStack.push_back(currScope);
   return currScope;
 }
@@ -75,6 +93,12 @@ SymTable::ScopeId SymTable::topScope() const {
 
 // Returns true if ident occurs in the current scope (top of the stack)
 bool SymTable::findInCurrentScope(const std::string & ident) const {
+  // an ident with no atom has not been declared anywhere
+  Atom atom;
+  return Atoms.find(ident, atom) and findInCurrentScope(atom);
+}
+
+bool SymTable::findInCurrentScope(Atom ident) const {
   assert(not ScopeIdsStack.empty());
   ScopeId currScope = ScopeIdsStack.back();
   assert(currScope < ScopesVec.size());
@@ -87,32 +111,67 @@ bool SymTable::findInCurrentScope(const std::string & ident) const {
 // Returns -1 if te symbol is not found.
 int SymTable::findInStack(const std::string & ident) const {
   assert(not ScopeIdsStack.empty());
+  Atom atom;
+  if (not Atoms.find(ident, atom))
+    return -1;
   int d = 0;
   for (int i = ScopeIdsStack.size() - 1; i >= 0; --i) {
     ScopeId sc = ScopeIdsStack[i];
     assert(sc < ScopesVec.size());
-    if (ScopesVec[sc].findSymbol(ident))
+    if (ScopesVec[sc].findSymbol(atom))
       return d;
     ++d;
   }
   return -1;
 }
 
-// Adds a new symbol in the current scope.
+// Returns the handle of ident in the innermost scope of the stack
+// where it occurs, walking the stack only once. If it is not found
+// the handle is not found (and its type is 'error').
+SymTable::SymbolHandle SymTable::lookup(const std::string & ident) const {
+  Atom atom;
+  if (not Atoms.find(ident, atom))
+    return SymbolHandle();
+  return lookup(atom);
+}
+
+SymTable::SymbolHandle SymTable::lookup(Atom ident) const {
+  assert(not ScopeIdsStack.empty());
+  for (int i = ScopeIdsStack.size() - 1; i >= 0; --i) {
+    ScopeId sc = ScopeIdsStack[i];
+    assert(sc < ScopesVec.size());
+    SymbolHandle symbol = ScopesVec[sc].lookup(ident, sc);
+    if (symbol.isFound())
+      return symbol;
+  }
+  return SymbolHandle();
+}
+
+// Adds a new symbol in the current scope (interning its ident).
 void SymTable::addLocalVar(const std::string & ident, TypesMgr::TypeId type) {
+  addLocalVar(Atoms.intern(ident), type);
+}
+void SymTable::addParameter(const std::string & ident, TypesMgr::TypeId type) {
+  addParameter(Atoms.intern(ident), type);
+}
+void SymTable::addFunction(const std::string & ident, TypesMgr::TypeId type) {
+  addFunction(Atoms.intern(ident), type);
+}
+
+void SymTable::addLocalVar(Atom ident, TypesMgr::TypeId type) {
   assert(not ScopeIdsStack.empty());
   ScopeId currScope = ScopeIdsStack.back();
   assert(currScope < ScopesVec.size());
   ScopesVec[currScope].addLocalVar(ident, type);
 }
-void SymTable::addParameter(const std::string & ident, TypesMgr::TypeId type) {
+void SymTable::addParameter(Atom ident, TypesMgr::TypeId type) {
   assert(not ScopeIdsStack.empty());
   ScopeId currScope = ScopeIdsStack.back();
   assert(currScope < ScopesVec.size());
   ScopesVec[currScope].addParameter(ident, type);
 }
 
-void SymTable::addFunction(const std::string & ident, TypesMgr::TypeId type) {
+void SymTable::addFunction(Atom ident, TypesMgr::TypeId type) {
   assert(not ScopeIdsStack.empty());
   ScopeId currScope = ScopeIdsStack.back();
   assert(currScope < ScopesVec.size());
@@ -121,47 +180,22 @@ void SymTable::addFunction(const std::string & ident, TypesMgr::TypeId type) {
 
 // Check the class of a symbol. If not found return false
 bool SymTable::isLocalVarClass(const std::string & ident) const {
-  assert(not ScopeIdsStack.empty());
-  for (int i = ScopeIdsStack.size() - 1; i >= 0; --i) {
-    ScopeId sc = ScopeIdsStack[i];
-    assert(sc < ScopesVec.size());
-    if (ScopesVec[sc].findSymbol(ident))
-      return ScopesVec[sc].isLocalVarClass(ident);
-  }
-  return false;
+  return lookup(ident).isLocalVarClass();
 }
 
 bool SymTable::isParameterClass(const std::string & ident) const {
-  assert(not ScopeIdsStack.empty());
-  for (int i = ScopeIdsStack.size() - 1; i >= 0; --i) {
-    ScopeId sc = ScopeIdsStack[i];
-    assert(sc < ScopesVec.size());
-    if (ScopesVec[sc].findSymbol(ident))
-      return ScopesVec[sc].isParameterClass(ident);
-  }
-  return false;
+  return lookup(ident).isParameterClass();
 }
 
 bool SymTable::isFunctionClass(const std::string & ident) const {
-  assert(not ScopeIdsStack.empty());
-  for (int i = ScopeIdsStack.size() - 1; i >= 0; --i) {
-    ScopeId sc = ScopeIdsStack[i];
-    assert(sc < ScopesVec.size());
-    if (ScopesVec[sc].findSymbol(ident))
-      return ScopesVec[sc].isFunctionClass(ident);
-  }
-  return false;
+  return lookup(ident).isFunctionClass();
 }
 
 // Get the TypeId of a symbol. If not found return type 'error'
 TypesMgr::TypeId SymTable::getType(const std::string & ident) const {
-  assert(not ScopeIdsStack.empty());
-  for (int i = ScopeIdsStack.size() - 1; i >= 0; --i) {
-    ScopeId sc = ScopeIdsStack[i];
-    assert(sc < ScopesVec.size());
-    if (ScopesVec[sc].findSymbol(ident))
-      return ScopesVec[sc].getType(ident);
-  }
+  SymbolHandle symbol = lookup(ident);
+  if (symbol.isFound())
+    return symbol.getType();
   return Types.createErrorTy();
 }
 
@@ -180,7 +214,7 @@ void SymTable::printCurrentScope() const {
   assert(not ScopeIdsStack.empty());
   ScopeId currScope = ScopeIdsStack.back();
   assert(currScope < ScopesVec.size());
-  ScopesVec[currScope].print(Types);
+  ScopesVec[currScope].print(Types, Atoms);
 }
 
 // Write the contents of the symbol table on the standard output
@@ -189,7 +223,7 @@ void SymTable::print() const {
   for (int i = ScopeIdsStack.size() - 1; i >= 0; --i) {
     ScopeId sc = ScopeIdsStack[i];
     assert(sc < ScopesVec.size());
-    ScopesVec[sc].print(Types);
+    ScopesVec[sc].print(Types, Atoms);
   }
   std::cout << "----------------" << std::endl;
 }
@@ -198,10 +232,12 @@ bool SymTable::noMainProperlyDeclared() const {
   assert(not ScopeIdsStack.empty());
   ScopeId currScope = ScopeIdsStack.back();
   assert(currScope < ScopesVec.size());
-  if ((not ScopesVec[currScope].findSymbol("main")) or
-      (not ScopesVec[currScope].isFunctionClass("main")))
+  Atom mainAtom;
+  if ((not Atoms.find("main", mainAtom)) or
+      (not ScopesVec[currScope].findSymbol(mainAtom)) or
+      (not ScopesVec[currScope].isFunctionClass(mainAtom)))
     return true;
-  TypesMgr::TypeId tid = ScopesVec[currScope].getType("main");
+  TypesMgr::TypeId tid = ScopesVec[currScope].getType(mainAtom);
   if (Types.isFunctionTy(tid) and
       (Types.getNumOfParameters(tid) == 0) and
       Types.isVoidFunction(tid))
@@ -213,8 +249,11 @@ bool SymTable::noMainProperlyDeclared() const {
 // class SymTable::ScopeInfo ==============================================================
 
 // Constructor
-SymTable::ScopeInfo::ScopeInfo(const std::string & name)
-  : name{name} { }
+SymTable::ScopeInfo::ScopeInfo(const std::string & name, arena * Memory)
+  : name{name},
+    SymbolsMap(0, std::hash<Atom>(), std::equal_to<Atom>(),
+               arena_allocator<std::pair<const Atom, SymbolInfo>>(Memory)),
+    IdentsList(arena_allocator<Atom>(Memory)) { }
 
 // Accessors to work with the attributes: name, SymbolsMap, IdentsList
 std::string SymTable::ScopeInfo::getName() const {
@@ -222,41 +261,63 @@ std::string SymTable::ScopeInfo::getName() const {
 }
 
 // Mutators to add symbols to the scope
-void SymTable::ScopeInfo::addLocalVar(const std::string & ident, TypesMgr::TypeId type) {
+void SymTable::ScopeInfo::addLocalVar(Atom ident, TypesMgr::TypeId type) {
   assert(SymbolsMap.find(ident) == SymbolsMap.end());
-  SymbolsMap[ident] = SymbolInfo::createLocalVar(type);
+  SymbolInfo info = SymbolInfo::createLocalVar(type);
+  info.setSlot(IdentsList.size());
+  SymbolsMap[ident] = info;
   IdentsList.push_back(ident);
 }
-void SymTable::ScopeInfo::addParameter(const std::string & ident, TypesMgr::TypeId type) {
+void SymTable::ScopeInfo::addParameter(Atom ident, TypesMgr::TypeId type) {
   assert(SymbolsMap.find(ident) == SymbolsMap.end());
-  SymbolsMap[ident] = SymbolInfo::createParameter(type);
+  SymbolInfo info = SymbolInfo::createParameter(type);
+  info.setSlot(IdentsList.size());
+  SymbolsMap[ident] = info;
   IdentsList.push_back(ident);
 }
-void SymTable::ScopeInfo::addFunction(const std::string & ident, TypesMgr::TypeId type) {
+void SymTable::ScopeInfo::addFunction(Atom ident, TypesMgr::TypeId type) {
   assert(SymbolsMap.find(ident) == SymbolsMap.end());
-  SymbolsMap[ident] = SymbolInfo::createFunction(type);
+  SymbolInfo info = SymbolInfo::createFunction(type);
+  info.setSlot(IdentsList.size());
+  SymbolsMap[ident] = info;
   IdentsList.push_back(ident);
 }
 
 // Accessor to check the existence of a symbol
-bool SymTable::ScopeInfo::findSymbol(const std::string & ident) const {
+bool SymTable::ScopeInfo::findSymbol(Atom ident) const {
   return (SymbolsMap.find(ident) != SymbolsMap.end());
 }
 
+// Accessor to get the handle of a symbol with a single search
+SymTable::SymbolHandle SymTable::ScopeInfo::lookup(Atom ident, ScopeId sc) const {
+  auto const & it = SymbolsMap.find(ident);
+  if (it == SymbolsMap.end())
+    return SymbolHandle();
+  const SymbolInfo & info = it->second;
+  SymbolHandle::SymbolClass symClass = SymbolHandle::NotFound;
+  if (info.isLocalVarClass())
+    symClass = SymbolHandle::LocalVarClass;
+  else if (info.isParameterClass())
+    symClass = SymbolHandle::ParameterClass;
+  else if (info.isFunctionClass())
+    symClass = SymbolHandle::FunctionClass;
+  return SymbolHandle(sc, info.getSlot(), symClass, info.getType());
+}
+
 // Accessors to check the class of the symbol. If not found return false
-bool SymTable::ScopeInfo::isLocalVarClass(const std::string & ident) const {
+bool SymTable::ScopeInfo::isLocalVarClass(Atom ident) const {
   auto const & it = SymbolsMap.find(ident);
   if (it == SymbolsMap.end())
     return false;
   return it->second.isLocalVarClass();
 }
-bool SymTable::ScopeInfo::isParameterClass(const std::string & ident) const {
+bool SymTable::ScopeInfo::isParameterClass(Atom ident) const {
   auto const & it = SymbolsMap.find(ident);
   if (it == SymbolsMap.end())
     return false;
   return it->second.isParameterClass();
 }
-bool SymTable::ScopeInfo::isFunctionClass(const std::string & ident) const {
+bool SymTable::ScopeInfo::isFunctionClass(Atom ident) const {
   auto const & it = SymbolsMap.find(ident);
   if (it == SymbolsMap.end())
     return false;
@@ -264,18 +325,18 @@ bool SymTable::ScopeInfo::isFunctionClass(const std::string & ident) const {
 }
 
 // Accessor to get the TypeId of a symbol. The symbol MUST exist.
-TypesMgr::TypeId SymTable::ScopeInfo::getType(const std::string & ident) const {
+TypesMgr::TypeId SymTable::ScopeInfo::getType(Atom ident) const {
   assert(SymbolsMap.find(ident) != SymbolsMap.end());
   auto const & it = SymbolsMap.find(ident);
   return it->second.getType();
 }
 
 // Writes the contents of the scope to the standard output.
-void SymTable::ScopeInfo::print(TypesMgr & Types) const {
+void SymTable::ScopeInfo::print(TypesMgr & Types, const atomTable & Atoms) const {
   std::cout << "---------------- scope name: " << name << std::endl;
-  for (auto & id : IdentsList) {
+  for (auto id : IdentsList) {
     auto const & it = SymbolsMap.find(id);
-    std::cout << id << ":" << it->second.class2string();
+    std::cout << Atoms.text(id) << ":" << it->second.class2string();
     if (not it->second.isErrorClass()) {
       std::cout << "," << Types.to_string(it->second.getType());
     }
@@ -288,13 +349,21 @@ void SymTable::ScopeInfo::print(TypesMgr & Types) const {
 
 // Constructors
 SymTable::ScopeInfo::SymbolInfo::SymbolInfo()
-  : classId{ErrorClassId} {
+  : classId{ErrorClassId}, slot{0} {
 }
 SymTable::ScopeInfo::SymbolInfo::SymbolInfo(SymClassId c, TypesMgr::TypeId tid)
-  : classId{c}, type{tid} {
+  : classId{c}, type{tid}, slot{0} {
     assert(FirstSymClassId < c and c < LastSymClassId);
 }
 
+// Accessor/Mutator to the slot
+std::size_t SymTable::ScopeInfo::SymbolInfo::getSlot() const {
+  return slot;
+}
+void SymTable::ScopeInfo::SymbolInfo::setSlot(std::size_t n) {
+  slot = n;
+}
+
 // Accessors for working with the attributes: class and type
 bool SymTable::ScopeInfo::SymbolInfo::isLocalVarClass() const {
   return classId == LocalVarId;
@@ -336,3 +405,38 @@ SymTable::ScopeInfo::SymbolInfo SymTable::ScopeInfo::SymbolInfo::createParameter
 SymTable::ScopeInfo::SymbolInfo SymTable::ScopeInfo::SymbolInfo::createFunction(TypesMgr::TypeId type) {
   return SymbolInfo(SymClassId::FunctionId, type);
 }
+
+
+// class SymTable::SymbolHandle ==========================================================
+
+// Constructors
+SymTable::SymbolHandle::SymbolHandle()
+  : scope{0}, slot{0}, symClass{NotFound}, type{0} {
+}
+SymTable::SymbolHandle::SymbolHandle(ScopeId scope, std::size_t slot, SymbolClass symClass,
+				     TypesMgr::TypeId type)
+  : scope{scope}, slot{slot}, symClass{symClass}, type{type} {
+}
+
+// Accessors to the attributes of the symbol
+bool SymTable::SymbolHandle::isFound() const {
+  return symClass != NotFound;
+}
+bool SymTable::SymbolHandle::isLocalVarClass() const {
+  return symClass == LocalVarClass;
+}
+bool SymTable::SymbolHandle::isParameterClass() const {
+  return symClass == ParameterClass;
+}
+bool SymTable::SymbolHandle::isFunctionClass() const {
+  return symClass == FunctionClass;
+}
+TypesMgr::TypeId SymTable::SymbolHandle::getType() const {
+  return type;
+}
+SymTable::ScopeId SymTable::SymbolHandle::getScope() const {
+  return scope;
+}
+std::size_t SymTable::SymbolHandle::getSlot() const {
+  return slot;
+}
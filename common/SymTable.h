@@ -29,9 +29,13 @@
 #pragma once
 
 #include "TypesMgr.h"
+#include "arena.h"
+#include "atoms.h"
 
 #include <string>
-#include <map>
+#include <unordered_map>
+#include <functional> // std::hash, std::equal_to
+#include <utility>    // std::pair
 #include <vector>
 
 #include <cstddef>    // std::size_t
@@ -57,6 +61,10 @@
 // scopes that determines which symbols are visible and
 // which are not. Entering in a function will push a new
 // scope to the stack and exiting will pop the stack.
+// The symbols are kept by their atom, the number of their text in
+// the atom table of the compilation (see atomTable), so they are
+// compared as integers. Each method taking the text of an ident has
+// a version taking its atom, that does not search the atom table.
 
 class SymTable {
 
@@ -65,10 +73,64 @@ public:
   // The ScopeId is an index in a vector
   typedef std::size_t ScopeId;
 
-  // Constructor
-  SymTable(TypesMgr & Types);
+  // The Atom of an ident is its number in the atom table
+  typedef atomTable::atom Atom;
+
+  //////////////////////////////////////////////////////////////////
+  // Class SymbolHandle: what lookup finds about a symbol, that is
+  // the scope where it is declared, its class, its type and its slot
+  // (the order of its declaration in the scope). It is a small value,
+  // copied out of the table, so it can be kept (e.g. as a decoration
+  // of the tree) and queried with no further search.
+  class SymbolHandle {
+  public:
+    enum SymbolClass : unsigned char {
+      NotFound,                   // symbol not declared
+      LocalVarClass,
+      ParameterClass,
+      FunctionClass
+    };
+
+    // Constructors of the handle of a symbol not found (with type
+    // 'error', that is the TypeId 0) and of a symbol found
+    SymbolHandle ();
+    SymbolHandle (ScopeId scope, std::size_t slot, SymbolClass symClass,
+		  TypesMgr::TypeId type);
+
+    // Accessors to the attributes of the symbol
+    bool             isFound          () const;
+    bool             isLocalVarClass  () const;
+    bool             isParameterClass () const;
+    bool             isFunctionClass  () const;
+    TypesMgr::TypeId getType          () const;
+    ScopeId          getScope         () const;
+    std::size_t      getSlot          () const;
+
+  private:
+    ScopeId          scope;
+    std::size_t      slot;
+    SymbolClass      symClass;
+    TypesMgr::TypeId type;
+
+  };  // class SymbolHandle
+
+  // Constructor (with the atom table of the idents, that must
+  // outlive it, and the arena its scopes are allocated in, or null
+  // for the general heap)
+  SymTable(TypesMgr & Types, atomTable & Atoms, arena * Memory = nullptr);
+  // Constructor of a view of the scopes of Shared (that must outlive
+  // it), with its own stack and current function type. Several views
+  // of a complete table can be used at the same time by different
+  // threads, as long as no scope or symbol (nor atom) is added to it
+  SymTable(TypesMgr & Types, SymTable & Shared);
+  // No copies (a view would be shared by mistake)
+  SymTable(const SymTable &) = delete;
+  SymTable & operator=(const SymTable &) = delete;
   // Destructor
   ~SymTable() = default;
+  // Remove all the scopes, keeping the memory of the table (so it can
+  // be reused by another compilation). Only for a table, not a view
+  void clear ();
 
   // Manage the stack of scopes
   //   - create a new empty scope and push its ScopeId in the stack
@@ -83,16 +145,26 @@ public:
   // Methods to find an ident
   //   - in the current scope (top of the stack)
   bool    findInCurrentScope (const std::string & ident)             const;
+  bool    findInCurrentScope (Atom ident)                            const;
   //   - in the whole stack. Returns the number of scopes skipped to
                           // find the symbol, or -1 if it is not found
   int     findInStack        (const std::string & ident)             const;
+  //   - in the whole stack, getting all its information at once (a
+  //     handle not found if it is not in any scope)
+  SymbolHandle lookup        (const std::string & ident)             const;
+  SymbolHandle lookup        (Atom ident)                            const;
 
   // Adds a new symbol in the current scope
   void addLocalVar  (const std::string & ident, TypesMgr::TypeId type);
   void addParameter (const std::string & ident, TypesMgr::TypeId type);
   void addFunction  (const std::string & ident, TypesMgr::TypeId type);
+  void addLocalVar  (Atom ident, TypesMgr::TypeId type);
+  void addParameter (Atom ident, TypesMgr::TypeId type);
+  void addFunction  (Atom ident, TypesMgr::TypeId type);
 
   // Accessors to check the class of the symbol. If not found return false
+  // (each one is a lookup: to ask several things about the same symbol,
+  // use the handle that lookup returns)
   bool isLocalVarClass  (const std::string & ident) const;
   bool isParameterClass (const std::string & ident) const;
   bool isFunctionClass  (const std::string & ident) const;
@@ -120,7 +192,11 @@ private:
 
   // Attributes:
   TypesMgr               & Types;
-  std::vector<ScopeInfo>   ScopesVec;
+  atomTable              & Atoms;
+  arena                  * Memory;
+  std::vector<ScopeInfo, arena_allocator<ScopeInfo>> OwnScopesVec;
+  // the own scopes, or the ones of the table this is a view of
+  std::vector<ScopeInfo, arena_allocator<ScopeInfo>> & ScopesVec;
   std::vector<ScopeId>     ScopeIdsStack;
   // Current function type, established by TypeCheckListener
   TypesMgr::TypeId         currFunctionType;
@@ -134,29 +210,34 @@ private:
   public:
     // Constructor
     ScopeInfo () = delete;
-    ScopeInfo (const std::string & name);
+    ScopeInfo (const std::string & name, arena * Memory);
 
     // Accessor to get the name of the scope
     std::string getName () const;
 
     // Mutators to add symbols to the scope
-    void addLocalVar  (const std::string & ident, TypesMgr::TypeId type);
-    void addParameter (const std::string & ident, TypesMgr::TypeId type);
-    void addFunction  (const std::string & ident, TypesMgr::TypeId type);
+    void addLocalVar  (Atom ident, TypesMgr::TypeId type);
+    void addParameter (Atom ident, TypesMgr::TypeId type);
+    void addFunction  (Atom ident, TypesMgr::TypeId type);
 
     // Accessor to check the existence of a symbol
-    bool findSymbol (const std::string & ident) const;
+    bool findSymbol (Atom ident) const;
+    // Accessor to get the handle of a symbol of this scope (whose
+    // ScopeId is sc), with a single search. If not found, returns
+    // a handle not found
+    SymbolHandle lookup (Atom ident, ScopeId sc) const;
 
     // Accessors to check the class of the symbol. If not found return false
-    bool isLocalVarClass  (const std::string & ident) const;
-    bool isParameterClass (const std::string & ident) const;
-    bool isFunctionClass  (const std::string & ident) const;
+    bool isLocalVarClass  (Atom ident) const;
+    bool isParameterClass (Atom ident) const;
+    bool isFunctionClass  (Atom ident) const;
 
     // Accessor to get the TypeId of a symbol. The symbol MUST exist
-    TypesMgr::TypeId getType (const std::string & ident) const;
+    TypesMgr::TypeId getType (Atom ident) const;
 
-    // Writes the contents of the scope to the standard output
-    void print (TypesMgr & Types) const;
+    // Writes the contents of the scope (whose idents are in Atoms)
+    // to the standard output
+    void print (TypesMgr & Types, const atomTable & Atoms) const;
 
   private:
 
@@ -166,9 +247,11 @@ private:
     // For the name of the scope
     std::string name;
     // The information associated to each identifier declared in this scope.
-    std::map<std::string, SymbolInfo> SymbolsMap;
+    // (allocated, like the rest of the table, in its arena)
+    std::unordered_map<Atom, SymbolInfo, std::hash<Atom>, std::equal_to<Atom>,
+                       arena_allocator<std::pair<const Atom, SymbolInfo>>> SymbolsMap;
     // For remember the order in which the Ids where introduced.
-    std::vector<std::string> IdentsList;
+    std::vector<Atom, arena_allocator<Atom>> IdentsList;
 
 
     //////////////////////////////////////////////////////////////////
@@ -193,6 +276,10 @@ private:
       SymbolInfo ();
       SymbolInfo (SymClassId c, TypesMgr::TypeId tid);
 
+      // Accessor/Mutator to the slot (the order of its declaration in the scope)
+      std::size_t      getSlot          () const;
+      void             setSlot          (std::size_t n);
+
       // Accessors for working with the symbol attributes: class and type
       bool             isLocalVarClass  () const;
       bool             isParameterClass () const;
@@ -211,6 +298,7 @@ private:
     private:
       SymClassId       classId;
       TypesMgr::TypeId type;
+      std::size_t      slot;
 
     };  // class SymbolInfo
 
@@ -28,63 +28,137 @@
 //////////////////////////////////////////////////////////////////////
 
 #include "TreeDecoration.h"
+#include "DecoratedContext.h"
 
 #include "TypesMgr.h"
 #include "SymTable.h"
 #include "code.h"
 
-#include "antlr4-runtime.h"
 #include "antlr4-runtime.h"
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <cassert>
+
+
+// Numbering of the tree nodes (in preorder, starting at 1):
+void TreeDecoration::numberNodes(antlr4::tree::ParseTree *tree) {
+  std::size_t lastId = 0;
+  std::vector<antlr4::tree::ParseTree *> pending(1, tree);
+  while (not pending.empty()) {
+    antlr4::tree::ParseTree *node = pending.back();
+    pending.pop_back();
+    DecoratedContext *ctx = dynamic_cast<DecoratedContext *>(node);
+    if (not ctx) continue;  // terminal nodes have no attributes
+    ctx->nodeId = ++lastId;
+    pending.insert(pending.end(), node->children.rbegin(), node->children.rend());
+  }
+  ScopeDecor.assign(lastId+1, SymTable::ScopeId());
+  TypeDecor.assign(lastId+1, TypesMgr::TypeId());
+  IsLValueDecor.assign(lastId+1, false);
+  SymbolDecor.assign(lastId+1, SymTable::SymbolHandle());
+  AddrDecor.assign(lastId+1, atomTable::EMPTY);
+  OffsetDecor.assign(lastId+1, atomTable::EMPTY);
+  CodeDecor.assign(lastId+1, instructionList());
+#ifdef CHECK_TAKEN_CODE
+  TakenCode.assign(lastId+1, false);
+#endif
+}
 
+std::size_t TreeDecoration::nodeId(antlr4::ParserRuleContext *ctx) {
+  if (not ctx) return 0;
+  std::size_t id = static_cast<DecoratedContext *>(ctx)->nodeId;
+  assert(id != 0 and "node without id: call TreeDecoration::numberNodes first");
+  return id;
+}
 
 // Getters:
 SymTable::ScopeId TreeDecoration::getScope(antlr4::ParserRuleContext *ctx) {
-  return ScopeDecor.get(ctx);
+  return ScopeDecor[nodeId(ctx)];
 }
 
 TypesMgr::TypeId TreeDecoration::getType(antlr4::ParserRuleContext *ctx) {
-  return TypeDecor.get(ctx);
+  return TypeDecor[nodeId(ctx)];
 }
 
 bool TreeDecoration::getIsLValue(antlr4::ParserRuleContext *ctx) {
-  return IsLValueDecor.get(ctx);
+  return IsLValueDecor[nodeId(ctx)];
 }
 
-std::string TreeDecoration::getAddr(antlr4::ParserRuleContext *ctx) {
-  return AddrDecor.get(ctx);
+SymTable::SymbolHandle TreeDecoration::getSymbol(antlr4::ParserRuleContext *ctx) {
+  return SymbolDecor[nodeId(ctx)];
 }
 
-std::string TreeDecoration::getOffset(antlr4::ParserRuleContext *ctx) {
-  return OffsetDecor.get(ctx);
+atomTable::atom TreeDecoration::getAddr(antlr4::ParserRuleContext *ctx) {
+  return AddrDecor[nodeId(ctx)];
+}
+
+atomTable::atom TreeDecoration::getOffset(antlr4::ParserRuleContext *ctx) {
+  return OffsetDecor[nodeId(ctx)];
 }
 
 instructionList TreeDecoration::getCode(antlr4::ParserRuleContext *ctx) {
-  return CodeDecor.get(ctx);
+#ifdef CHECK_TAKEN_CODE
+  checkNotTaken(ctx);
+#endif
+  return CodeDecor[nodeId(ctx)];
+}
+
+instructionList TreeDecoration::takeCode(antlr4::ParserRuleContext *ctx) {
+#ifdef CHECK_TAKEN_CODE
+  checkNotTaken(ctx);
+  TakenCode[nodeId(ctx)] = true;
+#endif
+  instructionList & slot = CodeDecor[nodeId(ctx)];
+  instructionList code = std::move(slot);
+  slot.clear();
+  return code;
 }
 
 // Setters:
 void TreeDecoration::putScope(antlr4::ParserRuleContext *ctx, SymTable::ScopeId s) {
-  ScopeDecor.put(ctx, s);
+  ScopeDecor[nodeId(ctx)] = s;
 }
 
 void TreeDecoration::putType(antlr4::ParserRuleContext *ctx, TypesMgr::TypeId t) {
-  TypeDecor.put(ctx, t);
+  TypeDecor[nodeId(ctx)] = t;
 }
 
 void TreeDecoration::putIsLValue(antlr4::ParserRuleContext *ctx, bool b) {
-  IsLValueDecor.put(ctx, b);
+  IsLValueDecor[nodeId(ctx)] = b;
 }
 
-void TreeDecoration::putAddr(antlr4::ParserRuleContext *ctx, const std::string & a) {
-  AddrDecor.put(ctx, a);
+void TreeDecoration::putSymbol(antlr4::ParserRuleContext *ctx, const SymTable::SymbolHandle & s) {
+  SymbolDecor[nodeId(ctx)] = s;
 }
 
-void TreeDecoration::putOffset(antlr4::ParserRuleContext *ctx, const std::string & o) {
-  OffsetDecor.put(ctx, o);
+void TreeDecoration::putAddr(antlr4::ParserRuleContext *ctx, atomTable::atom a) {
+  AddrDecor[nodeId(ctx)] = a;
+}
+
+void TreeDecoration::putOffset(antlr4::ParserRuleContext *ctx, atomTable::atom o) {
+  OffsetDecor[nodeId(ctx)] = o;
 }
 
 void TreeDecoration::putCode(antlr4::ParserRuleContext *ctx, const instructionList & c) {
-  CodeDecor.put(ctx, c);
+#ifdef CHECK_TAKEN_CODE
+  TakenCode[nodeId(ctx)] = false;
+#endif
+  CodeDecor[nodeId(ctx)] = c;
+}
+
+void TreeDecoration::putCode(antlr4::ParserRuleContext *ctx, instructionList && c) {
+#ifdef CHECK_TAKEN_CODE
+  TakenCode[nodeId(ctx)] = false;
+#endif
+  CodeDecor[nodeId(ctx)] = std::move(c);
+}
+
+#ifdef CHECK_TAKEN_CODE
+// The code of a node is consumed by its parent: reading it again
+// would silently give an empty list
+void TreeDecoration::checkNotTaken(antlr4::ParserRuleContext *ctx) {
+  assert(not TakenCode[nodeId(ctx)] and "code attribute read after being taken");
 }
+#endif
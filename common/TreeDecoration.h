@@ -33,8 +33,18 @@
 #include "SymTable.h"
 #include "code.h"
 
+#include "DecoratedContext.h"
+
 #include "antlr4-runtime.h"
-#include "tree/ParseTreeProperty.h"
+
+#include <cstddef>    // std::size_t
+#include <string>
+#include <vector>
+
+// If CHECK_TAKEN_CODE is defined (make CHECK_TAKEN_CODE=1, that
+// rebuilds everything with -DCHECK_TAKEN_CODE), it is checked (with
+// assert) that the code attribute of a node is never accessed again
+// after being taken
 
 // using namespace std;
 
@@ -43,15 +53,22 @@
 // Class TreeDecoration: the nodes of the parser tree generated
 // by the antlr4 parser, whose base type is
 // antlr4::ParserRuleContext *, can have different attributes.
-// TreeDecoration groups all of them, and uses different
-// ParseTreeProperty to save this information.
-// Currently six kinds of attributes may be present:
+// TreeDecoration groups all of them. Each kind of attribute is
+// saved in a vector indexed by the id of the node (see class
+// DecoratedContext), so the tree must be numbered with numberNodes
+// before any attribute is stored.
+// Currently seven kinds of attributes may be present:
 //   - scope, for nodes like the program, or functions
 //   - type, for expressions or type especification
 //   - isLValue, for expressions
-//   - addr, for expressions
-//   - offset, for expressions
+//   - symbol, the handle of the symbol an identifier refers to (and
+//     of the expressions whose addr is that identifier)
+//   - addr, for expressions (the atom of its operand in the code)
+//   - offset, for expressions (idem)
 //   - code, for practicaly any node
+// The code attribute is meant to be moved from each node to its
+// parent: takeCode returns it and releases the node's slot, so that
+// only the code of the nodes not yet consumed is kept in memory.
 // Different listeners set and access these attributes:
 //   - SymbolsListener     [TypeCheck phase 1]
 //       * set and access the scope attribute
@@ -60,9 +77,11 @@
 //       * access the scope attribute
 //       * set and access the type attribute (in expressions)
 //       * set and access the isLValue attribute (in expressions)
+//       * set the symbol attribute (in identifiers)
 //   - CodeGenListener     [Code Generation]
 //       * access the scope attribute
 //       * access the type attribute
+//       * access the symbol attribute (and pass it up along the addr)
 //       * set and access the addr, offset and code attributes
 
 class TreeDecoration {
@@ -70,28 +89,48 @@ class TreeDecoration {
 public:
   TreeDecoration() = default;
 
+  // Give consecutive ids to the nodes of the tree (once it has been
+  // built by the parser) and make room for their attributes
+  void numberNodes (antlr4::tree::ParseTree *tree);
+
   // Getters:
   SymTable::ScopeId getScope    (antlr4::ParserRuleContext *ctx);
   TypesMgr::TypeId  getType     (antlr4::ParserRuleContext *ctx);
   bool              getIsLValue (antlr4::ParserRuleContext *ctx);
-  std::string       getAddr     (antlr4::ParserRuleContext *ctx);
-  std::string       getOffset   (antlr4::ParserRuleContext *ctx);
+  SymTable::SymbolHandle getSymbol (antlr4::ParserRuleContext *ctx);
+  atomTable::atom   getAddr     (antlr4::ParserRuleContext *ctx);
+  atomTable::atom   getOffset   (antlr4::ParserRuleContext *ctx);
   instructionList   getCode     (antlr4::ParserRuleContext *ctx);
+  // Getter that moves the code out and releases its slot:
+  instructionList   takeCode    (antlr4::ParserRuleContext *ctx);
 
   // Setters:
   void putScope    (antlr4::ParserRuleContext *ctx, SymTable::ScopeId s);
   void putType     (antlr4::ParserRuleContext *ctx, TypesMgr::TypeId t);
   void putIsLValue (antlr4::ParserRuleContext *ctx, bool b);
-  void putAddr     (antlr4::ParserRuleContext *ctx, const std::string & a);
-  void putOffset   (antlr4::ParserRuleContext *ctx, const std::string & o);
+  void putSymbol   (antlr4::ParserRuleContext *ctx, const SymTable::SymbolHandle & s);
+  void putAddr     (antlr4::ParserRuleContext *ctx, atomTable::atom a);
+  void putOffset   (antlr4::ParserRuleContext *ctx, atomTable::atom o);
   void putCode     (antlr4::ParserRuleContext *ctx, const instructionList & c);
+  void putCode     (antlr4::ParserRuleContext *ctx, instructionList && c);
 
 private:
-  antlr4::tree::ParseTreeProperty<SymTable::ScopeId> ScopeDecor;
-  antlr4::tree::ParseTreeProperty<TypesMgr::TypeId>  TypeDecor;
-  antlr4::tree::ParseTreeProperty<bool>              IsLValueDecor;
-  antlr4::tree::ParseTreeProperty<std::string>       AddrDecor;
-  antlr4::tree::ParseTreeProperty<std::string>       OffsetDecor;
-  antlr4::tree::ParseTreeProperty<instructionList>   CodeDecor;
+  // id of the node, that is the position of its attributes in the
+  // vectors below (a null node has id 0)
+  std::size_t nodeId (antlr4::ParserRuleContext *ctx);
+
+  std::vector<SymTable::ScopeId> ScopeDecor;
+  std::vector<TypesMgr::TypeId>  TypeDecor;
+  std::vector<char>              IsLValueDecor;
+  std::vector<SymTable::SymbolHandle> SymbolDecor;
+  std::vector<atomTable::atom>   AddrDecor;
+  std::vector<atomTable::atom>   OffsetDecor;
+  std::vector<instructionList>   CodeDecor;
+
+#ifdef CHECK_TAKEN_CODE
+  // whether the code attribute of each node has already been taken
+  std::vector<char> TakenCode;
+  void checkNotTaken (antlr4::ParserRuleContext *ctx);
+#endif
 
 };  // class TreeDecoration
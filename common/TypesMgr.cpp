@@ -33,7 +33,9 @@
 #include <string>
 #include <iostream>
 
+#include <algorithm>  // std::equal
 #include <cstddef>    // std::size_t
+#include <cstdint>    // UINT32_MAX
 // uncomment to disable assert()
 // #define NDEBUG
 #include <cassert>
@@ -44,12 +46,23 @@
 // ======================================================================
 // class TypesMgr
 
+// hash of a compound type: its kind and the numbers of its structure
+// (sizes and TypeId's of the component types) combined one by one
+static std::size_t hashCombine(std::size_t seed, std::size_t value) {
+  return seed ^ (std::hash<std::size_t>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
 // ----------------------------------------------------------------------
 // constructor
 
-TypesMgr::TypesMgr() {
+TypesMgr::TypesMgr(arena * Memory) :
+  TypesVec(arena_allocator<Type>(Memory)),
+  ParamsPool(arena_allocator<TypeId>(Memory)),
+  TypesIndex(0, std::hash<std::size_t>(), std::equal_to<std::size_t>(),
+	     arena_allocator<std::pair<const std::size_t, TypeId>>(Memory)) {
+  static_assert(sizeof(Type) == 16, "a Type must be a quarter of a cache line");
   // Prebuilt and insert in TypesVec the Type's of the primitive types
-  TypesVec = std::vector<Type>(NumPrimitiveAndErrorTypes);
+  TypesVec.resize(NumPrimitiveAndErrorTypes);
   TypesVec[ErrorTyId]     = Type(TypeKind::ErrorKind);
   TypesVec[IntegerTyId]   = Type(TypeKind::IntegerKind);
   TypesVec[FloatTyId]     = Type(TypeKind::FloatKind);
@@ -58,6 +71,12 @@ TypesMgr::TypesMgr() {
   TypesVec[VoidTyId]      = Type(TypeKind::VoidKind);
 }
 
+void TypesMgr::clear() {
+  TypesVec.resize(NumPrimitiveAndErrorTypes);
+  ParamsPool.clear();
+  TypesIndex.clear();
+}
+
 // ----------------------------------------------------------------------
 // methods to create a Type and return its TypeId
 
@@ -87,13 +106,34 @@ TypesMgr::TypeId TypesMgr::createVoidTy() {
 
 TypesMgr::TypeId TypesMgr::createFunctionTy(const std::vector<TypeId> & paramsTypes,
 					    TypeId returnType) {
-  TypesVec.push_back(Type(paramsTypes, returnType));
+  std::size_t hash = hashCombine(TypeKind::FunctionKind, returnType);
+  for (TypeId tid : paramsTypes) hash = hashCombine(hash, tid);
+  auto range = TypesIndex.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Type & t = TypesVec[it->second];
+    if (t.isFunctionTy() and t.getFuncReturnType() == returnType and
+	t.getNumOfParameters() == paramsTypes.size() and
+	std::equal(paramsTypes.begin(), paramsTypes.end(), ParamsPool.begin() + t.getFirstParameter()))
+      return it->second;
+  }
+  std::size_t firstParam = ParamsPool.size();
+  ParamsPool.insert(ParamsPool.end(), paramsTypes.begin(), paramsTypes.end());
+  TypesVec.push_back(Type(firstParam, paramsTypes.size(), returnType));
+  TypesIndex.emplace(hash, TypesVec.size()-1);
   return TypesVec.size()-1;
 }
 
 TypesMgr::TypeId TypesMgr::createArrayTy(unsigned int size,
 					 TypeId elemType) {
+  std::size_t hash = hashCombine(hashCombine(TypeKind::ArrayKind, size), elemType);
+  auto range = TypesIndex.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Type & t = TypesVec[it->second];
+    if (t.isArrayTy() and t.getArraySize() == size and t.getArrayElemType() == elemType)
+      return it->second;
+  }
   TypesVec.push_back(Type{size, elemType});
+  TypesIndex.emplace(hash, TypesVec.size()-1);
   return TypesVec.size()-1;
 }
 
@@ -146,10 +186,11 @@ bool TypesMgr::isFunctionTy(TypeId tid) const {
   return t.isFunctionTy();
 }
 
-const std::vector<TypesMgr::TypeId> & TypesMgr::getFuncParamsTypes(TypeId tid) const {
+std::vector<TypesMgr::TypeId> TypesMgr::getFuncParamsTypes(TypeId tid) const {
   const Type & t = TypesVec.at(tid);
   assert(t.isFunctionTy());
-  return t.getFuncParamsTypes();
+  auto first = ParamsPool.begin() + t.getFirstParameter();
+  return std::vector<TypeId>(first, first + t.getNumOfParameters());
 }
 
 TypesMgr::TypeId TypesMgr::getFuncReturnType(TypeId tid) const {
@@ -167,7 +208,7 @@ std::size_t TypesMgr::getNumOfParameters(TypeId tid) const {
 TypesMgr::TypeId TypesMgr::getParameterType(TypeId tid, unsigned int i) const {
   const Type & t = TypesVec.at(tid);
   assert(t.isFunctionTy() and i < t.getNumOfParameters());
-  return t.getParameterType(i);
+  return ParamsPool[t.getFirstParameter() + i];
 }
 
 bool TypesMgr::isVoidFunction(TypeId tid) const {
@@ -201,38 +242,9 @@ TypesMgr::TypeId TypesMgr::getArrayElemType(TypeId tid) const {
 // methods for checking different compatibilities of Types
 
 bool TypesMgr::equalTypes(TypeId tid1, TypeId tid2) const {
-  if (tid1 == tid2)
-    return true;
-  const Type & t1 = TypesVec.at(tid1);
-  const Type & t2 = TypesVec.at(tid2);
-  if (t1.getTypeKind() != t2.getTypeKind())
-    return false;
-  if (t1.isPrimitiveTy() and t2.isPrimitiveTy())
-    return true;
-  if (t1.isFunctionTy()) {  // or: if (t2.isFunctionTy()) {
-    if (t1.getNumOfParameters() != t2.getNumOfParameters())
-      return false;
-    TypeId tid1_aux;
-    TypeId tid2_aux;
-    for (unsigned int i = 0; i < t1.getNumOfParameters(); ++i) {
-      tid1_aux = t1.getParameterType(i);
-      tid2_aux = t2.getParameterType(i);
-      if (not equalTypes(tid1_aux, tid2_aux))
-	return false;
-    }
-    tid1_aux = t1.getFuncReturnType();
-    tid2_aux = t2.getFuncReturnType();
-    return equalTypes(tid1_aux, tid2_aux);
-  }
-  if (t1.isArrayTy()) {  // or: if (t2.isArrayTy()) {
-    if (t1.getArraySize() != t2.getArraySize()) {
-      return false;
-    }
-    TypeId tid1_aux = t1.getArrayElemType();
-    TypeId tid2_aux = t2.getArrayElemType();
-    return equalTypes(tid1_aux, tid2_aux);
-  }
-  return false;
+  // the components of a compound type are created before it, so by
+  // induction equal structures have been given the same TypeId
+  return tid1 == tid2;
 }
 
 bool TypesMgr::comparableTypes(TypeId tid1, TypeId tid2,
@@ -289,11 +301,11 @@ std::string TypesMgr::to_string(TypeId tid) const {
     TypeId tid1;
     std::string s = "function<";
     if (t.getNumOfParameters() > 0) {
-      tid1 = t.getParameterType(0);
+      tid1 = getParameterType(tid, 0);
       s = s + to_string(tid1);
     }
     for (unsigned int i = 1; i < t.getNumOfParameters(); ++i) {
-      tid1 = t.getParameterType(i);
+      tid1 = getParameterType(tid, i);
       s = s + "," + to_string(tid1);
     }
     tid1 = t.getFuncReturnType();
@@ -323,22 +335,30 @@ void TypesMgr::dump(TypeId tid, std::ostream & os) const {
 // ----------------------------------------------------------------------
 // constructors
 
-TypesMgr::Type::Type(TypeKind tid) : ID{tid} {
+TypesMgr::Type::Type(TypeKind tid) :
+  ID{tid},
+  numParams{0},
+  arraySize{0},
+  subTy{0} {
   assert(TypeKind::FirstPrimitiveKind < ID and
 	 ID < TypeKind::LastPrimitiveKind);
 }
 
-TypesMgr::Type::Type(const std::vector<TypeId> & paramsTypes, TypeId returnType) :
+TypesMgr::Type::Type(std::size_t firstParam, unsigned int numParams, TypeId returnType) :
   ID{TypesMgr::TypeKind::FunctionKind},
-  funcParamsTy{paramsTypes},
-  funcReturnTy{returnType} {
-  }
+  numParams{numParams},
+  firstParam{std::uint32_t(firstParam)},
+  subTy{std::uint32_t(returnType)} {
+  assert(firstParam <= UINT32_MAX and returnType <= UINT32_MAX);
+}
 
 TypesMgr::Type::Type(unsigned int arraySize, TypeId arrayElemType) :
   ID{TypesMgr::TypeKind::ArrayKind},
+  numParams{0},
   arraySize{arraySize},
-  arrayElemTy{arrayElemType} {
-  }
+  subTy{std::uint32_t(arrayElemType)} {
+  assert(arrayElemType <= UINT32_MAX);
+}
 
 // ----------------------------------------------------------------------
 // accesor to get the kind
@@ -398,21 +418,16 @@ bool TypesMgr::Type::isFunctionTy() const {
   return ID == TypeKind::FunctionKind;
 }
 
-const std::vector<TypesMgr::TypeId> & TypesMgr::Type::getFuncParamsTypes() const {
-  return funcParamsTy;
+std::size_t TypesMgr::Type::getFirstParameter() const {
+  return firstParam;
 }
 
 TypesMgr::TypeId TypesMgr::Type::getFuncReturnType() const {
-  return funcReturnTy;
+  return subTy;
 }
 
 std::size_t TypesMgr::Type::getNumOfParameters() const {
-  return getFuncParamsTypes().size();
-}
-
-TypesMgr::TypeId TypesMgr::Type::getParameterType(unsigned int i) const {
-  assert(i < getNumOfParameters());
-  return getFuncParamsTypes()[i];
+  return numParams;
 }
 
 bool TypesMgr::Type::isVoidFunction() const {
@@ -431,5 +446,5 @@ unsigned int TypesMgr::Type::getArraySize() const {
 }
 
 TypesMgr::TypeId TypesMgr::Type::getArrayElemType() const {
-  return arrayElemTy;
+  return subTy;
 }
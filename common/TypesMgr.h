@@ -31,8 +31,14 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <unordered_map>
+#include <functional> // std::hash, std::equal_to
+#include <utility>    // std::pair
 
 #include <cstddef>    // std::size_t
+#include <cstdint>    // std::uint32_t
+
+#include "arena.h"
 
 // using namespace std;
 
@@ -46,6 +52,9 @@
 // integer, float, boolean, character and void. Also it
 // recognizes two compound types: functions and fixed-size
 // arrays. Finally there exist a special type 'error'.
+// The types are hash-consed: creating a compound type equal to one
+// already created returns the same TypeId, so two types are equal
+// if and only if their TypeId's are.
 
 class TypesMgr {
 
@@ -54,8 +63,16 @@ public:
   // The TypeId is an index in a vector
   typedef std::size_t TypeId;
 
-  // Constructor
-  TypesMgr ();
+  // List of TypeId's (e.g. the types of the parameters of all the
+  // functions), allocated in the arena of the TypesMgr
+  typedef std::vector<TypeId, arena_allocator<TypeId>> TypeIdList;
+
+  // Constructor (the types are allocated in the arena Memory, or in
+  // the general heap if it is null)
+  TypesMgr (arena * Memory = nullptr);
+  // Remove all the types but the primitive ones, keeping the memory
+  // of the tables (so they can be reused by another compilation)
+  void clear ();
 
   // Methods to create a Type and return its TypeId
   //   - Primitive and error types
@@ -84,7 +101,7 @@ public:
 
   // Accessors to work with function types
   bool                        isFunctionTy       (TypeId tid)     const;
-  const std::vector<TypeId> & getFuncParamsTypes (TypeId tid)     const;
+  std::vector<TypeId>         getFuncParamsTypes (TypeId tid)     const;
   TypeId                      getFuncReturnType  (TypeId tid)     const;
   std::size_t                 getNumOfParameters (TypeId tid)     const;
   TypeId                      getParameterType   (TypeId tid,
@@ -97,7 +114,7 @@ public:
   TypeId       getArrayElemType (TypeId tid) const;
 
   // Methods to check different compatibilities of types
-  //   - structurally equal?
+  //   - structurally equal? (the same TypeId)
   bool equalTypes      (TypeId tid1, TypeId tid2)     const;
   //   - comparable with the relational operator op?
   bool comparableTypes (TypeId tid1, TypeId tid2,
@@ -119,14 +136,22 @@ private:
   class Type;
 
   // Attributes:
-  //   - vector to save the Types
-  std::vector<Type> TypesVec;
+  //   - vector to save the Types (allocated in the arena)
+  std::vector<Type, arena_allocator<Type>> TypesVec;
+  //   - pool with the types of the parameters of the functions, those
+  //     of each function one after the other
+  TypeIdList ParamsPool;
+  //   - index of the compound types in TypesVec by the hash of their
+  //     structure (allocated in the arena)
+  std::unordered_multimap<std::size_t, TypeId,
+			  std::hash<std::size_t>, std::equal_to<std::size_t>,
+			  arena_allocator<std::pair<const std::size_t, TypeId>>> TypesIndex;
 
   // There are eight kinds of types:
   //   - an especial kind error,
   //   - five primitive kinds: integer, float, boolean, character and void
   //   - two compound kinds: function and array
-  enum TypeKind {
+  enum TypeKind : signed char {
     FirstPrimitiveKind = -1,
     // Primitive/fundamental data types ("error" type is included):
     ErrorKind          = 0,  // "error" type. MUST BE THE FIRST AND MUST BE ZERO
@@ -162,13 +187,20 @@ private:
   // It keeps the information of any type. When a type is
   // compound, the subtypes (for example the types of the parameters
   // of a function, or the type of the elements of an array) are
-  // referenced by their respective TypeId's.
+  // referenced by their respective TypeId's. It is kept small (four
+  // of them fit in a cache line): the kind is a small tag, the
+  // numbers are of 32 bits, the size of an array and the index of
+  // the parameters of a function share a field (told apart by the
+  // kind), and the types of the parameters of a function are not in
+  // the Type but in the ParamsPool of the TypesMgr.
   class Type {
 
   public:
-    // Constructors for primitive, function and array Types
+    // Constructors for primitive, function and array Types (the
+    // parameters of a function start at firstParam in the ParamsPool)
     Type (TypeKind                    tid = TypeKind::VoidKind);
-    Type (const std::vector<TypeId> & paramsTypes,
+    Type (std::size_t                 firstParam,
+	  unsigned int                numParams,
 	  TypeId                      returnType);
     Type (unsigned int                arraySize,
 	  TypeId                      arrayElemType);
@@ -192,10 +224,9 @@ private:
 
     // Accessors to work with function types
     bool                        isFunctionTy       ()               const;
-    const std::vector<TypeId> & getFuncParamsTypes ()               const;
+    std::size_t                 getFirstParameter  ()               const;
     TypeId                      getFuncReturnType  ()               const;
     std::size_t                 getNumOfParameters ()               const;
-    TypeId                      getParameterType   (unsigned int i) const;
     bool                        isVoidFunction     ()               const;
 
     // Accessors to work with array types
@@ -208,12 +239,17 @@ private:
     // Atributes:
     //   - the kind of type
     TypeKind ID;
-    //   - to represent the type of a function:
-    std::vector<TypeId> funcParamsTy;
-    TypeId funcReturnTy;
-    //   - to represent the type of an array:
-    unsigned int arraySize;
-    TypeId arrayElemTy;
+    //   - the number of parameters of a function (0 otherwise)
+    std::uint32_t numParams;
+    //   - the size of an array, or the index of the first parameter
+    //     of a function in the ParamsPool
+    union {
+      std::uint32_t arraySize;
+      std::uint32_t firstParam;
+    };
+    //   - the return type of a function, or the type of the elements
+    //     of an array
+    std::uint32_t subTy;
 
   };  // class Type
 
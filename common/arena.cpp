@@ -0,0 +1,76 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "arena.h"
+
+#include <cstdint>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'arena'
+
+/// constructor
+arena::arena(size_t bsize) : next(nullptr), limit(nullptr), blockSize(bsize), allocated(0) {}
+/// destructor
+arena::~arena() { release(); }
+
+/// get n bytes (from the current block, or from a new one if they
+/// do not fit; requests larger than a block get a block of their own)
+void * arena::allocate(size_t n, size_t align) {
+  uintptr_t p = (reinterpret_cast<uintptr_t>(next) + align-1) & ~uintptr_t(align-1);
+  if (next == nullptr or p + n > reinterpret_cast<uintptr_t>(limit)) {
+    size_t size = n + align > blockSize ? n + align : blockSize;
+    char *block = static_cast<char *>(::operator new(size));
+    blocks.push_back(block);
+    p = (reinterpret_cast<uintptr_t>(block) + align-1) & ~uintptr_t(align-1);
+    // keep the rest of the current block if the new one is a private one
+    if (size == blockSize or next == nullptr) {
+      next = block;
+      limit = block + size;
+    }
+    else {
+      allocated += n;
+      return reinterpret_cast<void *>(p);
+    }
+  }
+  next = reinterpret_cast<char *>(p + n);
+  allocated += n;
+  return reinterpret_cast<void *>(p);
+}
+
+/// free all the memory
+void arena::release() {
+  for (auto b : blocks) ::operator delete(b);
+  blocks.clear();
+  next = limit = nullptr;
+  allocated = 0;
+}
+
+/// number of bytes given
+size_t arena::bytes_allocated() const { return allocated; }
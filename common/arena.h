@@ -0,0 +1,108 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////
+/// Class arena is a monotonic (bump) allocator: memory is taken from
+/// large blocks and never given back one object at a time, but all
+/// at once when the arena is released or destroyed. It is meant for
+/// the objects of a compilation, that all die together at its end.
+/// The objects that use an arena are given it when they are created.
+/// An arena is not thread-safe: each thread must use its own one.
+
+class arena {
+ public:
+  /// constructor (blockSize is the size of the blocks requested to
+  /// the system) and destructor (all the memory is freed)
+  arena(size_t blockSize = 64*1024);
+  ~arena();
+
+  /// get n bytes aligned to 'align' (that must be a power of two)
+  void * allocate(size_t n, size_t align);
+  /// free all the memory of the arena at once
+  void release();
+  /// number of bytes given by the arena (since it was last released)
+  size_t bytes_allocated() const;
+
+ private:
+  /// blocks obtained from the system
+  std::vector<char *> blocks;
+  /// free part of the last block
+  char *next, *limit;
+  size_t blockSize;
+  size_t allocated;
+
+  /// no copies (the blocks are owned)
+  arena(const arena &) = delete;
+  arena & operator=(const arena &) = delete;
+};
+
+
+////////////////////////////////////////////////////////////////////
+/// Class arena_allocator is a standard allocator that takes memory
+/// from the arena it is created with (or from the general heap, if it
+/// is default constructed). Containers keep the allocator they were
+/// created with (or copied or moved from), so all the containers that
+/// exchange elements (splice, swap...) must use the same arena, and
+/// must be destroyed before it.
+
+template <class T>
+class arena_allocator {
+ public:
+  typedef T value_type;
+  typedef std::false_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  /// arena the memory is taken from (nullptr for the general heap)
+  arena *owner;
+
+  arena_allocator() : owner(nullptr) {}
+  explicit arena_allocator(arena *a) : owner(a) {}
+  template <class U>
+  arena_allocator(const arena_allocator<U> &a) : owner(a.owner) {}
+
+  T * allocate(size_t n) {
+    if (owner) return static_cast<T *>(owner->allocate(n*sizeof(T), alignof(T)));
+    return static_cast<T *>(::operator new(n*sizeof(T)));
+  }
+  void deallocate(T *p, size_t) {
+    if (not owner) ::operator delete(p);
+  }
+};
+
+template <class T, class U>
+bool operator==(const arena_allocator<T> &a, const arena_allocator<U> &b) { return a.owner == b.owner; }
+template <class T, class U>
+bool operator!=(const arena_allocator<T> &a, const arena_allocator<U> &b) { return a.owner != b.owner; }
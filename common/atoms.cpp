@@ -0,0 +1,128 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+#include "atoms.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'atomTable'
+
+const atomTable::atom atomTable::EMPTY;
+
+/// constructor: the empty text gets the atom EMPTY
+atomTable::atomTable() : base(nullptr), first(0), slots(64, 0) { intern("", 0); }
+/// constructor of an extension of *b (that already has the empty text)
+atomTable::atomTable(const atomTable *b) : base(b), first(b->size()), slots(64, 0) {}
+
+/// remove the atoms of this table (the empty text is added again,
+/// unless it is in the base)
+void atomTable::clear() {
+  texts.clear();
+  hashes.clear();
+  fill(slots.begin(), slots.end(), 0);
+  if (not base) intern("", 0);
+}
+
+/// get the atom of a text (adding it if it is new)
+atomTable::atom atomTable::intern(const char *text, size_t length) {
+  atom a;
+  if (base and base->find(text, length, a)) return a;
+  uint32_t h = hash(text, length);
+  size_t s = slot(text, length, h);
+  if (slots[s] != 0) return first + slots[s] - 1;
+  assert(first + texts.size() < UINT32_MAX);
+  a = texts.size();
+  texts.emplace_back(text, length);
+  hashes.push_back(h);
+  slots[s] = a + 1;
+  if (2*texts.size() > slots.size()) grow();
+  return first + a;
+}
+atomTable::atom atomTable::intern(const string &s) { return intern(s.data(), s.size()); }
+
+/// get the atom of a text, only if it is in the table
+bool atomTable::find(const char *text, size_t length, atom &a) const {
+  if (base and base->find(text, length, a)) return true;
+  size_t s = slot(text, length, hash(text, length));
+  if (slots[s] == 0) return false;
+  a = first + slots[s] - 1;
+  return true;
+}
+bool atomTable::find(const string &s, atom &a) const { return find(s.data(), s.size(), a); }
+
+/// get the text of an atom
+const string & atomTable::text(atom a) const {
+  return a < first ? base->text(a) : texts[a - first];
+}
+/// number of different texts
+size_t atomTable::size() const { return first + texts.size(); }
+/// number of atoms shared with another table
+size_t atomTable::shared(const atomTable &other) const {
+  if (&other == this or other.base == this) return size();
+  if (base == &other) return first;
+  return 0;
+}
+
+/// hash of a text (FNV-1a)
+uint32_t atomTable::hash(const char *text, size_t length) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    h ^= (unsigned char)text[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/// slot of a text: linear probing from its hash, until the slot of
+/// the same text or a free one
+size_t atomTable::slot(const char *text, size_t length, uint32_t h) const {
+  size_t mask = slots.size() - 1;
+  for (size_t s = h & mask; ; s = (s + 1) & mask) {
+    if (slots[s] == 0) return s;
+    atom a = slots[s] - 1;
+    if (hashes[a] == h and texts[a].size() == length and
+        memcmp(texts[a].data(), text, length) == 0)
+      return s;
+  }
+}
+
+/// doubles the number of slots, and puts each atom again in its slot
+void atomTable::grow() {
+  vector<atom> old(2*slots.size(), 0);
+  old.swap(slots);
+  size_t mask = slots.size() - 1;
+  for (atom a = 0; a < texts.size(); ++a) {
+    size_t s = hashes[a] & mask;
+    while (slots[s] != 0) s = (s + 1) & mask;
+    slots[s] = a + 1;
+  }
+}
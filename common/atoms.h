@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////
+/// Class atomTable interns the identifiers and literals of a
+/// compilation: each different text gets an atom, a 32-bit number,
+/// so they are kept and compared as integers (by the symbol table,
+/// the tokens, the AST and the instructions of the code, whose
+/// temporals and labels are interned along with them). A text can
+/// be interned straight from the characters of the source, without
+/// making a std::string of them unless it is new. It is an open addressing hash table of the
+/// atoms, and the texts (that do not move) are kept by atom.
+/// Several threads can find atoms and texts at once, as long as no
+/// atom is added. A table can also extend another one, that does not
+/// change meanwhile: it has the atoms of its base, and the texts
+/// that are not there get the next ones, so a thread can add atoms
+/// of its own (e.g. the operands of the code it generates) to those
+/// of a whole compilation.
+
+class atomTable {
+ public:
+  /// an interned text
+  typedef uint32_t atom;
+  /// atom of the empty text (always present in the table)
+  static const atom EMPTY = 0;
+
+  /// constructor
+  atomTable();
+  /// constructor of a table that extends *base (that must outlive
+  /// it, and not change while it is in use)
+  explicit atomTable(const atomTable *base);
+  /// remove all the atoms but EMPTY (or, in an extension, all those
+  /// not in its base), keeping the memory of the hash table, so it can
+  /// be reused by another compilation (there must be no extension of
+  /// it meanwhile)
+  void clear();
+
+  /// get the atom of a text (adding it if it is new)
+  atom intern(const char *text, size_t length);
+  atom intern(const std::string &s);
+  /// get the atom of a text already in the table, without adding it
+  /// (returns false if it is not there)
+  bool find(const char *text, size_t length, atom &a) const;
+  bool find(const std::string &s, atom &a) const;
+  /// get the text of an atom
+  const std::string & text(atom a) const;
+  /// number of different texts in the table
+  size_t size() const;
+  /// number of the first atoms that are the same in this table and in
+  /// 'other' (all of them if it is the same table or 'other' extends
+  /// it, the ones of its base if it extends 'other', and none otherwise)
+  size_t shared(const atomTable &other) const;
+
+ private:
+  /// table extended by this one (or null), and the number of its
+  /// atoms (the first one of this table)
+  const atomTable *base;
+  atom first;
+  /// texts added to this table, by atom (minus first), and their hashes
+  std::deque<std::string> texts;
+  std::vector<uint32_t> hashes;
+  /// slots of the hash table: an atom (minus first) plus one, or 0 if
+  /// it is free (there are a power of two of them, at most half in use)
+  std::vector<atom> slots;
+
+  /// hash of a text
+  static uint32_t hash(const char *text, size_t length);
+  /// slot of a text with the given hash: the one of its atom, or the
+  /// free one where it would be added
+  size_t slot(const char *text, size_t length, uint32_t h) const;
+  /// doubles the number of slots
+  void grow();
+
+  /// no copies (the tokens and the symbols refer to the texts)
+  atomTable(const atomTable &) = delete;
+  atomTable & operator=(const atomTable &) = delete;
+};
@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "bytestream.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'byteCharStream' (that behaves as an
+/// ANTLRInputStream with the same contents)
+
+/// constructor
+byteCharStream::byteCharStream(const char *data, size_t size) :
+  bytes(reinterpret_cast<const unsigned char *>(data)), length(size), position(0) {
+}
+
+/// check that the bytes are all ASCII
+bool byteCharStream::fits(const char *data, size_t size) {
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+  return all_of(p, p + size, [](unsigned char c) { return c < 0x80; });
+}
+
+/// the bytes
+const char * byteCharStream::data() const {
+  return reinterpret_cast<const char *>(bytes);
+}
+
+/// move to the next character
+void byteCharStream::consume() {
+  assert(position < length);
+  ++position;
+}
+
+/// character at offset i from the current one (1 is the next one,
+/// -1 the previous one)
+size_t byteCharStream::LA(ssize_t i) {
+  if (i == 0) return 0;  // undefined
+  if (i < 0) ++i;        // LA(-1) is the previous character
+  ssize_t at = static_cast<ssize_t>(position) + i - 1;
+  if (at < 0 or at >= static_cast<ssize_t>(length)) return antlr4::IntStream::EOF;
+  return bytes[at];
+}
+
+/// marks are not needed: the whole input is always available
+ssize_t byteCharStream::mark() { return -1; }
+void byteCharStream::release(ssize_t marker) { }
+
+/// current position
+size_t byteCharStream::index() { return position; }
+void byteCharStream::seek(size_t index) { position = min(index, length); }
+size_t byteCharStream::size() { return length; }
+
+/// name of the source (unknown)
+string byteCharStream::getSourceName() const {
+  return antlr4::IntStream::UNKNOWN_SOURCE_NAME;
+}
+
+/// characters from a to b, both included (as a string of bytes)
+string byteCharStream::getText(const antlr4::misc::Interval &interval) {
+  if (interval.a < 0 or interval.b < interval.a) return "";
+  size_t start = interval.a;
+  size_t stop = min(size_t(interval.b), length - 1);
+  if (start >= length) return "";
+  return string(reinterpret_cast<const char *>(bytes) + start, stop - start + 1);
+}
+
+/// all the characters
+string byteCharStream::toString() const {
+  return string(reinterpret_cast<const char *>(bytes), length);
+}
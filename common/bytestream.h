@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "antlr4-runtime.h"
+
+#include <string>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////
+/// Class byteCharStream is a character stream for the lexer that
+/// reads the characters in place from a block of bytes (e.g. a
+/// mappedFile), each byte being a character. Unlike ANTLRInputStream,
+/// it does not copy and decode the whole input, so the bytes must
+/// outlive the stream, and they must be ASCII (so that bytes and
+/// characters are the same).
+
+class byteCharStream : public antlr4::CharStream {
+ public:
+  /// constructor (the bytes are not copied)
+  byteCharStream(const char *data, size_t size);
+
+  /// whether the bytes can be read by a byteCharStream (all ASCII)
+  static bool fits(const char *data, size_t size);
+
+  /// the bytes read (size() of them)
+  const char * data() const;
+
+  /// IntStream and CharStream interface
+  void consume() override;
+  size_t LA(ssize_t i) override;
+  ssize_t mark() override;
+  void release(ssize_t marker) override;
+  size_t index() override;
+  void seek(size_t index) override;
+  size_t size() override;
+  std::string getSourceName() const override;
+  std::string getText(const antlr4::misc::Interval &interval) override;
+  std::string toString() const override;
+
+ private:
+  const unsigned char *bytes;
+  size_t length;
+  /// index of the next character
+  size_t position;
+};
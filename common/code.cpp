@@ -27,6 +27,10 @@
 ////////////////////////////////////////////////////////////////
 
 #include <iostream>
+#include <sstream>
+#include <utility>
+#include <cstdio>
+#include <cassert>
 #include "code.h"
 
 using namespace std;
@@ -34,57 +38,61 @@ using namespace std;
 ////////////////////////////////////////////////////////////////////
 /// Implementation for class 'instruction'
 
-/// Constructor
-instruction::instruction(Operation op,
+/// Constructor (with the atoms of the operands)
+instruction::instruction(Operation op, atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) :
+  oper(op), arg1(a1), arg2(a2), arg3(a3), target(NO_TARGET) {}
+/// Constructor (with the texts of the operands, added to 'atoms')
+instruction::instruction(atomTable &atoms, Operation op,
                          const std::string &a1, const std::string &a2, const std::string &a3) {
   oper = op;
-  arg1 = a1;
-  arg2 = a2;
-  arg3 = a3;
+  arg1 = a1.empty() ? atomTable::EMPTY : atoms.intern(a1);
+  arg2 = a2.empty() ? atomTable::EMPTY : atoms.intern(a2);
+  arg3 = a3.empty() ? atomTable::EMPTY : atoms.intern(a3);
+  target = NO_TARGET;
 }
 
-instruction instruction::LABEL(const std::string &a1) { return instruction(_LABEL, a1); }
-instruction instruction::UJUMP(const std::string &a1) { return instruction(_UJUMP, a1); }
-instruction instruction::FJUMP(const std::string &a1, const std::string &a2) { return instruction(_FJUMP, a1, a2); }
-instruction instruction::PUSH(const std::string &a1) { return instruction(_PUSH, a1); }
-instruction instruction::POP(const std::string &a1) { return instruction(_POP, a1); }
-instruction instruction::CALL(const std::string &a1) { return instruction(_CALL, a1); }
+instruction instruction::LABEL(atomTable::atom a1) { return instruction(_LABEL, a1); }
+instruction instruction::UJUMP(atomTable::atom a1) { return instruction(_UJUMP, a1); }
+instruction instruction::FJUMP(atomTable::atom a1, atomTable::atom a2) { return instruction(_FJUMP, a1, a2); }
+instruction instruction::PUSH(atomTable::atom a1) { return instruction(_PUSH, a1); }
+instruction instruction::POP(atomTable::atom a1) { return instruction(_POP, a1); }
+instruction instruction::CALL(atomTable::atom a1) { return instruction(_CALL, a1); }
 instruction instruction::RETURN() { return instruction(_RETURN); }
-instruction instruction::ADD(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_ADD, a1, a2, a3); }
-instruction instruction::SUB(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_SUB, a1, a2, a3); }
-instruction instruction::MUL(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_MUL, a1, a2, a3); }
-instruction instruction::DIV(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_DIV, a1, a2, a3); }
-instruction instruction::EQ(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_EQ, a1, a2, a3); }
-instruction instruction::LT(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_LT, a1, a2, a3); }
-instruction instruction::LE(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_LE, a1, a2, a3); }
-instruction instruction::AND(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_AND, a1, a2, a3); }
-instruction instruction::OR(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_OR, a1, a2, a3); }
-instruction instruction::FADD(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_FADD, a1, a2, a3); }
-instruction instruction::FSUB(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_FSUB, a1, a2, a3); }
-instruction instruction::FMUL(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_FMUL, a1, a2, a3); }
-instruction instruction::FDIV(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_FDIV, a1, a2, a3); }
-instruction instruction::FEQ(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_FEQ, a1, a2, a3); }
-instruction instruction::FLT(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_FLT, a1, a2, a3); }
-instruction instruction::FLE(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_FLE, a1, a2, a3); }
-instruction instruction::NOT(const std::string &a1, const std::string &a2) { return instruction(_NOT, a1, a2); }
-instruction instruction::NEG(const std::string &a1, const std::string &a2) { return instruction(_NEG, a1, a2); }
-instruction instruction::FNEG(const std::string &a1, const std::string &a2) { return instruction(_FNEG, a1, a2); }
-instruction instruction::FLOAT(const std::string &a1, const std::string &a2) { return instruction(_FLOAT, a1, a2); }  
-instruction instruction::LOAD(const std::string &a1, const std::string &a2) { return instruction(_LOAD, a1, a2); }
-instruction instruction::ILOAD(const std::string &a1, const std::string &a2) { return instruction(_ILOAD, a1, a2); }
-instruction instruction::CHLOAD(const std::string &a1, const std::string &a2) { return instruction(_CHLOAD, a1, a2); }
-instruction instruction::FLOAD(const std::string &a1, const std::string &a2) { return instruction(_FLOAD, a1, a2); }
-instruction instruction::XLOAD(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_XLOAD, a1, a2, a3); }
-instruction instruction::LOADX(const std::string &a1, const std::string &a2, const std::string &a3) { return instruction(_LOADX, a1, a2, a3); }
-instruction instruction::ALOAD(const std::string &a1, const std::string &a2) { return instruction(_ALOAD, a1, a2); }
-instruction instruction::LOADC(const std::string &a1, const std::string &a2) { return instruction(_LOADC, a1, a2); }
-instruction instruction::CLOAD(const std::string &a1, const std::string &a2) { return instruction(_CLOAD, a1, a2); }
-instruction instruction::READI(const std::string &a1) { return instruction(_READI, a1); }
-instruction instruction::READF(const std::string &a1) { return instruction(_READF, a1); }
-instruction instruction::READC(const std::string &a1) { return instruction(_READC, a1); }
-instruction instruction::WRITEI(const std::string &a1) { return instruction(_WRITEI, a1); }
-instruction instruction::WRITEF(const std::string &a1) { return instruction(_WRITEF, a1); }
-instruction instruction::WRITEC(const std::string &a1) { return instruction(_WRITEC, a1); }
+instruction instruction::ADD(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_ADD, a1, a2, a3); }
+instruction instruction::SUB(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_SUB, a1, a2, a3); }
+instruction instruction::MUL(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_MUL, a1, a2, a3); }
+instruction instruction::DIV(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_DIV, a1, a2, a3); }
+instruction instruction::EQ(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_EQ, a1, a2, a3); }
+instruction instruction::LT(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_LT, a1, a2, a3); }
+instruction instruction::LE(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_LE, a1, a2, a3); }
+instruction instruction::AND(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_AND, a1, a2, a3); }
+instruction instruction::OR(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_OR, a1, a2, a3); }
+instruction instruction::FADD(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_FADD, a1, a2, a3); }
+instruction instruction::FSUB(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_FSUB, a1, a2, a3); }
+instruction instruction::FMUL(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_FMUL, a1, a2, a3); }
+instruction instruction::FDIV(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_FDIV, a1, a2, a3); }
+instruction instruction::FEQ(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_FEQ, a1, a2, a3); }
+instruction instruction::FLT(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_FLT, a1, a2, a3); }
+instruction instruction::FLE(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_FLE, a1, a2, a3); }
+instruction instruction::NOT(atomTable::atom a1, atomTable::atom a2) { return instruction(_NOT, a1, a2); }
+instruction instruction::NEG(atomTable::atom a1, atomTable::atom a2) { return instruction(_NEG, a1, a2); }
+instruction instruction::FNEG(atomTable::atom a1, atomTable::atom a2) { return instruction(_FNEG, a1, a2); }
+instruction instruction::FLOAT(atomTable::atom a1, atomTable::atom a2) { return instruction(_FLOAT, a1, a2); }  
+instruction instruction::LOAD(atomTable::atom a1, atomTable::atom a2) { return instruction(_LOAD, a1, a2); }
+instruction instruction::ILOAD(atomTable::atom a1, atomTable::atom a2) { return instruction(_ILOAD, a1, a2); }
+instruction instruction::CHLOAD(atomTable::atom a1, atomTable::atom a2) { return instruction(_CHLOAD, a1, a2); }
+instruction instruction::FLOAD(atomTable::atom a1, atomTable::atom a2) { return instruction(_FLOAD, a1, a2); }
+instruction instruction::XLOAD(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_XLOAD, a1, a2, a3); }
+instruction instruction::LOADX(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3) { return instruction(_LOADX, a1, a2, a3); }
+instruction instruction::ALOAD(atomTable::atom a1, atomTable::atom a2) { return instruction(_ALOAD, a1, a2); }
+instruction instruction::LOADC(atomTable::atom a1, atomTable::atom a2) { return instruction(_LOADC, a1, a2); }
+instruction instruction::CLOAD(atomTable::atom a1, atomTable::atom a2) { return instruction(_CLOAD, a1, a2); }
+instruction instruction::READI(atomTable::atom a1) { return instruction(_READI, a1); }
+instruction instruction::READF(atomTable::atom a1) { return instruction(_READF, a1); }
+instruction instruction::READC(atomTable::atom a1) { return instruction(_READC, a1); }
+instruction instruction::WRITEI(atomTable::atom a1) { return instruction(_WRITEI, a1); }
+instruction instruction::WRITEF(atomTable::atom a1) { return instruction(_WRITEF, a1); }
+instruction instruction::WRITEC(atomTable::atom a1) { return instruction(_WRITEC, a1); }
 instruction instruction::WRITELN() { return instruction(_WRITELN); }
 instruction instruction::NOOP() { return instruction(_NOOP); }
 
@@ -92,58 +100,64 @@ instruction instruction::NOOP() { return instruction(_NOOP); }
 /// Destructor
 instruction::~instruction() {}
 
-string instruction::dump() const {
-  string s;
-  string ind="   ";
+string instruction::dump(const atomTable &atoms) const {
+  ostringstream s;
+  dump(atoms, s);
+  return s.str();
+}
+
+void instruction::dump(const atomTable &atoms, ostream &os) const {
+  const string &arg1 = atoms.text(this->arg1);
+  const string &arg2 = atoms.text(this->arg2);
+  const string &arg3 = atoms.text(this->arg3);
+  if (oper != instruction::_LABEL) os << "   ";
   switch (oper) {
-  case instruction::_LABEL : { s = "label " + arg1 + " :"; ind = ""; break; }
-  case instruction::_UJUMP : { s = "goto " + arg1; break; }
-  case instruction::_FJUMP : { s = "ifFalse " + arg1 + " goto " +arg2; break; }
+  case instruction::_LABEL : { os << "label " << arg1 << " :"; break; }
+  case instruction::_UJUMP : { os << "goto " << arg1; break; }
+  case instruction::_FJUMP : { os << "ifFalse " << arg1 << " goto " << arg2; break; }
   case instruction::_LOAD : 
   case instruction::_FLOAD : 
-  case instruction::_ILOAD : { s = arg1 + " = " + arg2; break; } 
-  case instruction::_CHLOAD : { s = arg1 + " = '" + arg2 +"'"; break; } 
-  case instruction::_PUSH : { s = "pushparam " + (arg1.empty()? "" : arg1); break; }
-  case instruction::_POP : { s = "popparam " + (arg1.empty()? "" : arg1); break; }
-  case instruction::_CALL : { s = "call " + arg1; break; }
-  case instruction::_RETURN : { s = "return"; break; }
-  case instruction::_XLOAD : { s = arg1 + "[" + arg2 + "] = " + arg3; break; }
-  case instruction::_LOADX : { s = arg1 + " = " + arg2 + "[" + arg3 + "]"; break; }
-  case instruction::_ALOAD : { s = arg1 + " = &" + arg2; break; }
-  case instruction::_LOADC : { s = arg1 + " = *" + arg2; break; }
-  case instruction::_CLOAD : { s = "*" + arg1 + " = " + arg2; break; }
-  case instruction::_READI : { s = "readi " + arg1; break; }
-  case instruction::_READF : { s = "readf " + arg1; break; }
-  case instruction::_READC : { s = "readc " + arg1; break; }
-  case instruction::_WRITEI : { s = "writei " + arg1; break; }
-  case instruction::_WRITEF : { s = "writef " + arg1; break; }
-  case instruction::_WRITEC : { s = "writec " + arg1; break; }
-  case instruction::_WRITELN : { s = "writeln"; break; }
-  case instruction::_ADD : { s = arg1 + " = " + arg2 + " + " + arg3; break; }
-  case instruction::_SUB : { s = arg1 + " = " + arg2 + " - " + arg3; break; }
-  case instruction::_MUL : { s = arg1 + " = " + arg2 + " * " + arg3; break; }
-  case instruction::_DIV : { s = arg1 + " = " + arg2 + " / " + arg3; break; }
-  case instruction::_AND : { s = arg1 + " = " + arg2 + " and " + arg3; break; }
-  case instruction::_OR : { s = arg1 + " = " + arg2 + " or " + arg3; break; }
-  case instruction::_EQ : { s = arg1 + " = " + arg2 + " == " + arg3; break; }
-  case instruction::_LT : { s = arg1 + " = " + arg2 + " < " + arg3; break; }
-  case instruction::_LE : { s = arg1 + " = " + arg2 + " <= " + arg3; break; }
-  case instruction::_NOT : { s = arg1 + " = not " + arg2; break; }
-  case instruction::_NEG : { s = arg1 + " = - " + arg2; break; }
-  case instruction::_FADD : { s = arg1 + " = " + arg2 + " +. " + arg3; break; }
-  case instruction::_FSUB : { s = arg1 + " = " + arg2 + " -. " + arg3; break; }
-  case instruction::_FMUL : { s = arg1 + " = " + arg2 + " *. " + arg3; break; }
-  case instruction::_FDIV : { s = arg1 + " = " + arg2 + " /. " + arg3; break; }
-  case instruction::_FEQ : { s = arg1 + " = " + arg2 + " ==. " + arg3; break; }
-  case instruction::_FLT : { s = arg1 + " = " + arg2 + " <. " + arg3; break; }
-  case instruction::_FLE : { s =  arg1 + " = " + arg2 + " <=. " + arg3; break; }
-  case instruction::_FNEG : { s =  arg1 + " = -. " + arg2; break; }
-  case instruction::_FLOAT : { s = arg1 + " = float " + arg2; break; }
-  case instruction::_NOOP : { s = "noop"; break; }
-  default : { s = "????"; break; }
+  case instruction::_ILOAD : { os << arg1 << " = " << arg2; break; }
+  case instruction::_CHLOAD : { os << arg1 << " = '" << arg2 << "'"; break; }
+  case instruction::_PUSH : { os << "pushparam " << arg1; break; }
+  case instruction::_POP : { os << "popparam " << arg1; break; }
+  case instruction::_CALL : { os << "call " << arg1; break; }
+  case instruction::_RETURN : { os << "return"; break; }
+  case instruction::_XLOAD : { os << arg1 << "[" << arg2 << "] = " << arg3; break; }
+  case instruction::_LOADX : { os << arg1 << " = " << arg2 << "[" << arg3 << "]"; break; }
+  case instruction::_ALOAD : { os << arg1 << " = &" << arg2; break; }
+  case instruction::_LOADC : { os << arg1 << " = *" << arg2; break; }
+  case instruction::_CLOAD : { os << "*" << arg1 << " = " << arg2; break; }
+  case instruction::_READI : { os << "readi " << arg1; break; }
+  case instruction::_READF : { os << "readf " << arg1; break; }
+  case instruction::_READC : { os << "readc " << arg1; break; }
+  case instruction::_WRITEI : { os << "writei " << arg1; break; }
+  case instruction::_WRITEF : { os << "writef " << arg1; break; }
+  case instruction::_WRITEC : { os << "writec " << arg1; break; }
+  case instruction::_WRITELN : { os << "writeln"; break; }
+  case instruction::_ADD : { os << arg1 << " = " << arg2 << " + " << arg3; break; }
+  case instruction::_SUB : { os << arg1 << " = " << arg2 << " - " << arg3; break; }
+  case instruction::_MUL : { os << arg1 << " = " << arg2 << " * " << arg3; break; }
+  case instruction::_DIV : { os << arg1 << " = " << arg2 << " / " << arg3; break; }
+  case instruction::_AND : { os << arg1 << " = " << arg2 << " and " << arg3; break; }
+  case instruction::_OR : { os << arg1 << " = " << arg2 << " or " << arg3; break; }
+  case instruction::_EQ : { os << arg1 << " = " << arg2 << " == " << arg3; break; }
+  case instruction::_LT : { os << arg1 << " = " << arg2 << " < " << arg3; break; }
+  case instruction::_LE : { os << arg1 << " = " << arg2 << " <= " << arg3; break; }
+  case instruction::_NOT : { os << arg1 << " = not " << arg2; break; }
+  case instruction::_NEG : { os << arg1 << " = - " << arg2; break; }
+  case instruction::_FADD : { os << arg1 << " = " << arg2 << " +. " << arg3; break; }
+  case instruction::_FSUB : { os << arg1 << " = " << arg2 << " -. " << arg3; break; }
+  case instruction::_FMUL : { os << arg1 << " = " << arg2 << " *. " << arg3; break; }
+  case instruction::_FDIV : { os << arg1 << " = " << arg2 << " /. " << arg3; break; }
+  case instruction::_FEQ : { os << arg1 << " = " << arg2 << " ==. " << arg3; break; }
+  case instruction::_FLT : { os << arg1 << " = " << arg2 << " <. " << arg3; break; }
+  case instruction::_FLE : { os << arg1 << " = " << arg2 << " <=. " << arg3; break; }
+  case instruction::_FNEG : { os << arg1 << " = -. " << arg2; break; }
+  case instruction::_FLOAT : { os << arg1 << " = float " << arg2; break; }
+  case instruction::_NOOP : { os << "noop"; break; }
+  default : { os << "????"; break; }
   }
-
-  return ind + s;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -152,30 +166,77 @@ string instruction::dump() const {
 instructionList instruction::operator||(const instructionList &lst) const {
   return instructionList(*this) || lst;
 }
+instructionList instruction::operator||(instructionList &&lst) const {
+  return instructionList(*this) || std::move(lst);
+}
 
 
 ////////////////////////////////////////////////////////////////////
 /// Implementation for class 'instructionList'
 
+// arena of the nodes of the lists made by this thread (see useArena)
+static thread_local arena *listArena = nullptr;
+
+instructionList::useArena::useArena(arena *mem) : previous(listArena) { listArena = mem; }
+instructionList::useArena::~useArena() { listArena = previous; }
+
 // constructor
-instructionList::instructionList() {}
+instructionList::instructionList() : nodeList(allocator_type(listArena)) {}
 // constructor from a single instruction
-instructionList::instructionList(const instruction &inst) { this->push_back(inst); }
+instructionList::instructionList(const instruction &inst) : nodeList(allocator_type(listArena)) {
+  this->push_back(inst);
+}
+// copy constructor
+instructionList::instructionList(const instructionList &lst) :
+  nodeList(lst.begin(), lst.end(), allocator_type(listArena)) {}
 // destructor
 instructionList::~instructionList() {}
 
-// concatenation of lists (or list+instruction, via automatic coertion)
-instructionList instructionList::operator||(const instructionList &lst) const {
+// concatenation of lists (or list+instruction, via automatic coertion).
+// Lvalue operands are copied, rvalue operands have their nodes spliced.
+instructionList instructionList::operator||(const instructionList &lst) const & {
   instructionList newlist = (*this);
   newlist.insert(newlist.end(), lst.begin(), lst.end());
   return newlist;
 }
+instructionList instructionList::operator||(instructionList &&lst) const & {
+  instructionList newlist = (*this);
+  newlist.append(std::move(lst));
+  return newlist;
+}
+instructionList instructionList::operator||(const instructionList &lst) && {
+  instructionList newlist = std::move(*this);
+  newlist.insert(newlist.end(), lst.begin(), lst.end());
+  return newlist;
+}
+instructionList instructionList::operator||(instructionList &&lst) && {
+  instructionList newlist = std::move(*this);
+  newlist.append(std::move(lst));
+  return newlist;
+}
+
+// add the instructions of lst (the nodes of a list can only be
+// spliced into another one of the same arena)
+void instructionList::append(instructionList &&lst) {
+  if (get_allocator() == lst.get_allocator())
+    splice(end(), lst);
+  else {
+    insert(end(), lst.begin(), lst.end());
+    lst.clear();
+  }
+}
 
 // print instructionList (for debugging)
-string instructionList::dump() const {
-  string s;  
-  for (auto i : *this ) s += i.dump() + "\n";
-  return s;
+string instructionList::dump(const atomTable &atoms) const {
+  ostringstream s;
+  dump(atoms, s);
+  return s.str();
+}
+void instructionList::dump(const atomTable &atoms, ostream &os) const {
+  for (auto &i : *this) {
+    i.dump(atoms, os);
+    os << '\n';
+  }
 }
 
 
@@ -197,72 +258,142 @@ string var::dump() const {
     return name + " " + std::to_string(size);
   return name;
 }
+void var::dump(ostream &os) const {
+  os << name;
+  if (size != 0) os << " " << size;
+}
 
 ////////////////////////////////////////////////////////////////////
 /// Implementation for class 'subroutine'
 
 /// constructor
-subroutine::subroutine(const string &sname) { name = sname; }
+subroutine::subroutine(const string &sname, atomTable &atoms, arena *mem) :
+  name(sname), atoms(&atoms),
+  instructions(arena_allocator<instruction>(mem)), numLabels(0),
+  vars(arena_allocator<var>(mem)), params(arena_allocator<var>(mem)) {}
+/// copy into another arena
+subroutine::subroutine(const subroutine &s, arena *mem) :
+  name(s.name), atoms(s.atoms),
+  instructions(s.instructions, arena_allocator<instruction>(mem)),
+  numLabels(s.numLabels), labelPcs(s.labelPcs),
+  vars(s.vars, arena_allocator<var>(mem)), params(s.params, arena_allocator<var>(mem)) {}
 /// destructor
 subroutine::~subroutine() {}
 /// get subroutine name
 string subroutine::get_name() const { return name; };
+/// get the table of the operands
+atomTable & subroutine::get_atoms() const { return *atoms; }
 /// add new variable
 void subroutine::add_var(const std::string &name, size_t sz) { vars.push_back(var(name,sz)); }
 /// add new parameter
 void subroutine::add_param(const std::string &name) { params.push_back(var(name,0)); }
 /// add new instruction
 void subroutine::add_instruction(const instruction &inst) {
-  if (inst.oper == instruction::_LABEL) labels.insert(make_pair(inst.arg1,instructions.size()));
+  if (inst.oper == instruction::_LABEL) ++numLabels;
   instructions.push_back(inst);
 }
 /// add instruction list to current instructions
 void subroutine::add_instructions(const instructionList &lins) {
-  for (auto i : lins)
+  for (auto &i : lins)
     this->add_instruction(i);
+  this->finalize();
 }
 /// set instruction list (overwritting current instructions)
 void subroutine::set_instructions(const instructionList &lins) {
   instructions.clear();
+  numLabels = 0;
+  instructions.reserve(lins.size());
   this->add_instructions(lins);
 }
 /// get instruction at given program counter
-instruction subroutine::get_instruction_at(size_t pc) const {
-  if (pc>=instructions.size()) return instruction(instruction::_INVALID);
+const instruction & subroutine::get_instruction_at(size_t pc) const {
+  static const instruction invalid(instruction::_INVALID);
+  if (pc>=instructions.size()) return invalid;
   return instructions[pc];
 }
+/// resolve jump targets
+void subroutine::finalize() {
+  index_labels();
+  for (auto &inst : instructions) {
+    atomTable::atom lab;
+    if (inst.oper == instruction::_UJUMP) lab = inst.arg1;
+    else if (inst.oper == instruction::_FJUMP) lab = inst.arg2;
+    else continue;
+    auto it = labelPcs.find(lab);
+    inst.target = (it == labelPcs.end()) ? instruction::NO_TARGET : it->second;
+  }
+}
+/// index the labels by the atoms of their names
+void subroutine::index_labels() {
+  labelPcs.clear();
+  for (size_t pc = 0; pc < instructions.size(); ++pc)
+    if (instructions[pc].oper == instruction::_LABEL)
+      labelPcs.insert(make_pair(instructions[pc].arg1, uint32_t(pc)));
+}
+/// move the operands of the instructions to the table 'to' (only
+/// the atoms that are not shared by both tables are added again)
+void subroutine::move_operands(atomTable &to) {
+  size_t shared = atoms->shared(to);
+  if (shared == atoms->size()) { atoms = &to; return; }
+  for (auto &inst : instructions) {
+    if (inst.arg1 >= shared) inst.arg1 = to.intern(atoms->text(inst.arg1));
+    if (inst.arg2 >= shared) inst.arg2 = to.intern(atoms->text(inst.arg2));
+    if (inst.arg3 >= shared) inst.arg3 = to.intern(atoms->text(inst.arg3));
+  }
+  atoms = &to;
+  index_labels();
+}
 /// get program counter for given label
-size_t subroutine::get_label_pc(std::string &lab) const { return labels.find(lab)->second; }
+size_t subroutine::get_label_pc(const std::string &lab) const {
+  atomTable::atom a;
+  if (not atoms->find(lab, a)) return instructions.size();
+  return get_label_pc(a);
+}
+size_t subroutine::get_label_pc(atomTable::atom lab) const {
+  auto it = labelPcs.find(lab);
+  return (it == labelPcs.end()) ? instructions.size() : it->second;
+}
+/// get number of instructions
+size_t subroutine::get_num_instructions() const { return instructions.size(); }
+/// check whether there are labels
+bool subroutine::has_labels() const { return numLabels > 0; }
 /// print (for debugging)
 string subroutine::dump() const {
-  string s;
-  s = "function " + name + "\n";
+  ostringstream s;
+  dump(s);
+  return s.str();
+}
+void subroutine::dump(ostream &os) const {
+  os << "function " << name << "\n";
   if (not params.empty()) {
-    s += "  params\n" ;
-    for (auto p : params) s += "    " + p.dump() + "\n";
-    s += "  endparams\n\n";
+    os << "  params\n";
+    for (auto &p : params) { os << "    "; p.dump(os); os << "\n"; }
+    os << "  endparams\n\n";
   }
   if (not vars.empty()) {
-    s += "  vars\n";
-    for (auto v : vars) s += "    " + v.dump() + "\n";
-    s += "  endvars\n\n";
+    os << "  vars\n";
+    for (auto &v : vars) { os << "    "; v.dump(os); os << "\n"; }
+    os << "  endvars\n\n";
   }
 
-  string ind = "  ";
-  if (labels.empty()) ind="";
-  for (auto i : instructions) s += ind + i.dump() + "\n";  
-  s += "endfunction\n\n";
-  return s;
+  const char *ind = "  ";
+  if (numLabels == 0) ind = "";
+  for (auto &i : instructions) { os << ind; i.dump(*atoms, os); os << "\n"; }
+  os << "endfunction\n\n";
 }
 
 ////////////////////////////////////////////////////////////////////
 /// Implementation for class 'subroutine'
 
-/// constructor
-code::code() {};
+/// constructor (streaming subroutines to os, if not null)
+code::code(atomTable &atoms, arena *mem, ostream *os) : atoms(&atoms), memory(mem), out(os) {};
 /// destructor
 code::~code() {};
 
+/// get the table of the operands
+atomTable & code::get_atoms() const { return *atoms; }
+/// get the arena of the subroutines
+arena * code::get_memory() const { return memory; }
 /// get most recently added subroutine 
 subroutine& code::get_last_subroutine() { return subs[subs.size()-1]; }
 /// get subroutine by name
@@ -270,28 +401,49 @@ const subroutine& code::get_subroutine(const string &name) const {
   size_t p = names.find(name)->second;
   return subs[p];
 }
+/// get number of subroutines
+size_t code::get_num_subroutines() const { return subs.size(); }
+/// get subroutine by position
+const subroutine& code::get_subroutine_at(size_t i) const { return subs[i]; }
 /// add subroutine
 void code::add_subroutine(const subroutine &s) {
-  subs.push_back(s);
+  subs.push_back(subroutine(s, memory));
+  subs.back().move_operands(*atoms);
   names.insert(make_pair(s.get_name(), subs.size()-1));
 }
+/// print the most recently added subroutine to the output stream
+/// (if any) and release it
+void code::flush_last_subroutine() {
+  if (not out) return;
+  subs.back().dump(*out);
+  names.erase(subs.back().get_name());
+  subs.pop_back();
+}
 /// print (for debugging)
 string code::dump() const {
-  string c;
-  for (auto s : subs) c += s.dump();
-  return c;
+  ostringstream c;
+  dump(c);
+  return c.str();
+}
+void code::dump(ostream &os) const {
+  for (auto &s : subs) s.dump(os);
 }
 
 
 ////////////////////////////////////////////////////////////////////
-/// Static methods to manage counters
-int counters::countIF = 0;
-int counters::countWHILE = 0;
-int counters::countTEMP = 0;
-
-string counters::newLabelIF() { return std::to_string(++countIF); }
-string counters::newLabelWHILE() { return std::to_string(++countWHILE); }
-string counters::newTEMP() { return std::to_string(++countTEMP); }
+/// Methods to manage counters
+counters::counters() : countIF(0), countWHILE(0), countTEMP(0) {}
+
+int counters::newLabelIF() { return ++countIF; }
+int counters::newLabelWHILE() { return ++countWHILE; }
+atomTable::atom counters::newTEMP(atomTable &atoms) { return label(atoms, "%", ++countTEMP); }
+
+atomTable::atom counters::label(atomTable &atoms, const char *prefix, int n) {
+  char text[32];
+  int length = snprintf(text, sizeof(text), "%s%d", prefix, n);
+  assert(length > 0 and size_t(length) < sizeof(text));
+  return atoms.intern(text, length);
+}
 
 void counters::resetLabelIF() { countIF = 0; }
 void counters::resetLabelWHILE() { countWHILE = 0; }
@@ -30,7 +30,14 @@
 
 #include <map>
 #include <list>
+#include <ostream>
 #include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+#include "arena.h"
+#include "atoms.h"
 
 /// predeclaration
 class instructionList;
@@ -41,8 +48,8 @@ class instructionList;
 class instruction {
 
  public:
-  /// instruction codes
-  typedef enum {_LABEL, _UJUMP, _FJUMP, _PUSH, _POP, _CALL, _RETURN,
+  /// instruction codes (stored in a single byte)
+  typedef enum : unsigned char {_LABEL, _UJUMP, _FJUMP, _PUSH, _POP, _CALL, _RETURN,
                 _ADD, _SUB, _MUL, _DIV, _EQ, _LT, _LE, _NEG, _NOT, _AND, _OR, _FLOAT,
                 _FADD, _FSUB, _FMUL, _FDIV, _FEQ, _FLT, _FLE, _FNEG,
                 _LOAD, _ILOAD, _CHLOAD, _FLOAD, _XLOAD, _LOADX, _ALOAD, _LOADC, _CLOAD,
@@ -50,131 +57,185 @@ class instruction {
   
   /// instruction code
   Operation oper;
-  /// arguments
-  std::string arg1, arg2, arg3;
+  /// arguments (atoms of the table of the instruction's code: its
+  /// temporals, variables, labels and literals)
+  atomTable::atom arg1, arg2, arg3;
+  /// program counter of the label a jump goes to, once the subroutine
+  /// has been finalized (the label operand is then only used to print it)
+  uint32_t target;
+
+  /// target of the instructions that are not (yet resolved) jumps
+  static const uint32_t NO_TARGET = UINT32_MAX;
   
-  /// constructor
-  instruction(Operation op,
-              const std::string &a1="", const std::string &a2="", const std::string &a3="");
+  /// constructor (the operands are atoms of the table of the code
+  /// where the instruction is added)
+  instruction(Operation op, atomTable::atom a1=atomTable::EMPTY,
+              atomTable::atom a2=atomTable::EMPTY, atomTable::atom a3=atomTable::EMPTY);
+  /// constructor from the texts of the operands (they are added to
+  /// the table 'atoms')
+  instruction(atomTable &atoms, Operation op,
+              const std::string &a1, const std::string &a2="", const std::string &a3="");
 
   /// destructor
   ~instruction();
 
   // concatenation of instruction+list (or instruction+instruction, via automatic coertion)
   instructionList operator||(const instructionList &lst) const;
+  instructionList operator||(instructionList &&lst) const;
 
   /// ------ specific constructors for each instruction -------
 
   // create new instruction "a1 :"
-  static instruction LABEL(const std::string &a1);
+  static instruction LABEL(atomTable::atom a1);
   // create new instruction "goto a1"
-  static instruction UJUMP(const std::string &a1);
+  static instruction UJUMP(atomTable::atom a1);
   // create new instruction "ifFalse a1 goto a2"
-  static instruction FJUMP(const std::string &a1, const std::string &a2);
+  static instruction FJUMP(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "pushparam a1"
-  static instruction PUSH(const std::string &a1="");
+  static instruction PUSH(atomTable::atom a1=atomTable::EMPTY);
   // create new instruction "popparam a1"
-  static instruction POP(const std::string &a1="");
+  static instruction POP(atomTable::atom a1=atomTable::EMPTY);
   // create new instruction "call a1"
-  static instruction CALL(const std::string &a1);
+  static instruction CALL(atomTable::atom a1);
   // create new instruction "return"
   static instruction RETURN();
   // create new instruction "a1 = a2 + a3"
-  static instruction ADD(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction ADD(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 - a3"
-  static instruction SUB(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction SUB(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 * a3"
-  static instruction MUL(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction MUL(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 / a3"
-  static instruction DIV(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction DIV(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 == a3"
-  static instruction EQ(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction EQ(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 < a3"
-  static instruction LT(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction LT(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 <= a3"
-  static instruction LE(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction LE(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 and a3"
-  static instruction AND(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction AND(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 or a3"
-  static instruction OR(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction OR(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 +. a3"
-  static instruction FADD(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction FADD(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 -. a3"
-  static instruction FSUB(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction FSUB(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 *. a3"
-  static instruction FMUL(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction FMUL(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 /. a3"
-  static instruction FDIV(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction FDIV(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 ==. a3"
-  static instruction FEQ(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction FEQ(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 <. a3"
-  static instruction FLT(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction FLT(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2 <=. a3"
-  static instruction FLE(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction FLE(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = not a2"
-  static instruction NOT(const std::string &a1, const std::string &a2);
+  static instruction NOT(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "a1 = - a2"
-  static instruction NEG(const std::string &a1, const std::string &a2);
+  static instruction NEG(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "a1 = -. a2"
-  static instruction FNEG(const std::string &a1, const std::string &a2);
+  static instruction FNEG(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "a1 = float a2"
-  static instruction FLOAT(const std::string &a1, const std::string &a2);  
+  static instruction FLOAT(atomTable::atom a1, atomTable::atom a2);  
   // create new instruction "a1 = a2"
-  static instruction LOAD(const std::string &a1, const std::string &a2);
+  static instruction LOAD(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "a1 = a2" (where a2 is an integer constant)
-  static instruction ILOAD(const std::string &a1, const std::string &a2);
+  static instruction ILOAD(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "a1 = a2" (where a2 is a character constant)
-  static instruction CHLOAD(const std::string &a1, const std::string &a2);
+  static instruction CHLOAD(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "a1 = a2" (where a2 is a float constant)
-  static instruction FLOAD(const std::string &a1, const std::string &a2);
+  static instruction FLOAD(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "a1[a2] = a3" 
-  static instruction XLOAD(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction XLOAD(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = a2[a3]" 
-  static instruction LOADX(const std::string &a1, const std::string &a2, const std::string &a3);
+  static instruction LOADX(atomTable::atom a1, atomTable::atom a2, atomTable::atom a3);
   // create new instruction "a1 = &a2" 
-  static instruction ALOAD(const std::string &a1, const std::string &a2);
+  static instruction ALOAD(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "a1 = *a2" 
-  static instruction LOADC(const std::string &a1, const std::string &a2);
+  static instruction LOADC(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "*a1 = a2" 
-  static instruction CLOAD(const std::string &a1, const std::string &a2);
+  static instruction CLOAD(atomTable::atom a1, atomTable::atom a2);
   // create new instruction "readi a1" 
-  static instruction READI(const std::string &a1);
+  static instruction READI(atomTable::atom a1);
   // create new instruction "readf a1" 
-  static instruction READF(const std::string &a1);
+  static instruction READF(atomTable::atom a1);
   // create new instruction "readc a1" 
-  static instruction READC(const std::string &a1);
+  static instruction READC(atomTable::atom a1);
   // create new instruction "writei a1" 
-  static instruction WRITEI(const std::string &a1); 
+  static instruction WRITEI(atomTable::atom a1); 
   // create new instruction "writef a1" 
-  static instruction WRITEF(const std::string &a1);
+  static instruction WRITEF(atomTable::atom a1);
   // create new instruction "writec a1" 
-  static instruction WRITEC(const std::string &a1);
+  static instruction WRITEC(atomTable::atom a1);
   // create new instruction "writeln" 
   static instruction WRITELN();
   // create new instruction "noop" (not really needed) 
   static instruction NOOP();
   
-  // print instruction
-  std::string dump() const;   
+  // print instruction (with the texts of its operands in 'atoms')
+  std::string dump(const atomTable &atoms) const;
+  void dump(const atomTable &atoms, std::ostream &os) const;
 };
 
 ////////////////////////////////////////////////////////////////////
-/// Class instructionList stores a list of instructions
-
-class instructionList : public std::vector<instruction> {
+/// Class instructionList stores a list of instructions. Lists that
+/// are temporaries (or std::move'd) are spliced when concatenated,
+/// so joining them costs O(1) instead of copying their instructions.
+/// The lists made by a thread (created or copied) take their nodes
+/// from the arena given to it by the innermost useArena alive in the
+/// thread (e.g. the one of the code being generated), or from the
+/// general heap if there is none. A list keeps its arena when it is
+/// moved, so it can be moved between the nodes of the tree without
+/// copies, but it must only grow in the thread of its arena, and it
+/// must be destroyed (or emptied) before the arena.
+
+class instructionList : public std::list<instruction, arena_allocator<instruction>> {
  public:
+   // the list of the base class
+   typedef std::list<instruction, arena_allocator<instruction>> nodeList;
+
+   // the lists made by the thread take their nodes from 'mem' while
+   // an object of this class is alive
+   class useArena {
+    public:
+      explicit useArena(arena *mem);
+      ~useArena();
+    private:
+      arena *previous;
+      useArena(const useArena &) = delete;
+      useArena & operator=(const useArena &) = delete;
+   };
+
    // constructor
    instructionList();
    // constructor from a single instruction
    instructionList(const instruction &);
+   // copy (in the arena of the thread) and move (keeping the arena)
+   // constructors and assignments
+   instructionList(const instructionList &);
+   instructionList(instructionList &&) = default;
+   instructionList & operator=(const instructionList &) = default;
+   instructionList & operator=(instructionList &&) = default;
    // destructor
    ~instructionList();
 
-   // concatenation of lists (or list+instruction, via automatic coertion)
-   instructionList operator||(const instructionList &lst) const;
+   // concatenation of lists (or list+instruction, via automatic coertion).
+   // Only the operands that are lvalues get copied.
+   instructionList operator||(const instructionList &lst) const &;
+   instructionList operator||(instructionList &&lst) const &;
+   instructionList operator||(const instructionList &lst) &&;
+   instructionList operator||(instructionList &&lst) &&;
+
+   // print instructionList (with the texts of the operands in 'atoms')
+   std::string dump(const atomTable &atoms) const;
+   void dump(const atomTable &atoms, std::ostream &os) const;
 
-   // print instructionList
-   std::string dump() const;   
+ private:
+   // add the instructions of lst at the end, splicing its nodes if
+   // they are in the same arena (or else copying them)
+   void append(instructionList &&lst);
 };
 
 
@@ -192,6 +253,7 @@ class var {
 
   // print var
   std::string dump() const; 
+  void dump(std::ostream &os) const;
 };
 
 ////////////////////////////////////////////////////////////////////
@@ -202,41 +264,70 @@ class subroutine {
  private:
   /// name of the subroutine
   std::string name;
-  /// instructions
-  instructionList instructions;
-  /// map label name -> position in instructions
-  std::map<std::string, size_t> labels;
+  /// table of the atoms of the operands of its instructions
+  atomTable *atoms;
+  /// instructions (flattened, to be accessed by program counter)
+  std::vector<instruction, arena_allocator<instruction>> instructions;
+  /// number of labels among the instructions
+  size_t numLabels;
+  /// program counter of each label, by the atom of its name (built
+  /// by finalize)
+  std::unordered_map<atomTable::atom, uint32_t> labelPcs;
 
  public:
   /// list of local variables
-  std::list<var> vars;
+  std::list<var, arena_allocator<var>> vars;
   /// list of params
-  std::list<var> params;  
+  std::list<var, arena_allocator<var>> params;  
 
-  /// constructor and destructor
-  subroutine(const std::string &sname);
+  /// constructor (its instructions have their operands in 'atoms', and
+  /// its containers take memory from 'mem', or the general heap if it
+  /// is null) and destructor
+  subroutine(const std::string &sname, atomTable &atoms, arena *mem = nullptr);
   ~subroutine();
 
   /// get subroutine name
   std::string get_name() const;
+  /// get the table of the operands of its instructions
+  atomTable & get_atoms() const;
   /// add a local var to subroutine
   void add_var(const std::string &name, size_t sz);
   /// add a parameter (size is always 1)
   void add_param(const std::string &name);
-  /// add an instruction
+  /// add an instruction (finalize must be called once all of them are added)
   void add_instruction(const instruction &inst);
-  /// add instruction list to current instructions
+  /// add instruction list to current instructions (and finalize)
   void add_instructions(const instructionList &lins);
-  /// set instruction list (overwritting current instructions)
+  /// set instruction list (overwritting current instructions, and finalize)
   void set_instructions(const instructionList &lins);
+  /// resolve the target of every jump to the program counter of its label
+  void finalize();
   
-  /// get instruction at given program counter in subroutine
-  instruction get_instruction_at(size_t pc) const;
-  /// get program counter in subroutine for given label
-  size_t get_label_pc(std::string &lab) const;
+  /// get instruction at given program counter in subroutine (an
+  /// _INVALID instruction if pc is out of range)
+  const instruction & get_instruction_at(size_t pc) const;
+  /// get program counter in subroutine for given label (the number of
+  /// instructions if there is no such label)
+  size_t get_label_pc(const std::string &lab) const;
+  size_t get_label_pc(atomTable::atom lab) const;
+  /// get number of instructions in subroutine
+  size_t get_num_instructions() const;
+  /// check whether the subroutine has any label
+  bool has_labels() const;
 
   // print subroutine (params, vars, and instructions)
   std::string dump() const;
+  void dump(std::ostream &os) const;
+
+ private:
+  /// make the instructions use the atoms of the table 'to' (adding to
+  /// it the operands that are not there)
+  void move_operands(atomTable &to);
+  /// copy of s with its containers in the arena 'mem'
+  subroutine(const subroutine &s, arena *mem);
+  /// fill labelPcs with the labels among the instructions
+  void index_labels();
+  friend class code;
 };
 
 ////////////////////////////////////////////////////////////////////
@@ -244,52 +335,86 @@ class subroutine {
 
 class code {
  private:
+  /// table of the operands of the instructions of its subroutines
+  atomTable *atoms;
+  /// arena of the subroutines (null for the general heap)
+  arena *memory;
   /// subroutines (including main progam)
   std::vector<subroutine> subs;
   /// index to access subroutines by name
   std::map<std::string, size_t> names;
+  /// stream where finished subroutines are printed (if not null)
+  std::ostream *out;
   
  public:
-  /// constructor and destructor
-  code();
+  /// constructor (the instructions of its subroutines have their
+  /// operands in 'atoms', and are kept in the arena 'mem', or in the
+  /// general heap if it is null; if 'os' is not null, the code is
+  /// printed to it as it is generated, one subroutine at a time, see
+  /// flush_last_subroutine) and destructor
+  code(atomTable &atoms, arena *mem = nullptr, std::ostream *os = nullptr);
   ~code();
 
+  /// get the table of the operands of its instructions
+  atomTable & get_atoms() const;
+  /// get the arena of its subroutines (null for the general heap)
+  arena * get_memory() const;
   /// get most recently added subroutine (i.e. the one currently being processed)
   subroutine& get_last_subroutine();
   /// get subroutine by name
   const subroutine& get_subroutine(const std::string &name) const;
-  /// add new subroutine
+  /// get number of subroutines
+  size_t get_num_subroutines() const;
+  /// get subroutine by position (in the order they were added)
+  const subroutine& get_subroutine_at(size_t i) const;
+  /// add new subroutine (copied into the arena of the code; if its
+  /// operands are in another table, e.g. it was generated in another
+  /// thread with an extension of this one, they are added to this one)
   void add_subroutine(const subroutine &s);
+  /// print the most recently added subroutine to the output stream,
+  /// and release it (nothing is done if the code has no output stream)
+  void flush_last_subroutine();
 
-  // print code (all info for all subroutines)
+  // print code (all info for all subroutines not yet flushed)
   std::string dump() const;
+  void dump(std::ostream &os) const;
 };
 
 
 ////////////////////////////////////////////////////////////////////
-/// Class counters manages temporal and labels counters
+/// Class counters manages temporal and labels counters. Each
+/// compilation (or function being compiled) owns its own counters,
+/// so that several of them can be generated at the same time
 
 class counters {
  private:
-   static int countIF;
-   static int countWHILE;
-   static int countTEMP;
+   int countIF;
+   int countWHILE;
+   int countTEMP;
   
  public:
-   // return id for new label or temp (id is a number, but returned as string
-   // to ease concatenation with other literals (e.g. "labelIF" + "4" -> "LabelIF4")
-   static std::string newLabelIF();
-   static std::string newLabelWHILE();
-   static std::string newTEMP();
+   // constructor (all counters start at zero)
+   counters();
+
+   // return id for new label (a number, the suffix of the labels of an
+   // if or a while, see label)
+   int newLabelIF();
+   int newLabelWHILE();
+   // return the atom of a new temp in 'atoms' (e.g. "%4"). It is
+   // interned straight from its digits, without making a std::string
+   atomTable::atom newTEMP(atomTable &atoms);
+   // return the atom in 'atoms' of a label: prefix followed by the
+   // id n (e.g. "endif" and 4 -> "endif4")
+   static atomTable::atom label(atomTable &atoms, const char *prefix, int n);
 
    // reset individual counters 
-   static void resetLabelIF();
-   static void resetLabelWHILE();
-   static void resetTEMP();
+   void resetLabelIF();
+   void resetLabelWHILE();
+   void resetTEMP();
 
    // reset label counters (IF and WHILE)
-   static void resetLabels();
+   void resetLabels();
    // reset all counters (IF, WHILE, and TEMP)
-   static void reset();
+   void reset();
 };
 
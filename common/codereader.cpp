@@ -0,0 +1,319 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "codereader.h"
+#include "code.h"
+#include "mappedfile.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <limits>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Auxiliary class with a piece of the text (it does not own it)
+
+class textRange {
+ public:
+  const char *b, *e;
+
+  textRange(const char *begin, const char *end) : b(begin), e(end) {}
+
+  bool empty() const { return b == e; }
+  string str() const { return string(b, e); }
+  /// atom of the text in the table 'atoms' (added if it is new)
+  atomTable::atom atom(atomTable &atoms) const { return atoms.intern(b, e-b); }
+  bool operator==(const char *s) const {
+    size_t n = strlen(s);
+    return size_t(e-b) == n and memcmp(b, s, n) == 0;
+  }
+  bool operator!=(const char *s) const { return not (*this == s); }
+
+  /// remove (and return) the next word, skipping blanks before it
+  textRange next_word() {
+    while (b != e and (*b == ' ' or *b == '\t')) ++b;
+    const char *w = b;
+    while (b != e and *b != ' ' and *b != '\t') ++b;
+    return textRange(w, b);
+  }
+  /// whether there are only blanks left
+  bool blank() const {
+    for (const char *p = b; p != e; ++p)
+      if (*p != ' ' and *p != '\t') return false;
+    return true;
+  }
+};
+
+/// check whether a word is a number (with or without decimal point)
+static bool is_number(const textRange &w, bool &isFloat) {
+  const char *p = w.b;
+  if (p != w.e and (*p == '-' or *p == '+')) ++p;
+  bool digits = false;
+  isFloat = false;
+  for (; p != w.e; ++p) {
+    if (*p >= '0' and *p <= '9') digits = true;
+    else if (*p == '.' and not isFloat) isFloat = true;
+    else if ((*p == 'e' or *p == 'E') and digits) {
+      isFloat = true;
+      if (p+1 != w.e and (p[1] == '-' or p[1] == '+')) ++p;
+    }
+    else return false;
+  }
+  return digits;
+}
+
+/// binary operators, as printed by instruction::dump
+static const struct { const char *text; instruction::Operation oper; } binaryOps[] = {
+  {"+", instruction::_ADD},   {"-", instruction::_SUB},   {"*", instruction::_MUL},
+  {"/", instruction::_DIV},   {"and", instruction::_AND}, {"or", instruction::_OR},
+  {"==", instruction::_EQ},   {"<", instruction::_LT},    {"<=", instruction::_LE},
+  {"+.", instruction::_FADD}, {"-.", instruction::_FSUB}, {"*.", instruction::_FMUL},
+  {"/.", instruction::_FDIV}, {"==.", instruction::_FEQ}, {"<.", instruction::_FLT},
+  {"<=.", instruction::_FLE}
+};
+
+/// instructions with a single operand, as printed by instruction::dump
+static const struct { const char *text; instruction::Operation oper; } unaryInsts[] = {
+  {"goto", instruction::_UJUMP}, {"call", instruction::_CALL},
+  {"readi", instruction::_READI}, {"readf", instruction::_READF}, {"readc", instruction::_READC},
+  {"writei", instruction::_WRITEI}, {"writef", instruction::_WRITEF}, {"writec", instruction::_WRITEC}
+};
+
+/// parse an instruction (the line has no comment nor leading blanks)
+static bool parse_instruction(textRange line, atomTable &atoms, instruction &inst) {
+  textRange w = line.next_word();
+
+  if (w == "label") {
+    textRange lab = line.next_word();
+    if (lab.empty() or line.next_word() != ":" or not line.blank()) return false;
+    inst = instruction::LABEL(lab.atom(atoms));
+    return true;
+  }
+  if (w == "ifFalse") {
+    textRange cond = line.next_word();
+    if (cond.empty() or line.next_word() != "goto") return false;
+    textRange lab = line.next_word();
+    if (lab.empty() or not line.blank()) return false;
+    inst = instruction::FJUMP(cond.atom(atoms), lab.atom(atoms));
+    return true;
+  }
+  if (w == "pushparam" or w == "popparam") {
+    textRange a = line.next_word();
+    if (not line.blank()) return false;
+    inst = w == "pushparam" ? instruction::PUSH(a.atom(atoms)) : instruction::POP(a.atom(atoms));
+    return true;
+  }
+  if (w == "return" or w == "writeln" or w == "noop") {
+    if (not line.blank()) return false;
+    inst = w == "return" ? instruction::RETURN() :
+           w == "writeln" ? instruction::WRITELN() : instruction::NOOP();
+    return true;
+  }
+  for (auto &u : unaryInsts) {
+    if (w == u.text) {
+      textRange a = line.next_word();
+      if (a.empty() or not line.blank()) return false;
+      inst = instruction(u.oper, a.atom(atoms));
+      return true;
+    }
+  }
+
+  // the rest are assignments: "*x = y", "x[i] = y" or "x = <expression>"
+  if (line.next_word() != "=") return false;
+  if (w.e - w.b > 1 and *w.b == '*') {
+    textRange a = line.next_word();
+    if (a.empty() or not line.blank()) return false;
+    inst = instruction::CLOAD(textRange(w.b+1, w.e).atom(atoms), a.atom(atoms));
+    return true;
+  }
+  if (w.e - w.b > 3 and *(w.e-1) == ']') {
+    const char *open = static_cast<const char *>(memchr(w.b, '[', w.e-w.b));
+    textRange a = line.next_word();
+    if (not open or open == w.b or open+1 == w.e-1 or a.empty() or not line.blank()) return false;
+    inst = instruction::XLOAD(textRange(w.b, open).atom(atoms), textRange(open+1, w.e-1).atom(atoms), a.atom(atoms));
+    return true;
+  }
+  atomTable::atom dest = w.atom(atoms);
+
+  // character constant (which can be a blank, or an escape sequence)
+  const char *q = line.b;
+  while (q != line.e and (*q == ' ' or *q == '\t')) ++q;
+  if (q != line.e and *q == '\'') {
+    const char *last = line.e;
+    while (last != q and *(last-1) != '\'') --last;
+    if (last-1 == q) return false;
+    for (const char *p = last; p != line.e; ++p)
+      if (*p != ' ' and *p != '\t') return false;
+    inst = instruction::CHLOAD(dest, textRange(q+1, last-1).atom(atoms));
+    return true;
+  }
+
+  // "x =  - y" and "x =  -. y" are subtractions with an empty first
+  // operand (negations are printed with a single blank after '=')
+  bool emptyFirst = line.e - line.b > 2 and line.b[0] == ' ' and line.b[1] == ' ';
+
+  textRange w1 = line.next_word();
+  textRange w2 = line.next_word();
+  textRange w3 = line.next_word();
+  if (w1.empty() or not line.blank()) return false;
+
+  if (w2.empty()) {
+    if (w1.e - w1.b > 1 and (*w1.b == '&' or *w1.b == '*')) {
+      atomTable::atom a = textRange(w1.b+1, w1.e).atom(atoms);
+      inst = *w1.b == '&' ? instruction::ALOAD(dest, a) : instruction::LOADC(dest, a);
+      return true;
+    }
+    if (w1.e - w1.b > 3 and *(w1.e-1) == ']') {
+      const char *open = static_cast<const char *>(memchr(w1.b, '[', w1.e-w1.b));
+      if (not open or open == w1.b or open+1 == w1.e-1) return false;
+      inst = instruction::LOADX(dest, textRange(w1.b, open).atom(atoms), textRange(open+1, w1.e-1).atom(atoms));
+      return true;
+    }
+    bool isFloat;
+    if (is_number(w1, isFloat))
+      inst = isFloat ? instruction::FLOAD(dest, w1.atom(atoms)) : instruction::ILOAD(dest, w1.atom(atoms));
+    else
+      inst = instruction::LOAD(dest, w1.atom(atoms));
+    return true;
+  }
+  if (w3.empty()) {
+    if (w1 == "-" and emptyFirst) inst = instruction::SUB(dest, atomTable::EMPTY, w2.atom(atoms));
+    else if (w1 == "-." and emptyFirst) inst = instruction::FSUB(dest, atomTable::EMPTY, w2.atom(atoms));
+    else if (w1 == "-") inst = instruction::NEG(dest, w2.atom(atoms));
+    else if (w1 == "-.") inst = instruction::FNEG(dest, w2.atom(atoms));
+    else if (w1 == "not") inst = instruction::NOT(dest, w2.atom(atoms));
+    else if (w1 == "float") inst = instruction::FLOAT(dest, w2.atom(atoms));
+    else return false;
+    return true;
+  }
+  for (auto &op : binaryOps) {
+    if (w2 == op.text) {
+      inst = instruction(op.oper, dest, w1.atom(atoms), w3.atom(atoms));
+      return true;
+    }
+  }
+  return false;
+}
+
+bool read_code(const char *text, size_t n, code &c, std::string &error) {
+  enum { OUTSIDE, BODY, PARAMS, VARS } state = OUTSIDE;
+  atomTable &atoms = c.get_atoms();
+  subroutine sub("", atoms);
+  size_t lineNumber = 0;
+  const char *end = text + n;
+
+  for (const char *p = text; p != end; ) {
+    ++lineNumber;
+    const char *eol = static_cast<const char *>(memchr(p, '\n', end-p));
+    if (not eol) eol = end;
+    textRange line(p, eol);
+    p = (eol == end) ? end : eol+1;
+
+    // remove comment, trailing blanks and leading blanks
+    for (const char *s = line.b; s+2 < line.e; ++s)
+      if (s[0] == ';' and s[1] == ';' and s[2] == ';') { line.e = s; break; }
+    while (line.e != line.b and (line.e[-1] == ' ' or line.e[-1] == '\t' or line.e[-1] == '\r')) --line.e;
+    while (line.b != line.e and (*line.b == ' ' or *line.b == '\t')) ++line.b;
+    if (line.empty()) continue;
+
+    textRange rest = line;
+    textRange w = rest.next_word();
+    bool ok = true;
+    switch (state) {
+    case OUTSIDE: {
+      textRange name = rest.next_word();
+      ok = w == "function" and not name.empty() and rest.blank();
+      if (ok) {
+        sub = subroutine(name.str(), atoms);
+        state = BODY;
+      }
+      break;
+    }
+    case PARAMS:
+      ok = rest.blank();
+      if (w == "endparams") state = BODY;
+      else if (ok) sub.add_param(w.str());
+      break;
+    case VARS: {
+      if (w == "endvars") {
+        ok = rest.blank();
+        state = BODY;
+        break;
+      }
+      textRange size = rest.next_word();
+      ok = not size.empty() and rest.blank();
+      for (const char *d = size.b; ok and d != size.e; ++d) ok = *d >= '0' and *d <= '9';
+      if (not ok) break;
+      // the sizes must fit in 32 bits (see objVar)
+      errno = 0;
+      unsigned long long sz = strtoull(size.str().c_str(), nullptr, 10);
+      if (errno == ERANGE or sz > numeric_limits<uint32_t>::max()) {
+        error = "line " + to_string(lineNumber) + ": size of '" + w.str() + "' out of range";
+        return false;
+      }
+      sub.add_var(w.str(), sz);
+      break;
+    }
+    case BODY:
+      if (w == "params" and rest.blank()) state = PARAMS;
+      else if (w == "vars" and rest.blank()) state = VARS;
+      else if (w == "endfunction" and rest.blank()) {
+        sub.finalize();
+        c.add_subroutine(sub);
+        state = OUTSIDE;
+      }
+      else {
+        instruction inst(instruction::_INVALID);
+        ok = parse_instruction(line, atoms, inst);
+        if (ok) sub.add_instruction(inst);
+      }
+      break;
+    }
+    if (not ok) {
+      error = "line " + to_string(lineNumber) + ": unexpected '" + line.str() + "'";
+      return false;
+    }
+  }
+
+  if (state != OUTSIDE) {
+    error = "line " + to_string(lineNumber) + ": missing 'endfunction'";
+    return false;
+  }
+  return true;
+}
+
+bool read_code_file(const string &filename, code &c, string &error) {
+  mappedFile file;
+  if (not file.open(filename)) {
+    error = "can not read file " + filename;
+    return false;
+  }
+  return read_code(file.data(), file.size(), c, error);
+}
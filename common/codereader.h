@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#include "code.h"
+
+////////////////////////////////////////////////////////////////////
+/// Reader of t-code in text format: the one printed by code::dump,
+/// and also the one of hand-written programs (with ';;;' comments
+/// and any indentation). The text is read in a single pass, without
+/// copying it: only the operands are added to the atom table of the code.
+/// If there is any error, false is returned and 'error' tells the
+/// line and the reason.
+
+/// read t-code from a buffer of n characters, adding its subroutines to c
+bool read_code(const char *text, size_t n, code &c, std::string &error);
+/// read t-code from a file (that is mapped in memory), adding its subroutines to c
+bool read_code_file(const std::string &filename, code &c, std::string &error);
@@ -0,0 +1,245 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "compcache.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include <cstdio>       // rename, remove
+#include <cstring>      // memcpy
+#include <dirent.h>     // opendir, readdir
+#include <fcntl.h>      // open
+#include <unistd.h>     // getpid, read, write, lseek, ftruncate, close
+#include <sys/file.h>   // flock
+#include <utime.h>      // utime
+#include <sys/stat.h>   // mkdir, stat
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'compilationCache'
+
+/// name of the file with the statistics, inside the directory
+static const char *STATS_FILE = "stats";
+
+/// constructor
+compilationCache::compilationCache(const string &dirname, size_t max) :
+  dir(dirname), maxBytes(max), numHits(0), numMisses(0), stored(false), storedBytes(0) {
+  mkdir(dir.c_str(), 0777);
+}
+/// destructor
+compilationCache::~compilationCache() {
+  // a final sweep, for what was stored since the last eviction
+  if (stored) evict();
+  if (numHits + numMisses > 0) saveStatistics();
+}
+
+/// 64-bit block rotation and finalization mix of MurmurHash3
+static inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+static inline uint64_t fmix64(uint64_t k) {
+  k ^= k >> 33; k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33; k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+/// key of some contents: their MurmurHash3 (x64, 128 bits) in hex
+string compilationCache::key(const char *data, size_t size) {
+  const uint64_t c1 = 0x87c37b91114253d5ULL, c2 = 0x4cf5ad432745937fULL;
+  uint64_t h1 = 0, h2 = 0;
+  size_t nblocks = size / 16;
+  for (size_t i = 0; i < nblocks; ++i) {
+    uint64_t k1, k2;
+    memcpy(&k1, data + 16*i, 8);
+    memcpy(&k2, data + 16*i + 8, 8);
+    k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    h1 = rotl64(h1, 27); h1 += h2; h1 = h1*5 + 0x52dce729;
+    k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+    h2 = rotl64(h2, 31); h2 += h1; h2 = h2*5 + 0x38495ab5;
+  }
+  const unsigned char *tail = reinterpret_cast<const unsigned char *>(data + 16*nblocks);
+  size_t rest = size & 15;
+  uint64_t k1 = 0, k2 = 0;
+  for (size_t i = rest; i > 8; --i) k2 ^= uint64_t(tail[i-1]) << (8*(i-9));
+  if (rest > 8) {
+    k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+  }
+  for (size_t i = min(rest, size_t(8)); i > 0; --i) k1 ^= uint64_t(tail[i-1]) << (8*(i-1));
+  if (rest > 0) {
+    k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+  }
+  h1 ^= size; h2 ^= size;
+  h1 += h2; h2 += h1;
+  h1 = fmix64(h1); h2 = fmix64(h2);
+  h1 += h2; h2 += h1;
+
+  char hex[33];
+  snprintf(hex, sizeof(hex), "%016llx%016llx",
+           static_cast<unsigned long long>(h1), static_cast<unsigned long long>(h2));
+  return hex;
+}
+
+/// path of an entry
+string compilationCache::entryPath(const string &key) const {
+  return dir + "/" + key;
+}
+
+/// temporary file for 'path'
+string compilationCache::tempPath(const string &path) {
+  static atomic<unsigned> count(0);
+  return path + ".tmp" + to_string(getpid()) + "." + to_string(count++);
+}
+
+/// get an entry (and mark it as recently used). Its file has the size
+/// of its key material in decimal and a newline, the key material and
+/// the output
+bool compilationCache::lookup(const string &material, string &output) {
+  string path = entryPath(key(material.data(), material.size()));
+  ifstream entry(path, ios::binary);
+  size_t size;
+  if (not entry or not (entry >> size) or entry.get() != '\n' or size != material.size()) {
+    ++numMisses;
+    return false;
+  }
+  vector<char> stored(size);
+  if (not entry.read(stored.data(), size) or
+      not equal(stored.begin(), stored.end(), material.begin())) {
+    ++numMisses;
+    return false;
+  }
+  ostringstream contents;
+  contents << entry.rdbuf();
+  output = contents.str();
+  utime(path.c_str(), nullptr);
+  ++numHits;
+  return true;
+}
+
+/// store an entry (written aside and renamed, so that a concurrent
+/// lookup never finds an incomplete entry), and evict the oldest ones
+/// once an eighth of the maximum size has been stored since the last
+/// time (unless another thread is already doing it)
+void compilationCache::store(const string &material, const string &output) {
+  string path = entryPath(key(material.data(), material.size()));
+  string temp = tempPath(path);
+  {
+    ofstream entry(temp, ios::binary);
+    if (not entry) return;
+    entry << material.size() << '\n';
+    entry.write(material.data(), material.size());
+    entry.write(output.data(), output.size());
+    if (not entry) {
+      entry.close();
+      remove(temp.c_str());
+      return;
+    }
+  }
+  if (rename(temp.c_str(), path.c_str()) != 0) {
+    remove(temp.c_str());
+    return;
+  }
+  stored = true;
+  if ((storedBytes += material.size() + output.size()) < maxBytes/8) return;
+  unique_lock<mutex> l(evicting, try_to_lock);
+  if (not l.owns_lock()) return;
+  storedBytes = 0;
+  evict();
+}
+
+/// hits and misses
+size_t compilationCache::hits() const { return numHits; }
+size_t compilationCache::misses() const { return numMisses; }
+
+/// remove the entries with the oldest modification time (updated by
+/// every lookup that finds them) until the directory is 3/4 full
+void compilationCache::evict() {
+  DIR *d = opendir(dir.c_str());
+  if (d == nullptr) return;
+  vector<pair<time_t, string>> entries;
+  size_t total = 0;
+  while (struct dirent *e = readdir(d)) {
+    string name = e->d_name;
+    if (name.size() != 32) continue;   // only the entries (no temporaries)
+    struct stat st;
+    string path = dir + "/" + name;
+    if (stat(path.c_str(), &st) != 0 or not S_ISREG(st.st_mode)) continue;
+    entries.push_back(make_pair(st.st_mtime, path));
+    total += st.st_size;
+  }
+  closedir(d);
+  if (total <= maxBytes) return;
+
+  sort(entries.begin(), entries.end());
+  for (auto &e : entries) {
+    if (total <= maxBytes/4*3) break;
+    struct stat st;
+    if (stat(e.second.c_str(), &st) == 0 and remove(e.second.c_str()) == 0)
+      total -= min(total, size_t(st.st_size));
+  }
+}
+
+/// add the hits and misses to the totals kept in the directory (as
+/// "hits <n>" and "misses <n>" lines). The file is locked while it is
+/// read and written again, so concurrent processes do not lose updates
+void compilationCache::saveStatistics() {
+  string path = dir + "/" + STATS_FILE;
+  int fd = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+  if (fd < 0) return;
+  if (flock(fd, LOCK_EX) != 0) {
+    close(fd);
+    return;
+  }
+  string contents;
+  char buffer[256];
+  ssize_t n;
+  while ((n = read(fd, buffer, sizeof(buffer))) > 0) contents.append(buffer, n);
+  size_t totalHits = 0, totalMisses = 0;
+  {
+    istringstream stats(contents);
+    string word;
+    size_t count;
+    while (stats >> word >> count) {
+      if (word == "hits") totalHits = count;
+      else if (word == "misses") totalMisses = count;
+    }
+  }
+  ostringstream stats;
+  stats << "hits " << totalHits + numHits << "\n";
+  stats << "misses " << totalMisses + numMisses << "\n";
+  contents = stats.str();
+  if (lseek(fd, 0, SEEK_SET) == 0 and ftruncate(fd, 0) == 0) {
+    // (a failed write just loses the statistics of this process)
+    ssize_t written = write(fd, contents.data(), contents.size());
+    (void)written;
+  }
+  close(fd);    // (that releases the lock)
+}
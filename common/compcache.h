@@ -0,0 +1,95 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////
+/// Class compilationCache keeps, in a directory, the output of
+/// previous compilations indexed by a 128-bit hash of their input
+/// (and of everything else the output depends on, all together the
+/// key material), so that compiling again the same input only costs
+/// hashing it and reading a file. Each entry also keeps its key
+/// material, that is compared on lookup, so two inputs with the same
+/// hash never get the output of each other.
+/// The entries are replaced least recently used first when the
+/// directory grows over its maximum size (checked every time another
+/// eighth of it has been stored, and when the cache is destroyed).
+/// Lookups and stores can be done from several threads at once.
+
+class compilationCache {
+ public:
+  /// constructor (the directory is created if it does not exist) and
+  /// destructor (evicts entries if needed, and saves the statistics)
+  compilationCache(const std::string &dirname, size_t maxBytes = 512*1024*1024);
+  ~compilationCache();
+
+  /// key of an entry for the given key material
+  static std::string key(const char *data, size_t size);
+
+  /// get the output stored with some key material (returns false if
+  /// there is none)
+  bool lookup(const std::string &material, std::string &output);
+  /// store the output for some key material (errors are silently
+  /// ignored: the output will just have to be generated again)
+  void store(const std::string &material, const std::string &output);
+
+  /// lookups that found (or not) their entry, in this process
+  size_t hits() const;
+  size_t misses() const;
+
+ private:
+  std::string dir;
+  size_t maxBytes;
+  std::atomic<size_t> numHits, numMisses;
+  /// whether some entry has been stored (so eviction may be needed)
+  std::atomic<bool> stored;
+  /// bytes stored since the last eviction
+  std::atomic<size_t> storedBytes;
+  /// held while evicting (by a single thread at a time)
+  std::mutex evicting;
+
+  /// path of the file of an entry
+  std::string entryPath(const std::string &key) const;
+  /// path (unique in all the processes and threads) where a file is
+  /// written before it is renamed to 'path'
+  static std::string tempPath(const std::string &path);
+  /// remove the least recently used entries while over the limit
+  void evict();
+  /// add the statistics of this process to the ones in the directory
+  void saveStatistics();
+
+  /// no copies
+  compilationCache(const compilationCache &) = delete;
+  compilationCache & operator=(const compilationCache &) = delete;
+};
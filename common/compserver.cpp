@@ -0,0 +1,355 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "compserver.h"
+
+#include <sstream>
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include <cerrno>
+#include <cstring>      // memcpy, strerror
+#include <fcntl.h>      // fcntl
+#include <poll.h>       // poll
+#include <unistd.h>     // read, write, close, unlink, pipe
+#include <sys/socket.h> // socket, bind, listen, accept, send
+#include <sys/stat.h>   // stat
+#include <sys/un.h>     // sockaddr_un
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'compileServer'
+
+/// number of latencies kept (of the last compilations) for the percentiles
+static const size_t MAX_LATENCIES = 4096;
+/// longest header line of a request, and largest source accepted
+static const size_t MAX_HEADER = 64;
+static const size_t MAX_SOURCE = 256*1024*1024;
+/// milliseconds between checks of whether the server is stopping
+static const int POLL_MS = 200;
+/// milliseconds that the rest of a request, once it has begun, is
+/// waited for before the connection is closed
+static const int REQUEST_TIMEOUT_MS = 10000;
+
+/// wait until there is something to read in fd (returns false on
+/// error, once the deadline has passed, or as soon as the server is
+/// stopping)
+static bool waitReadable(int fd, const atomic<bool> &stopping,
+                         chrono::steady_clock::time_point deadline) {
+  struct pollfd p;
+  p.fd = fd;
+  p.events = POLLIN;
+  while (not stopping) {
+    auto left = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+    if (left.count() <= 0) return false;
+    int n = poll(&p, 1, int(min<chrono::milliseconds::rep>(left.count(), POLL_MS)));
+    if (n > 0) return true;
+    if (n < 0 and errno != EINTR) return false;
+  }
+  return false;
+}
+
+/// wake up the poll of the dispatcher, writing to the pipe 'fd' (if it
+/// is full, the dispatcher has yet to read it anyway)
+static void wakeUp(int fd) {
+  char c = 0;
+  while (write(fd, &c, 1) < 0 and errno == EINTR) continue;
+}
+
+/// the socket of a client, with the data received and not used yet
+struct compileServer::connection {
+  int fd;
+  string received;
+  /// the server is stopping, and time limit of the current request
+  const atomic<bool> &stopping;
+  chrono::steady_clock::time_point deadline;
+
+  connection(int fd, const atomic<bool> &stopping) : fd(fd), stopping(stopping) {}
+  ~connection() { close(fd); }
+
+  /// receive some more data (false at the end, or on error)
+  bool receive() {
+    if (not waitReadable(fd, stopping, deadline)) return false;
+    char chunk[64*1024];
+    ssize_t n = ::read(fd, chunk, sizeof(chunk));
+    if (n < 0 and errno == EINTR) return true;
+    if (n <= 0) return false;
+    received.append(chunk, n);
+    return true;
+  }
+  /// get the next line (without the '\n')
+  bool readLine(string &line) {
+    size_t end;
+    while ((end = received.find('\n')) == string::npos) {
+      if (received.size() > MAX_HEADER or not receive()) return false;
+    }
+    line = received.substr(0, end);
+    received.erase(0, end + 1);
+    return line.size() <= MAX_HEADER;
+  }
+  /// get the next n bytes
+  bool read(size_t n, string &data) {
+    while (received.size() < n) {
+      if (not receive()) return false;
+    }
+    data = received.substr(0, n);
+    received.erase(0, n);
+    return true;
+  }
+  /// send an answer: a line with the status and the size of the
+  /// body, and the body
+  bool answer(const string &status, const string &body) {
+    string message = status + " " + to_string(body.size()) + "\n" + body;
+    size_t sent = 0;
+    while (sent < message.size()) {
+      ssize_t n = send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+      if (n < 0 and errno == EINTR) continue;
+      if (n <= 0) return false;
+      sent += n;
+    }
+    return true;
+  }
+};
+
+/// constructor
+compileServer::compileServer(const string &socketPath, const compiler &compile) :
+  path(socketPath), compile(compile), listening(-1), stopping(false),
+  numRequests(0), numFailed(0) {
+  wakePipe[0] = wakePipe[1] = -1;
+}
+/// destructor
+compileServer::~compileServer() {
+  if (listening >= 0) {
+    close(listening);
+    unlink(path.c_str());
+  }
+  if (wakePipe[0] >= 0) {
+    close(wakePipe[0]);
+    close(wakePipe[1]);
+  }
+}
+
+/// listen in the socket, and serve the connections with a dispatcher
+/// thread and every worker of the pool until the server is stopping
+bool compileServer::serve(threadPool &pool, string &error) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    error = path + ": Socket path too long";
+    return false;
+  }
+  memcpy(address.sun_path, path.c_str(), path.size());
+
+  // a socket left by a previous server is replaced (but not other files)
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0 and S_ISSOCK(st.st_mode))
+    unlink(path.c_str());
+  listening = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listening < 0 or
+      bind(listening, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0 or
+      listen(listening, SOMAXCONN) != 0 or
+      pipe(wakePipe) != 0) {
+    error = path + ": " + strerror(errno);
+    if (listening >= 0) close(listening);
+    listening = -1;
+    wakePipe[0] = wakePipe[1] = -1;
+    return false;
+  }
+  // non-blocking, so the dispatcher accepts all the pending connections
+  // at once, and is never blocked by a full pipe
+  fcntl(listening, F_SETFL, fcntl(listening, F_GETFL) | O_NONBLOCK);
+  fcntl(wakePipe[0], F_SETFL, fcntl(wakePipe[0], F_GETFL) | O_NONBLOCK);
+  fcntl(wakePipe[1], F_SETFL, fcntl(wakePipe[1], F_GETFL) | O_NONBLOCK);
+
+  started = chrono::steady_clock::now();
+  thread dispatcher(&compileServer::dispatch, this);
+  try {
+    pool.run(pool.size(), [this](size_t) { work(); });
+  }
+  catch (...) {
+    stop();
+    dispatcher.join();
+    throw;
+  }
+  dispatcher.join();
+  return true;
+}
+
+/// watch the listening socket, the pipe where the workers hand back the
+/// connections, and the idle connections; the ones that have something
+/// to read (or data already received) are queued for the workers
+void compileServer::dispatch() {
+  vector<unique_ptr<connection>> idle;
+  vector<struct pollfd> watched;
+  while (not stopping) {
+    watched.clear();
+    for (int fd : {listening, wakePipe[0]}) watched.push_back({fd, POLLIN, 0});
+    for (auto &c : idle) watched.push_back({c->fd, POLLIN, 0});
+    if (poll(watched.data(), watched.size(), POLL_MS) <= 0) continue;
+
+    vector<unique_ptr<connection>> requests;
+    for (size_t i = idle.size(); i-- > 0; ) {
+      if (watched[i+2].revents == 0) continue;
+      requests.push_back(move(idle[i]));
+      idle.erase(idle.begin() + i);
+    }
+    if (watched[1].revents != 0) {
+      char drain[256];
+      while (::read(wakePipe[0], drain, sizeof(drain)) > 0) continue;
+      lock_guard<mutex> l(queueLock);
+      for (auto &c : served)
+        (c->received.empty() ? idle : requests).push_back(move(c));
+      served.clear();
+    }
+    if (watched[0].revents != 0) {
+      int fd;
+      while ((fd = accept(listening, nullptr, nullptr)) >= 0)
+        idle.emplace_back(new connection(fd, stopping));
+    }
+    if (requests.empty()) continue;
+    {
+      lock_guard<mutex> l(queueLock);
+      for (auto &c : requests) ready.push_back(move(c));
+    }
+    requestReady.notify_all();
+  }
+}
+
+/// loop of a worker: serve a request of each connection taken, and
+/// hand it back to the dispatcher (unless it must be closed)
+void compileServer::work() {
+  while (true) {
+    unique_ptr<connection> client;
+    {
+      unique_lock<mutex> l(queueLock);
+      requestReady.wait(l, [this] { return stopping or not ready.empty(); });
+      if (stopping) return;
+      client = move(ready.front());
+      ready.pop_front();
+    }
+    if (not serveRequest(*client)) continue;
+    {
+      lock_guard<mutex> l(queueLock);
+      served.push_back(move(client));
+    }
+    wakeUp(wakePipe[1]);
+  }
+}
+
+/// answer the next request of a client
+bool compileServer::serveRequest(connection &client) {
+  client.deadline = chrono::steady_clock::now() + chrono::milliseconds(REQUEST_TIMEOUT_MS);
+  string request;
+  if (not client.readLine(request)) return false;
+  istringstream words(request);
+  string command;
+  size_t size = 0;
+  words >> command;
+  if (command == "compile" and words >> size and (words >> ws).eof() and
+      size <= MAX_SOURCE) {
+    string source;
+    if (not client.read(size, source)) return false;
+    auto start = chrono::steady_clock::now();
+    ostringstream out;
+    bool ok;
+    try {
+      ok = compile(source, out);
+    }
+    catch (exception &e) {
+      out << e.what() << endl;
+      ok = false;
+    }
+    bool sent = client.answer(ok ? "ok" : "error", out.str());
+    chrono::duration<double> secs = chrono::steady_clock::now() - start;
+    record(secs.count(), ok);
+    return sent;
+  }
+  if (command == "stats" and (words >> ws).eof())
+    return client.answer("ok", statistics());
+  if (command == "shutdown" and (words >> ws).eof()) {
+    client.answer("ok", "");
+    stop();
+    return false;
+  }
+  client.answer("error", "Unknown request: " + request + "\n");
+  return false;
+}
+
+/// make the dispatcher and the workers leave (the connections still
+/// open are closed with the server)
+void compileServer::stop() {
+  {
+    lock_guard<mutex> l(queueLock);
+    stopping = true;
+  }
+  requestReady.notify_all();
+  wakeUp(wakePipe[1]);
+}
+
+/// count a compilation and keep its latency (replacing the oldest one)
+void compileServer::record(double seconds, bool ok) {
+  lock_guard<mutex> l(lock);
+  if (latencies.size() < MAX_LATENCIES) latencies.push_back(seconds);
+  else latencies[numRequests % MAX_LATENCIES] = seconds;
+  ++numRequests;
+  if (not ok) ++numFailed;
+}
+
+/// statistics, one per line: number of compilations (and failed ones),
+/// time since the server started, throughput, and the percentiles of
+/// the latency of the last compilations
+string compileServer::statistics() {
+  vector<double> sorted;
+  size_t requests, failed;
+  {
+    lock_guard<mutex> l(lock);
+    sorted = latencies;
+    requests = numRequests;
+    failed = numFailed;
+  }
+  sort(sorted.begin(), sorted.end());
+  chrono::duration<double> uptime = chrono::steady_clock::now() - started;
+  auto percentile = [&sorted](double p) {
+    if (sorted.empty()) return 0.0;
+    return 1000*sorted[min(sorted.size() - 1, size_t(p*sorted.size()))];
+  };
+
+  ostringstream text;
+  text << "requests " << requests << endl;
+  text << "failed " << failed << endl;
+  text << "uptime " << uptime.count() << " s" << endl;
+  text << "requests/s " << requests / uptime.count() << endl;
+  text << "latency p50 " << percentile(0.50) << " ms" << endl;
+  text << "latency p90 " << percentile(0.90) << " ms" << endl;
+  text << "latency p99 " << percentile(0.99) << " ms" << endl;
+  text << "latency max " << percentile(1.00) << " ms" << endl;
+  return text.str();
+}
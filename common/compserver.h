@@ -0,0 +1,123 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "threadpool.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////
+/// Class compileServer serves compilations requested through a Unix
+/// domain socket, so a resident process (with its parser caches warm)
+/// does the work of many short runs of the compiler. A dispatcher
+/// thread accepts the connections and watches the idle ones, and each
+/// request that arrives is served by a worker of a threadPool, that
+/// then hands its connection back to the dispatcher: idle clients do
+/// not keep any worker busy. A client can send any number of requests,
+/// one after the other:
+///
+///   compile <n>\n<source>  ->  ok <m>\n<output>  (or error <m>\n<output>)
+///   stats\n                ->  ok <m>\n<statistics>
+///   shutdown\n             ->  ok 0\n  (and the server stops)
+///
+/// where <n> and <m> are the sizes in bytes of what follows, and the
+/// output is the code or the errors of the compilation. A malformed
+/// request is answered with an error and the connection is closed, as
+/// it is if the rest of a request does not arrive in time.
+
+class compileServer {
+ public:
+  /// function that compiles a source, writing its output (code or
+  /// errors) to a stream, and returns whether it succeeded. It is
+  /// called from several threads at once.
+  typedef std::function<bool(const std::string &source, std::ostream &out)> compiler;
+
+  /// constructor and destructor (the socket file is removed)
+  compileServer(const std::string &socketPath, const compiler &compile);
+  ~compileServer();
+
+  /// serve requests in all the workers of the pool (and a dispatcher
+  /// thread) until a shutdown request is received (returns false, with
+  /// the reason in 'error', if the socket could not be created)
+  bool serve(threadPool &pool, std::string &error);
+
+ private:
+  std::string path;
+  compiler compile;
+  int listening;
+  std::atomic<bool> stopping;
+
+  /// a client, with the data received and not used yet
+  struct connection;
+  /// connections with a request to serve, for the workers, and those
+  /// served, to be watched again by the dispatcher (protected by
+  /// 'queueLock'); the dispatcher is woken through 'wakePipe'
+  std::mutex queueLock;
+  std::condition_variable requestReady;
+  std::deque<std::unique_ptr<connection>> ready;
+  std::vector<std::unique_ptr<connection>> served;
+  int wakePipe[2];
+
+  /// statistics (protected by 'lock'): number of compilations, of the
+  /// failed ones, and the latencies (in seconds) of the last ones
+  std::mutex lock;
+  size_t numRequests, numFailed;
+  std::vector<double> latencies;
+  std::chrono::steady_clock::time_point started;
+
+  /// accept the connections, and queue for the workers those with a
+  /// request, until the server is stopping
+  void dispatch();
+  /// take the connections with a request and serve one of each,
+  /// until the server is stopping
+  void work();
+  /// serve the next request of a client (false if the connection
+  /// must be closed)
+  bool serveRequest(connection &client);
+  /// stop the dispatcher and the workers
+  void stop();
+  /// record the latency of a compilation
+  void record(double seconds, bool ok);
+  /// text of the answer to a stats request
+  std::string statistics();
+
+  /// no copies (the socket is owned)
+  compileServer(const compileServer &) = delete;
+  compileServer & operator=(const compileServer &) = delete;
+};
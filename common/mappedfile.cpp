@@ -0,0 +1,81 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "mappedfile.h"
+
+#include <fcntl.h>      // open
+#include <unistd.h>     // close
+#include <sys/mman.h>   // mmap, munmap
+#include <sys/stat.h>   // fstat
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'mappedFile'
+
+/// constructor
+mappedFile::mappedFile() : contents(""), length(0), mapped(false) {}
+/// destructor
+mappedFile::~mappedFile() { close(); }
+
+/// map a file
+bool mappedFile::open(const string &filename) {
+  close();
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  bool ok = open(fd);
+  ::close(fd);
+  return ok;
+}
+
+/// map an open file
+bool mappedFile::open(int fd) {
+  close();
+  struct stat st;
+  if (fstat(fd, &st) != 0 or not S_ISREG(st.st_mode)) return false;
+  if (st.st_size > 0) {
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) return false;
+    contents = static_cast<const char *>(p);
+    length = st.st_size;
+    mapped = true;
+  }
+  return true;
+}
+
+/// unmap the file
+void mappedFile::close() {
+  if (mapped) munmap(const_cast<char *>(contents), length);
+  contents = "";
+  length = 0;
+  mapped = false;
+}
+
+/// contents of the file
+const char * mappedFile::data() const { return contents; }
+size_t mappedFile::size() const { return length; }
@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////
+/// Class mappedFile maps a whole file in memory (read only), so that
+/// its contents can be used in place without copying them
+
+class mappedFile {
+ public:
+  /// constructor and destructor (the file is unmapped)
+  mappedFile();
+  ~mappedFile();
+
+  /// map a file (returns false if it can not be opened or mapped)
+  bool open(const std::string &filename);
+  /// map an open file, that is left open (returns false if it is not
+  /// a regular file, e.g. a pipe, or it can not be mapped)
+  bool open(int fd);
+  /// unmap the current file (if any)
+  void close();
+
+  /// contents of the mapped file
+  const char * data() const;
+  size_t size() const;
+
+ private:
+  const char *contents;
+  size_t length;
+  /// whether contents is an actual mapping (empty files are not mapped)
+  bool mapped;
+
+  /// no copies (the mapping is owned)
+  mappedFile(const mappedFile &) = delete;
+  mappedFile & operator=(const mappedFile &) = delete;
+};
@@ -0,0 +1,269 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "objcode.h"
+#include "code.h"
+
+#include <fstream>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+
+using namespace std;
+
+
+////////////////////////////////////////////////////////////////////
+/// Writing of object files
+
+/// Auxiliary class to build the string table and characters area
+class objStringPool {
+ public:
+  vector<objString> strings;
+  string chars;
+
+  objStringPool() { add(""); }
+
+  uint32_t add(const string &s) {
+    auto it = index.find(s);
+    if (it != index.end()) return it->second;
+    objString str = { uint32_t(chars.size()), uint32_t(s.size()) };
+    chars += s;
+    chars += '\0';
+    strings.push_back(str);
+    index.insert(make_pair(s, uint32_t(strings.size()-1)));
+    return strings.size()-1;
+  }
+
+ private:
+  unordered_map<string, uint32_t> index;
+};
+
+/// write a section of records
+template <class T>
+static void write_records(ostream &f, const vector<T> &v) {
+  f.write(reinterpret_cast<const char *>(v.data()), v.size()*sizeof(T));
+}
+
+bool write_objcode(const code &c, const string &filename) {
+  ofstream f(filename, ios::out | ios::binary | ios::trunc);
+  if (not f) return false;
+  if (not write_objcode(c, f)) return false;
+  f.close();
+  return bool(f);
+}
+
+bool write_objcode(const code &c, ostream &f) {
+  objStringPool pool;
+  vector<objSubroutine> subroutines;
+  vector<objVar> vars;
+  vector<objInstruction> instructions;
+
+  map<string, uint32_t> subPosition;
+  for (size_t i = 0; i < c.get_num_subroutines(); ++i)
+    subPosition.insert(make_pair(c.get_subroutine_at(i).get_name(), uint32_t(i)));
+
+  for (size_t i = 0; i < c.get_num_subroutines(); ++i) {
+    const subroutine &sub = c.get_subroutine_at(i);
+    objSubroutine osub;
+    osub.name = pool.add(sub.get_name());
+
+    osub.firstParam = vars.size();
+    for (auto &p : sub.params) vars.push_back({ pool.add(p.name), uint32_t(p.size) });
+    osub.numParams = vars.size() - osub.firstParam;
+    osub.firstVar = vars.size();
+    for (auto &v : sub.vars) vars.push_back({ pool.add(v.name), uint32_t(v.size) });
+    osub.numVars = vars.size() - osub.firstVar;
+
+    osub.firstInstruction = instructions.size();
+    const atomTable &atoms = sub.get_atoms();
+    for (size_t pc = 0; pc < sub.get_num_instructions(); ++pc) {
+      const instruction &inst = sub.get_instruction_at(pc);
+      const string &arg1 = atoms.text(inst.arg1);
+      objInstruction oinst = { uint32_t(inst.oper), pool.add(arg1), pool.add(atoms.text(inst.arg2)),
+                               pool.add(atoms.text(inst.arg3)), OBJCODE_NO_TARGET };
+      if (inst.oper == instruction::_UJUMP or inst.oper == instruction::_FJUMP)
+        oinst.target = inst.target;
+      else if (inst.oper == instruction::_CALL and subPosition.count(arg1))
+        oinst.target = subPosition[arg1];
+      instructions.push_back(oinst);
+    }
+    osub.numInstructions = instructions.size() - osub.firstInstruction;
+    osub.hasLabels = sub.has_labels();
+    subroutines.push_back(osub);
+  }
+
+  // pad the characters area, so that the file size keeps the alignment
+  while (pool.chars.size() % sizeof(uint32_t) != 0) pool.chars += '\0';
+
+  objHeader header;
+  header.magic = OBJCODE_MAGIC;
+  header.version = OBJCODE_VERSION;
+  header.numStrings = pool.strings.size();
+  header.numSubroutines = subroutines.size();
+  header.numVars = vars.size();
+  header.numInstructions = instructions.size();
+  header.charsSize = pool.chars.size();
+  header.stringsOffset = sizeof(objHeader);
+  header.subroutinesOffset = header.stringsOffset + header.numStrings*sizeof(objString);
+  header.varsOffset = header.subroutinesOffset + header.numSubroutines*sizeof(objSubroutine);
+  header.instructionsOffset = header.varsOffset + header.numVars*sizeof(objVar);
+  header.charsOffset = header.instructionsOffset + header.numInstructions*sizeof(objInstruction);
+
+  f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  write_records(f, pool.strings);
+  write_records(f, subroutines);
+  write_records(f, vars);
+  write_records(f, instructions);
+  f.write(pool.chars.data(), pool.chars.size());
+  return bool(f);
+}
+
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'objcode'
+
+/// constructor
+objcode::objcode() : header(nullptr), strings(nullptr),
+                     subroutines(nullptr), vars(nullptr), instructions(nullptr), chars(nullptr) {}
+/// destructor
+objcode::~objcode() { unload(); }
+
+/// check that a section of n records of type T fits in the file
+template <class T>
+static bool section_fits(size_t fileSize, uint32_t offset, uint32_t n) {
+  return offset % sizeof(uint32_t) == 0 and
+         uint64_t(offset) + uint64_t(n)*sizeof(T) <= fileSize;
+}
+
+/// map an object file and check that it is consistent (once checked,
+/// the records can be used without any further test)
+bool objcode::load(const string &filename) {
+  unload();
+  if (not file.open(filename) or not check(file.data(), file.size())) { unload(); return false; }
+  return true;
+}
+
+/// use an object file already in memory, once checked
+bool objcode::load(const char *data, size_t size) {
+  unload();
+  if (reinterpret_cast<uintptr_t>(data) % alignof(objHeader) != 0 or
+      not check(data, size)) { unload(); return false; }
+  return true;
+}
+
+/// check the records of an object file, and set the shortcuts
+bool objcode::check(const char *data, size_t size) {
+  if (size < sizeof(objHeader)) return false;
+  header = reinterpret_cast<const objHeader *>(data);
+  const objHeader &h = *header;
+  bool ok = h.magic == OBJCODE_MAGIC and h.version == OBJCODE_VERSION and
+            h.numStrings > 0 and
+            section_fits<objString>(size, h.stringsOffset, h.numStrings) and
+            section_fits<objSubroutine>(size, h.subroutinesOffset, h.numSubroutines) and
+            section_fits<objVar>(size, h.varsOffset, h.numVars) and
+            section_fits<objInstruction>(size, h.instructionsOffset, h.numInstructions) and
+            section_fits<char>(size, h.charsOffset, h.charsSize);
+  if (not ok) return false;
+
+  strings = reinterpret_cast<const objString *>(data + h.stringsOffset);
+  subroutines = reinterpret_cast<const objSubroutine *>(data + h.subroutinesOffset);
+  vars = reinterpret_cast<const objVar *>(data + h.varsOffset);
+  instructions = reinterpret_cast<const objInstruction *>(data + h.instructionsOffset);
+  chars = data + h.charsOffset;
+
+  for (size_t i = 0; ok and i < h.numStrings; ++i)
+    ok = uint64_t(strings[i].offset) + strings[i].length < h.charsSize and
+         chars[strings[i].offset + strings[i].length] == '\0';
+  for (size_t i = 0; ok and i < h.numVars; ++i)
+    ok = vars[i].name < h.numStrings;
+  for (size_t i = 0; ok and i < h.numSubroutines; ++i) {
+    const objSubroutine &s = subroutines[i];
+    ok = s.name < h.numStrings and
+         uint64_t(s.firstParam) + s.numParams <= h.numVars and
+         uint64_t(s.firstVar) + s.numVars <= h.numVars and
+         uint64_t(s.firstInstruction) + s.numInstructions <= h.numInstructions;
+    for (size_t pc = 0; ok and pc < s.numInstructions; ++pc) {
+      const objInstruction &inst = instructions[s.firstInstruction + pc];
+      ok = inst.oper < instruction::_INVALID and inst.arg1 < h.numStrings and
+           inst.arg2 < h.numStrings and inst.arg3 < h.numStrings;
+      if (ok and inst.target != OBJCODE_NO_TARGET) {
+        if (inst.oper == instruction::_UJUMP or inst.oper == instruction::_FJUMP)
+          ok = inst.target < s.numInstructions;
+        else
+          ok = inst.oper == instruction::_CALL and inst.target < h.numSubroutines;
+      }
+    }
+  }
+  return ok;
+}
+
+/// unmap the file
+void objcode::unload() {
+  file.close();
+  header = nullptr; strings = nullptr;
+  subroutines = nullptr; vars = nullptr; instructions = nullptr; chars = nullptr;
+}
+
+/// access to the records
+size_t objcode::get_num_subroutines() const { return header ? header->numSubroutines : 0; }
+const objSubroutine & objcode::get_subroutine_at(size_t i) const { return subroutines[i]; }
+const objVar & objcode::get_var_at(size_t i) const { return vars[i]; }
+const objInstruction & objcode::get_instruction_at(size_t i) const { return instructions[i]; }
+const char * objcode::get_string(uint32_t s) const { return chars + strings[s].offset; }
+/// get the atom of a string
+atomTable::atom objcode::get_atom(atomTable &atoms, uint32_t s) const {
+  return atoms.intern(chars + strings[s].offset, strings[s].length);
+}
+
+/// find a subroutine by name
+size_t objcode::find_subroutine(const string &name) const {
+  for (size_t i = 0; i < get_num_subroutines(); ++i)
+    if (name == get_string(subroutines[i].name)) return i;
+  return get_num_subroutines();
+}
+
+/// add the subroutines stored in the file to c
+void objcode::get_code(code &c) const {
+  atomTable &atoms = c.get_atoms();
+  for (size_t i = 0; i < get_num_subroutines(); ++i) {
+    const objSubroutine &s = subroutines[i];
+    subroutine sub(get_string(s.name), atoms);
+    for (size_t p = s.firstParam; p < s.firstParam + s.numParams; ++p)
+      sub.add_param(get_string(vars[p].name));
+    for (size_t v = s.firstVar; v < s.firstVar + s.numVars; ++v)
+      sub.add_var(get_string(vars[v].name), vars[v].size);
+    for (size_t pc = s.firstInstruction; pc < s.firstInstruction + s.numInstructions; ++pc) {
+      const objInstruction &inst = instructions[pc];
+      sub.add_instruction(instruction(instruction::Operation(inst.oper), get_atom(atoms, inst.arg1),
+                                      get_atom(atoms, inst.arg2), get_atom(atoms, inst.arg3)));
+    }
+    sub.finalize();
+    c.add_subroutine(sub);
+  }
+}
@@ -0,0 +1,156 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+#include "code.h"
+#include "mappedfile.h"
+
+////////////////////////////////////////////////////////////////////
+/// Binary (object) format for t-code. All fields are 32-bit
+/// unsigned integers in native byte order, and all the records have
+/// a fixed width, so that a mapped file can be used in place:
+///
+///   header
+///   string table   (numStrings x objString)
+///   subroutines    (numSubroutines x objSubroutine)
+///   variables      (numVars x objVar; params and vars of all subroutines)
+///   instructions   (numInstructions x objInstruction)
+///   characters     (charsSize bytes; texts of the strings, each ending in '\0')
+///
+/// Strings (names and operands) are referred by their position in
+/// the string table, where string 0 is always the empty one. Jumps
+/// have their target already resolved to a program counter in the
+/// subroutine, and calls to the position of the called subroutine.
+/// The format depends on the order of instruction::Operation, so
+/// OBJCODE_VERSION must be increased whenever it changes.
+
+#define OBJCODE_MAGIC   0x424f4354   // "TCOB"
+#define OBJCODE_VERSION 1
+
+struct objHeader {
+  uint32_t magic, version;
+  uint32_t numStrings, numSubroutines, numVars, numInstructions, charsSize;
+  uint32_t stringsOffset, subroutinesOffset, varsOffset, instructionsOffset, charsOffset;
+};
+
+struct objString {
+  uint32_t offset, length;     // position in the characters area
+};
+
+struct objSubroutine {
+  uint32_t name;
+  uint32_t firstParam, numParams;
+  uint32_t firstVar, numVars;
+  uint32_t firstInstruction, numInstructions;
+  uint32_t hasLabels;
+};
+
+struct objVar {
+  uint32_t name, size;
+};
+
+struct objInstruction {
+  uint32_t oper;
+  uint32_t arg1, arg2, arg3;
+  uint32_t target;             // pc of a jump, subroutine of a call
+};
+
+/// target of the instructions that are neither jumps nor calls (and
+/// of jumps to undefined labels, or calls to undefined subroutines)
+#define OBJCODE_NO_TARGET 0xffffffff
+
+
+////////////////////////////////////////////////////////////////////
+/// write code in binary format into a file, or a stream (returns
+/// false if it could not be written)
+
+bool write_objcode(const code &c, const std::string &filename);
+bool write_objcode(const code &c, std::ostream &os);
+
+
+////////////////////////////////////////////////////////////////////
+/// Class objcode maps an object file in memory (or takes one that is
+/// already there) and gives direct access to its records, without any
+/// parsing
+
+class objcode {
+ public:
+  /// constructor and destructor (the file is unmapped)
+  objcode();
+  ~objcode();
+
+  /// map an object file (returns false if it can not be mapped or
+  /// it is not a valid object file of the current version)
+  bool load(const std::string &filename);
+  /// use the object file in the 'size' bytes of 'data', that must be
+  /// aligned to 4 bytes and outlive its use (returns false if it is not
+  /// a valid object file of the current version)
+  bool load(const char *data, size_t size);
+  /// unmap the current file (if any)
+  void unload();
+
+  /// access to the records of the mapped file
+  size_t get_num_subroutines() const;
+  const objSubroutine & get_subroutine_at(size_t i) const;
+  const objVar & get_var_at(size_t i) const;
+  const objInstruction & get_instruction_at(size_t i) const;
+  /// get the text of a string (null terminated, it lives in the mapped file)
+  const char * get_string(uint32_t s) const;
+  /// get the atom of a string in the table 'atoms' (added if it is new)
+  atomTable::atom get_atom(atomTable &atoms, uint32_t s) const;
+  /// find a subroutine by name (returns get_num_subroutines() if not found)
+  size_t find_subroutine(const std::string &name) const;
+
+  /// add the subroutines stored in the file to c (their operands are
+  /// added to the atom table of c)
+  void get_code(code &c) const;
+
+ private:
+  /// mapped file
+  mappedFile file;
+  /// check the records of the object file in data, and set the
+  /// shortcuts to its sections (returns false if it is not valid)
+  bool check(const char *data, size_t size);
+  /// shortcuts to the sections of the file
+  const objHeader *header;
+  const objString *strings;
+  const objSubroutine *subroutines;
+  const objVar *vars;
+  const objInstruction *instructions;
+  const char *chars;
+
+  /// no copies (the mapping is owned)
+  objcode(const objcode &) = delete;
+  objcode & operator=(const objcode &) = delete;
+};
@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "sourcetext.h"
+
+#include <cerrno>
+#include <fcntl.h>      // open
+#include <unistd.h>     // read, close
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'sourceText'
+
+/// constructor
+sourceText::sourceText() : contents(""), length(0) {}
+
+/// get the contents of an open file: mapped, or read in blocks
+bool sourceText::load(int fd) {
+  if (mapped.open(fd)) {
+    contents = mapped.data();
+    length = mapped.size();
+    return true;
+  }
+  buffer.clear();
+  char block[64*1024];
+  ssize_t n;
+  while ((n = ::read(fd, block, sizeof(block))) != 0) {
+    if (n > 0) buffer.append(block, n);
+    else if (errno != EINTR) return false;
+  }
+  contents = buffer.data();
+  length = buffer.size();
+  return true;
+}
+
+/// get the contents of a file
+bool sourceText::load(const string &filename) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  bool ok = load(fd);
+  ::close(fd);
+  return ok;
+}
+
+/// contents of the source
+const char * sourceText::data() const { return contents; }
+size_t sourceText::size() const { return length; }
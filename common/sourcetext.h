@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "mappedfile.h"
+
+#include <string>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////
+/// Class sourceText holds the contents of a source file: mapped in
+/// memory if it is a regular file (see mappedFile), or else (a pipe,
+/// a terminal...) read all at once into a buffer
+
+class sourceText {
+ public:
+  /// constructor (empty contents)
+  sourceText();
+
+  /// get the contents of the open file fd, that is left open
+  /// (returns false if it can not be read)
+  bool load(int fd);
+  /// get the contents of a file (returns false if it can not be read)
+  bool load(const std::string &filename);
+
+  /// contents of the source
+  const char * data() const;
+  size_t size() const;
+
+ private:
+  mappedFile mapped;
+  std::string buffer;
+  const char *contents;
+  size_t length;
+
+  /// no copies (contents may point to buffer)
+  sourceText(const sourceText &) = delete;
+  sourceText & operator=(const sourceText &) = delete;
+};
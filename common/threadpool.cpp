@@ -0,0 +1,133 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#include "threadpool.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+/// Implementation for class 'threadPool'
+
+/// constructor
+threadPool::threadPool(size_t numThreads) :
+  job(nullptr), pending(0), active(0), generation(0), stopping(false) {
+  if (numThreads == 0) numThreads = thread::hardware_concurrency();
+  if (numThreads == 0) numThreads = 1;
+  for (size_t i = 0; i < numThreads; ++i) queues.emplace_back(new taskQueue());
+  for (size_t i = 0; i < numThreads; ++i) workers.emplace_back(&threadPool::work, this, i);
+}
+/// destructor
+threadPool::~threadPool() {
+  {
+    lock_guard<mutex> l(lock);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &w : workers) w.join();
+}
+
+/// number of workers
+size_t threadPool::size() const { return workers.size(); }
+
+/// run all the tasks, and wait for them
+void threadPool::run(size_t numTasks, const function<void(size_t)> &task) {
+  if (numTasks == 0) return;
+  unique_lock<mutex> l(lock);
+  // no worker may still be looking at the queues of a previous run
+  done.wait(l, [this] { return active == 0; });
+  size_t n = queues.size();
+  for (size_t w = 0; w < n; ++w) {
+    lock_guard<mutex> ql(queues[w]->lock);
+    for (size_t i = w*numTasks/n; i < (w+1)*numTasks/n; ++i)
+      queues[w]->tasks.push_back(i);
+  }
+  job = &task;
+  pending = numTasks;
+  ++generation;
+  wake.notify_all();
+  done.wait(l, [this] { return pending == 0 and active == 0; });
+  job = nullptr;
+  exception_ptr e = failure;
+  failure = nullptr;
+  l.unlock();
+  if (e) rethrow_exception(e);
+}
+
+/// loop of a worker: wait for a run, and take tasks until there are none
+void threadPool::work(size_t self) {
+  size_t seen = 0;
+  while (true) {
+    const function<void(size_t)> *task;
+    {
+      unique_lock<mutex> l(lock);
+      wake.wait(l, [this, seen] { return stopping or generation != seen; });
+      if (stopping) return;
+      seen = generation;
+      task = job;
+      ++active;
+    }
+    size_t t;
+    while (task != nullptr and take(self, t)) {
+      exception_ptr e;
+      try {
+        (*task)(t);
+      }
+      catch (...) {
+        e = current_exception();
+      }
+      lock_guard<mutex> l(lock);
+      if (e and not failure) failure = e;
+      --pending;
+    }
+    {
+      lock_guard<mutex> l(lock);
+      --active;
+    }
+    done.notify_all();
+  }
+}
+
+/// take the first task of the own queue, or the last one of another
+bool threadPool::take(size_t self, size_t &task) {
+  size_t n = queues.size();
+  for (size_t k = 0; k < n; ++k) {
+    taskQueue &q = *queues[(self + k) % n];
+    lock_guard<mutex> l(q.lock);
+    if (q.tasks.empty()) continue;
+    if (k == 0) {
+      task = q.tasks.front();
+      q.tasks.pop_front();
+    }
+    else {
+      task = q.tasks.back();
+      q.tasks.pop_back();
+    }
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////
+//
+//    TVM - t-Code Virtual Machine
+//
+//    Copyright (C) 2017  Universitat Politecnica de Catalunya
+//
+//    This library is free software; you can redistribute it and/or
+//    modify it under the terms of the GNU General Public License
+//    as published by the Free Software Foundation; either version 3
+//    of the License, or (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//    Affero General Public License for more details.
+//
+//    You should have received a copy of the GNU Affero General Public
+//    License along with this library; if not, write to the Free Software
+//    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//    contact: Lluis Padro (padro@cs.upc.edu)
+//             Computer Science Department
+//             Universitat Politecnica de Catalunya
+//             despatx Omega.320 - Campus Nord UPC
+//             08034 Barcelona.  SPAIN
+//
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////
+/// Class threadPool keeps a set of worker threads to run a number of
+/// independent tasks (identified by their index). Each worker has its
+/// own queue, filled with a range of consecutive tasks, and when it is
+/// empty the worker steals tasks from the end of the other queues, so
+/// tasks of very different cost are still balanced among the workers.
+
+class threadPool {
+ public:
+  /// constructor (starts numThreads workers, one per core if 0) and
+  /// destructor (waits for the workers to finish)
+  threadPool(size_t numThreads = 0);
+  ~threadPool();
+
+  /// number of worker threads
+  size_t size() const;
+  /// run task(i) for every i in [0, numTasks) in the workers, and
+  /// wait until all of them have finished. If any task throws, the
+  /// rest are still run, and then the first exception caught is
+  /// thrown again here, in the thread that called run
+  void run(size_t numTasks, const std::function<void(size_t)> &task);
+
+ private:
+  /// queue of the tasks of a worker
+  struct taskQueue {
+    std::mutex lock;
+    std::deque<size_t> tasks;
+  };
+
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<taskQueue>> queues;
+
+  /// state shared with the workers (protected by 'lock')
+  std::mutex lock;
+  std::condition_variable wake, done;
+  const std::function<void(size_t)> *job;
+  size_t pending;     // tasks of the current run not finished yet
+  size_t active;      // workers looking for (or running) tasks
+  size_t generation;  // number of runs started
+  bool stopping;
+  std::exception_ptr failure;  // first exception of the current run
+
+  /// loop of the worker 'self'
+  void work(size_t self);
+  /// get a task from the own queue, or else steal one from another
+  bool take(size_t self, size_t &task);
+
+  /// no copies (the threads are owned)
+  threadPool(const threadPool &) = delete;
+  threadPool & operator=(const threadPool &) = delete;
+};